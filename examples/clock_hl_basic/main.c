@@ -2,6 +2,7 @@
 #include "pico/stdlib.h"
 #include "hardware/rtc.h"
 #include "display_api.h"
+#include "logging.h"
 
 // Конфигурация по умолчанию
 #define DISPLAY_DIGITS 4
@@ -37,6 +38,7 @@ int main(void) {
         // Эту функцию нужно вызывать как можно чаще. Она крутит анимации,
         // обновляет яркость и обрабатывает оверлеи.
         display_process();
+        display_log_drain(4);
 
         // 5. Обновление контента
         // Не обязательно делать это каждый цикл, достаточно раз в 100мс
@@ -5,6 +5,7 @@
 
 // Подключение библиотеки
 #include "display_api.h"
+#include "logging.h"
 #include "display_font.h" 
 #include "display_ll.h"
 
@@ -319,6 +320,7 @@ int main() {
     while (true) {
         // ЯДРО (Обязательно)
         display_process();
+        display_log_drain(4);
         
         // Логика времени
         update_clock_simulation();
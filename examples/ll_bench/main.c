@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+#include "hardware/irq.h"
+#include "display_ll.h"
+
+/*
+ * Бенчмарк таймера развертки.
+ * Три фазы по BENCH_PHASE_MS, после каждой печатается display_ll_timer_stats_t:
+ *   1. Простой.
+ *   2. Нагрузка на alarm pool по умолчанию (таймеры приложения).
+ *   3. Стирание и запись последнего сектора flash в безопасном режиме
+ *      (только в сборке с -DVFD_FLASH_SAFE=ON).
+ */
+
+#define VFD_DATA_PIN      15
+#define VFD_CLOCK_PIN     14
+#define VFD_LATCH_PIN     13
+
+#define VFD_DIGIT_COUNT   4
+#define VFD_REFRESH_HZ    120
+
+#define BENCH_PHASE_MS        3000u
+#define BENCH_IRQ_PRIORITY    0x40
+#define BENCH_EDGE_PRIORITY   PICO_HIGHEST_IRQ_PRIORITY
+#define BENCH_APP_TIMERS      8          // Таймеры "приложения" в фазе 2
+#define BENCH_APP_PERIOD_US   200
+#define BENCH_APP_WORK_US     40         // Длительность обработчика таймера приложения
+
+// Последний сектор flash: вне образа прошивки
+#define BENCH_FLASH_OFFSET    (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE)
+
+static struct repeating_timer s_app_timers[BENCH_APP_TIMERS];
+static uint8_t s_page[FLASH_PAGE_SIZE];
+
+static bool bench_app_cb(struct repeating_timer *t)
+{
+    (void)t;
+    busy_wait_us_32(BENCH_APP_WORK_US);
+    return true;
+}
+
+static void bench_report(const char *phase)
+{
+    display_ll_timer_stats_t st;
+    display_ll_stats_t ll;
+    display_ll_get_timer_stats(&st);
+    display_ll_get_stats(&ll);
+
+    printf("%-8s irq=%-7lu latency max=%lu us avg=%lu us  isr max=%lu us  missed=%lu\n",
+           phase,
+           (unsigned long)st.irq_count,
+           (unsigned long)st.latency_max_us,
+           (unsigned long)st.latency_avg_us,
+           (unsigned long)st.isr_max_us,
+           (unsigned long)ll.missed_slots);
+    printf("         pwm edge late max=%lu us avg=%lu us  dropped=%lu\n",
+           (unsigned long)ll.edge_late_max_us,
+           (unsigned long)ll.edge_late_avg_us,
+           (unsigned long)ll.edges_dropped);
+}
+
+static void bench_phase_idle(void)
+{
+    display_ll_reset_timer_stats();
+    sleep_ms(BENCH_PHASE_MS);
+    bench_report("idle");
+}
+
+static void bench_phase_app_timers(void)
+{
+    for (int i = 0; i < BENCH_APP_TIMERS; i++) {
+        add_repeating_timer_us(-BENCH_APP_PERIOD_US, bench_app_cb, NULL, &s_app_timers[i]);
+    }
+
+    display_ll_reset_timer_stats();
+    sleep_ms(BENCH_PHASE_MS);
+    bench_report("timers");
+
+    for (int i = 0; i < BENCH_APP_TIMERS; i++) cancel_repeating_timer(&s_app_timers[i]);
+}
+
+static void bench_phase_flash(void)
+{
+    // Второе ядро в этом примере не запущено; в приложении его нужно
+    // остановить через multicore_lockout_start_blocking() (см. LL_API.md)
+    if (!display_ll_flash_safe_enter()) {
+        printf("flash    skipped (build with -DVFD_FLASH_SAFE=ON)\n");
+        return;
+    }
+    display_ll_reset_timer_stats();
+
+    uint32_t t0 = time_us_32();
+    uint32_t ops = 0;
+    while (time_us_32() - t0 < BENCH_PHASE_MS * 1000u) {
+        flash_range_erase(BENCH_FLASH_OFFSET, FLASH_SECTOR_SIZE);
+        for (uint32_t off = 0; off < FLASH_SECTOR_SIZE; off += FLASH_PAGE_SIZE) {
+            memset(s_page, (int)(ops + off), sizeof(s_page));
+            flash_range_program(BENCH_FLASH_OFFSET + off, s_page, FLASH_PAGE_SIZE);
+        }
+        ops++;
+    }
+
+    display_ll_flash_safe_exit();
+    bench_report("flash");
+    printf("         %lu sector erase+program cycles\n", (unsigned long)ops);
+}
+
+int main(void)
+{
+    stdio_init_all();
+    sleep_ms(2000);
+    printf("=== VFD LL Scan Timer Benchmark ===\n");
+
+    display_ll_timer_config_t tcfg = {
+        .alarm_num         = DISPLAY_LL_ALARM_ANY,
+        .irq_priority      = BENCH_IRQ_PRIORITY,
+        .edge_alarm_num    = DISPLAY_LL_ALARM_ANY,
+        .edge_irq_priority = BENCH_EDGE_PRIORITY,
+    };
+    display_ll_set_timer_config(&tcfg);
+
+    display_ll_config_t cfg = {
+        .data_pin        = VFD_DATA_PIN,
+        .clock_pin       = VFD_CLOCK_PIN,
+        .latch_pin       = VFD_LATCH_PIN,
+        .digit_count     = VFD_DIGIT_COUNT,
+        .refresh_rate_hz = VFD_REFRESH_HZ,
+    };
+
+    if (!display_ll_init(&cfg) || !display_ll_start_refresh()) {
+        printf("ERROR: Display Init Failed!\n");
+        while (true) tight_loop_contents();
+    }
+
+    // Все сегменты, яркость ниже максимума: в каждом слоте есть гашение PWM
+    for (int i = 0; i < VFD_DIGIT_COUNT; i++) display_ll_set_digit_raw((uint8_t)i, 0xFF);
+    display_ll_set_brightness_all(128);
+
+    while (true) {
+        bench_phase_idle();
+        bench_phase_app_timers();
+        bench_phase_flash();
+        printf("\n");
+    }
+
+    return 0;
+}
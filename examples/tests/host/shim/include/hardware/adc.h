@@ -0,0 +1,12 @@
+#ifndef SHIM_HARDWARE_ADC_H
+#define SHIM_HARDWARE_ADC_H
+
+#include "pico/types.h"
+
+/* АЦП без модели: одиночное чтение возвращает середину шкалы. */
+static inline void     adc_init(void) {}
+static inline void     adc_gpio_init(uint gpio) { (void)gpio; }
+static inline void     adc_select_input(uint input) { (void)input; }
+static inline uint16_t adc_read(void) { return 0x800; }
+
+#endif // SHIM_HARDWARE_ADC_H
@@ -0,0 +1,16 @@
+#ifndef SHIM_HARDWARE_GPIO_H
+#define SHIM_HARDWARE_GPIO_H
+
+#include "pico/types.h"
+
+enum { GPIO_IN = 0, GPIO_OUT = 1 };
+enum gpio_slew_rate { GPIO_SLEW_RATE_SLOW = 0, GPIO_SLEW_RATE_FAST = 1 };
+
+/* Уровни линий пишутся в модель регистров 74HC595 (sim.c). */
+void gpio_init(uint gpio);
+void gpio_set_dir(uint gpio, bool out);
+void gpio_set_slew_rate(uint gpio, enum gpio_slew_rate slew);
+void gpio_put(uint gpio, bool value);
+void gpio_put_masked(uint32_t mask, uint32_t value);
+
+#endif // SHIM_HARDWARE_GPIO_H
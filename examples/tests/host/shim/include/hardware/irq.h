@@ -0,0 +1,11 @@
+#ifndef SHIM_HARDWARE_IRQ_H
+#define SHIM_HARDWARE_IRQ_H
+
+#include "pico/types.h"
+
+/* Приоритеты NVIC (значения как в Pico SDK). */
+#define PICO_HIGHEST_IRQ_PRIORITY  0x00
+#define PICO_DEFAULT_IRQ_PRIORITY  0x80
+#define PICO_LOWEST_IRQ_PRIORITY   0xff
+
+#endif // SHIM_HARDWARE_IRQ_H
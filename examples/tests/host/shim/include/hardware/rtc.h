@@ -0,0 +1,27 @@
+#ifndef SHIM_HARDWARE_RTC_H
+#define SHIM_HARDWARE_RTC_H
+
+#include "pico/types.h"
+
+/*
+ * RTC (модель в sim.c): после rtc_set_datetime() часы идут по виртуальному
+ * времени симулятора. Календарь не моделируется — считаются часы, минуты, секунды
+ * и день недели; дата остается заданной.
+ */
+
+typedef struct {
+    int16_t year;
+    int8_t  month;
+    int8_t  day;
+    int8_t  dotw;
+    int8_t  hour;
+    int8_t  min;
+    int8_t  sec;
+} datetime_t;
+
+void rtc_init(void);
+bool rtc_set_datetime(const datetime_t *t);
+bool rtc_get_datetime(datetime_t *t);
+bool rtc_running(void);
+
+#endif // SHIM_HARDWARE_RTC_H
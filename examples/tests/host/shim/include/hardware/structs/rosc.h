@@ -0,0 +1,14 @@
+#ifndef SHIM_HARDWARE_STRUCTS_ROSC_H
+#define SHIM_HARDWARE_STRUCTS_ROSC_H
+
+#include "pico/types.h"
+
+/* Регистры ROSC: RANDOMBIT — псевдослучайный бит (модель в sim.c). */
+typedef struct {
+    volatile uint32_t randombit;
+} rosc_hw_t;
+
+extern rosc_hw_t sim_rosc_hw;
+#define rosc_hw (&sim_rosc_hw)
+
+#endif // SHIM_HARDWARE_STRUCTS_ROSC_H
@@ -0,0 +1,11 @@
+#ifndef SHIM_HARDWARE_SYNC_H
+#define SHIM_HARDWARE_SYNC_H
+
+#include "pico/types.h"
+
+/* В симуляторе обработчики выполняются синхронно, маскировать нечего. */
+static inline uint32_t save_and_disable_interrupts(void) { return 0; }
+static inline void restore_interrupts(uint32_t status) { (void)status; }
+static inline void __dmb(void) { __sync_synchronize(); }
+
+#endif // SHIM_HARDWARE_SYNC_H
@@ -0,0 +1,24 @@
+#ifndef SHIM_HARDWARE_TIMER_H
+#define SHIM_HARDWARE_TIMER_H
+
+#include "pico/time.h"
+
+/*
+ * Аппаратные будильники 0..3 (модель в sim.c).
+ * Захват и обработчики переживают sim_reset(), как и в прошивке, где их
+ * держит драйвер; сбрасываются только взведенные цели.
+ */
+
+typedef void (*hardware_alarm_callback_t)(uint alarm_num);
+
+void hardware_alarm_claim(uint alarm_num);
+int  hardware_alarm_claim_unused(bool required);
+void hardware_alarm_unclaim(uint alarm_num);
+bool hardware_alarm_is_claimed(uint alarm_num);
+void hardware_alarm_set_callback(uint alarm_num, hardware_alarm_callback_t callback);
+
+/* Возвращает true, если время t уже наступило (будильник не взведен). */
+bool hardware_alarm_set_target(uint alarm_num, absolute_time_t t);
+void hardware_alarm_cancel(uint alarm_num);
+
+#endif // SHIM_HARDWARE_TIMER_H
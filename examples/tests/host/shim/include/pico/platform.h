@@ -0,0 +1,18 @@
+#ifndef SHIM_PICO_PLATFORM_H
+#define SHIM_PICO_PLATFORM_H
+
+#include <stdint.h>
+
+/* Хостовая сборка: аппаратных регистров нет, размещение в RAM не имеет смысла. */
+
+#define PICO_NO_HARDWARE 1
+
+#define __not_in_flash_func(func_name) func_name
+
+/* Время в симуляторе идет только в sim_run_until(): задержки в тактах мгновенны. */
+void busy_wait_at_least_cycles(uint32_t minimum_cycles);
+
+/* Номер ядра задает sim_set_core(). */
+uint32_t get_core_num(void);
+
+#endif // SHIM_PICO_PLATFORM_H
@@ -0,0 +1,38 @@
+#ifndef SHIM_PICO_TIME_H
+#define SHIM_PICO_TIME_H
+
+#include "pico/types.h"
+
+/* Виртуальное время симулятора: таймеры и будильники выполняет sim_run_until(). */
+
+typedef int32_t alarm_id_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void *user_data);
+
+struct repeating_timer;
+typedef bool (*repeating_timer_callback_t)(struct repeating_timer *rt);
+
+typedef struct repeating_timer {
+    int64_t                    delay_us;
+    alarm_id_t                 alarm_id;
+    repeating_timer_callback_t callback;
+    void                      *user_data;
+} repeating_timer_t;
+
+uint64_t time_us_64(void);
+static inline uint32_t time_us_32(void) { return (uint32_t)time_us_64(); }
+static inline absolute_time_t get_absolute_time(void) { return time_us_64(); }
+static inline uint64_t to_us_since_boot(absolute_time_t t) { return t; }
+static inline uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t / 1000u); }
+static inline absolute_time_t from_us_since_boot(uint64_t us) { return us; }
+static inline int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) { return (int64_t)(to - from); }
+
+/* Ожидание сдвигает виртуальное время (с выполнением наступивших событий). */
+void sleep_us(uint64_t us);
+static inline void sleep_ms(uint32_t ms) { sleep_us((uint64_t)ms * 1000u); }
+
+bool       add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t cb, void *user_data, repeating_timer_t *out);
+bool       cancel_repeating_timer(repeating_timer_t *timer);
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t cb, void *user_data, bool fire_if_past);
+bool       cancel_alarm(alarm_id_t id);
+
+#endif // SHIM_PICO_TIME_H
@@ -0,0 +1,15 @@
+#ifndef SHIM_PICO_TYPES_H
+#define SHIM_PICO_TYPES_H
+
+/* Заглушки Pico SDK для сборки библиотеки на хосте (см. sim.h). */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "pico/platform.h"
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+#endif // SHIM_PICO_TYPES_H
@@ -0,0 +1,405 @@
+#include "sim.h"
+
+#include "pico/time.h"
+#include "hardware/gpio.h"
+#include "hardware/timer.h"
+#include "hardware/clocks.h"
+#include "hardware/rtc.h"
+#include "hardware/structs/rosc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+//  СОСТОЯНИЕ
+// ============================================================================
+
+#define SIM_MAX_EVENTS  32u
+#define SIM_MAX_WATCH   8u
+#define SIM_HW_ALARMS   4u
+
+typedef struct {
+    bool                used;
+    alarm_id_t          id;
+    uint64_t            at_us;
+    alarm_callback_t    alarm_cb;     // Будильник
+    repeating_timer_t  *timer;        // Или повторяющийся таймер
+    void               *user_data;
+} sim_event_t;
+
+typedef struct {
+    bool                      claimed;
+    bool                      armed;
+    uint64_t                  at_us;
+    hardware_alarm_callback_t cb;
+} sim_hw_alarm_t;
+
+typedef struct {
+    uint8_t      pin;
+    uint32_t     shift;
+    sim_latch_t *log;
+    uint32_t     count;
+} sim_watch_t;
+
+static uint64_t    s_now_us;
+static alarm_id_t  s_next_id = 1;
+static sim_event_t s_events[SIM_MAX_EVENTS];
+static sim_hw_alarm_t s_hw[SIM_HW_ALARMS];
+
+static uint32_t    s_sys_hz = 125000000u;
+static uint32_t    s_wait_min_ns = UINT32_MAX;
+static uint32_t    s_wait_max_ns;
+static uint32_t    s_core;
+
+static bool        s_rtc_running;
+static datetime_t  s_rtc_base;
+static uint64_t    s_rtc_base_us;
+
+static uint32_t    s_levels;
+static uint8_t     s_clock_pin = 0xFF;
+static uint8_t     s_latch_pin = 0xFF;
+static uint32_t    s_clock_edges;
+static sim_watch_t s_watch[SIM_MAX_WATCH];
+static uint8_t     s_watch_count;
+
+// ============================================================================
+//  МОДЕЛЬ 74HC595
+// ============================================================================
+
+static void sim_set_level(uint8_t pin, bool level)
+{
+    uint32_t bit = 1u << pin;
+    bool prev = (s_levels & bit) != 0;
+    if (level) s_levels |= bit;
+    else s_levels &= ~bit;
+    if (prev || !level) return;
+
+    // Передний фронт
+    if (pin == s_clock_pin) {
+        s_clock_edges++;
+        for (uint8_t i = 0; i < s_watch_count; i++) {
+            sim_watch_t *w = &s_watch[i];
+            w->shift = (w->shift << 1) | ((s_levels >> w->pin) & 1u);
+        }
+    } else if (pin == s_latch_pin) {
+        for (uint8_t i = 0; i < s_watch_count; i++) {
+            sim_watch_t *w = &s_watch[i];
+            if (w->count >= SIM_MAX_LATCHES) {
+                fprintf(stderr, "sim: latch log overflow on pin %u\n", w->pin);
+                abort();
+            }
+            w->log[w->count].t_us = s_now_us;
+            w->log[w->count].bits = w->shift;
+            w->count++;
+        }
+    }
+}
+
+void gpio_init(uint gpio) { sim_set_level((uint8_t)gpio, false); }
+void gpio_set_dir(uint gpio, bool out) { (void)gpio; (void)out; }
+void gpio_set_slew_rate(uint gpio, enum gpio_slew_rate slew) { (void)gpio; (void)slew; }
+
+void gpio_put(uint gpio, bool value) { sim_set_level((uint8_t)gpio, value); }
+
+void gpio_put_masked(uint32_t mask, uint32_t value)
+{
+    // Все линии маски меняются одновременно: фронты CLOCK/LATCH не входят в маску DATA
+    s_levels = (s_levels & ~mask) | (value & mask);
+}
+
+// ============================================================================
+//  ТАЙМЕРЫ
+// ============================================================================
+
+uint64_t time_us_64(void) { return s_now_us; }
+
+static sim_event_t *sim_event_alloc(void)
+{
+    for (uint32_t i = 0; i < SIM_MAX_EVENTS; i++) {
+        if (!s_events[i].used) {
+            memset(&s_events[i], 0, sizeof(s_events[i]));
+            s_events[i].used = true;
+            s_events[i].id = s_next_id++;
+            return &s_events[i];
+        }
+    }
+    return NULL;
+}
+
+static sim_event_t *sim_event_find(alarm_id_t id)
+{
+    for (uint32_t i = 0; i < SIM_MAX_EVENTS; i++) {
+        if (s_events[i].used && s_events[i].id == id) return &s_events[i];
+    }
+    return NULL;
+}
+
+static uint64_t sim_abs_delay(int64_t us) { return (uint64_t)(us < 0 ? -us : us); }
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t cb, void *user_data, repeating_timer_t *out)
+{
+    sim_event_t *e = sim_event_alloc();
+    if (!e || !out || delay_us == 0) return false;
+    out->delay_us  = delay_us;
+    out->callback  = cb;
+    out->user_data = user_data;
+    out->alarm_id  = e->id;
+    e->timer = out;
+    e->at_us = s_now_us + sim_abs_delay(delay_us);
+    return true;
+}
+
+bool cancel_repeating_timer(repeating_timer_t *timer)
+{
+    if (!timer) return false;
+    return cancel_alarm(timer->alarm_id);
+}
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t cb, void *user_data, bool fire_if_past)
+{
+    (void)fire_if_past;
+    sim_event_t *e = sim_event_alloc();
+    if (!e) return -1;
+    e->alarm_cb  = cb;
+    e->user_data = user_data;
+    e->at_us     = s_now_us + us;
+    return e->id;
+}
+
+bool cancel_alarm(alarm_id_t id)
+{
+    sim_event_t *e = sim_event_find(id);
+    if (!e) return false;
+    e->used = false;
+    return true;
+}
+
+void hardware_alarm_claim(uint alarm_num)
+{
+    if (alarm_num >= SIM_HW_ALARMS || s_hw[alarm_num].claimed) {
+        fprintf(stderr, "sim: hardware alarm %u already claimed\n", alarm_num);
+        abort();
+    }
+    s_hw[alarm_num].claimed = true;
+}
+
+int hardware_alarm_claim_unused(bool required)
+{
+    for (uint i = 0; i < SIM_HW_ALARMS; i++) {
+        if (!s_hw[i].claimed) {
+            s_hw[i].claimed = true;
+            return (int)i;
+        }
+    }
+    if (required) abort();
+    return -1;
+}
+
+void hardware_alarm_unclaim(uint alarm_num)
+{
+    if (alarm_num < SIM_HW_ALARMS) memset(&s_hw[alarm_num], 0, sizeof(s_hw[alarm_num]));
+}
+
+bool hardware_alarm_is_claimed(uint alarm_num)
+{
+    return alarm_num < SIM_HW_ALARMS && s_hw[alarm_num].claimed;
+}
+
+void hardware_alarm_set_callback(uint alarm_num, hardware_alarm_callback_t callback)
+{
+    if (alarm_num < SIM_HW_ALARMS) s_hw[alarm_num].cb = callback;
+}
+
+bool hardware_alarm_set_target(uint alarm_num, absolute_time_t t)
+{
+    if (alarm_num >= SIM_HW_ALARMS) return true;
+    if (t <= s_now_us) {
+        s_hw[alarm_num].armed = false;
+        return true;
+    }
+    s_hw[alarm_num].armed = true;
+    s_hw[alarm_num].at_us = t;
+    return false;
+}
+
+void hardware_alarm_cancel(uint alarm_num)
+{
+    if (alarm_num < SIM_HW_ALARMS) s_hw[alarm_num].armed = false;
+}
+
+void sim_run_until(uint64_t t_us)
+{
+    for (;;) {
+        sim_event_t *next = NULL;
+        for (uint32_t i = 0; i < SIM_MAX_EVENTS; i++) {
+            sim_event_t *e = &s_events[i];
+            if (!e->used || e->at_us > t_us) continue;
+            if (!next || e->at_us < next->at_us) next = e;
+        }
+
+        // Аппаратный будильник раньше программных событий срабатывает первым
+        sim_hw_alarm_t *hw = NULL;
+        for (uint i = 0; i < SIM_HW_ALARMS; i++) {
+            sim_hw_alarm_t *a = &s_hw[i];
+            if (!a->armed || a->at_us > t_us) continue;
+            if ((!hw || a->at_us < hw->at_us) && (!next || a->at_us <= next->at_us)) hw = a;
+        }
+        if (hw) {
+            s_now_us = hw->at_us;
+            hw->armed = false;
+            if (hw->cb) hw->cb((uint)(hw - s_hw));
+            continue;
+        }
+        if (!next) break;
+
+        s_now_us = next->at_us;
+        if (next->timer) {
+            repeating_timer_t *rt = next->timer;
+            if (rt->callback(rt) && next->used) next->at_us += sim_abs_delay(rt->delay_us);
+            else next->used = false;
+        } else {
+            int64_t r = next->alarm_cb(next->id, next->user_data);
+            if (!next->used) continue;                       // Отменен из обработчика
+            if (r < 0) next->at_us += (uint64_t)(-r);        // От предыдущего срабатывания
+            else if (r > 0) next->at_us = s_now_us + (uint64_t)r;
+            else next->used = false;
+        }
+    }
+    s_now_us = t_us;
+}
+
+void sleep_us(uint64_t us) { sim_run_until(s_now_us + us); }
+
+uint32_t sim_pending_events(void)
+{
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < SIM_MAX_EVENTS; i++) n += s_events[i].used ? 1u : 0u;
+    for (uint32_t i = 0; i < SIM_HW_ALARMS; i++) n += s_hw[i].armed ? 1u : 0u;
+    return n;
+}
+
+// ============================================================================
+//  ТАКТИРОВАНИЕ
+// ============================================================================
+
+uint32_t clock_get_hz(enum clock_index clk_index)
+{
+    if (clk_index == clk_sys) return s_sys_hz;
+    if (clk_index == clk_ref) return 12000000u;
+    return s_sys_hz;
+}
+
+bool set_sys_clock_khz(uint32_t freq_khz, bool required)
+{
+    (void)required;
+    if (freq_khz < 10000u || freq_khz > 300000u) return false;
+    s_sys_hz = freq_khz * 1000u;
+    return true;
+}
+
+void busy_wait_at_least_cycles(uint32_t minimum_cycles)
+{
+    uint32_t ns = (uint32_t)(((uint64_t)minimum_cycles * 1000000000u) / s_sys_hz);
+    if (ns < s_wait_min_ns) s_wait_min_ns = ns;
+    if (ns > s_wait_max_ns) s_wait_max_ns = ns;
+}
+
+uint32_t get_core_num(void) { return s_core; }
+
+void sim_set_core(uint32_t core) { s_core = core; }
+
+void sim_wait_range_ns(uint32_t *min_ns, uint32_t *max_ns)
+{
+    if (min_ns) *min_ns = s_wait_min_ns;
+    if (max_ns) *max_ns = s_wait_max_ns;
+    s_wait_min_ns = UINT32_MAX;
+    s_wait_max_ns = 0;
+}
+
+// ============================================================================
+//  RTC И ROSC
+// ============================================================================
+
+rosc_hw_t sim_rosc_hw;
+
+void rtc_init(void) { s_rtc_running = false; }
+
+bool rtc_set_datetime(const datetime_t *t)
+{
+    if (!t || t->hour < 0 || t->hour > 23 || t->min < 0 || t->min > 59 || t->sec < 0 || t->sec > 59) return false;
+    s_rtc_base    = *t;
+    s_rtc_base_us = s_now_us;
+    s_rtc_running = true;
+    return true;
+}
+
+bool rtc_get_datetime(datetime_t *t)
+{
+    if (!t || !s_rtc_running) return false;
+    uint64_t secs = (uint64_t)s_rtc_base.hour * 3600u + (uint64_t)s_rtc_base.min * 60u + (uint64_t)s_rtc_base.sec +
+                    (s_now_us - s_rtc_base_us) / 1000000u;
+    uint64_t days = secs / 86400u;
+    secs %= 86400u;
+
+    *t = s_rtc_base;
+    t->hour = (int8_t)(secs / 3600u);
+    t->min  = (int8_t)(secs / 60u % 60u);
+    t->sec  = (int8_t)(secs % 60u);
+    if (s_rtc_base.dotw >= 0) t->dotw = (int8_t)((s_rtc_base.dotw + days) % 7u);
+    return true;
+}
+
+bool rtc_running(void) { return s_rtc_running; }
+
+// ============================================================================
+//  УПРАВЛЕНИЕ
+// ============================================================================
+
+void sim_reset(void)
+{
+    for (uint8_t i = 0; i < s_watch_count; i++) free(s_watch[i].log);
+    memset(s_watch, 0, sizeof(s_watch));
+    memset(s_events, 0, sizeof(s_events));
+    for (uint32_t i = 0; i < SIM_HW_ALARMS; i++) s_hw[i].armed = false;
+    s_watch_count = 0;
+    s_now_us      = 0;
+    s_levels      = 0;
+    s_clock_edges = 0;
+    s_wait_min_ns = UINT32_MAX;
+    s_wait_max_ns = 0;
+    s_sys_hz      = 125000000u;
+    s_core        = 0;
+    s_clock_pin   = 0xFF;
+    s_latch_pin   = 0xFF;
+    s_rtc_running = false;
+}
+
+void sim_set_bus(uint8_t clock_pin, uint8_t latch_pin)
+{
+    s_clock_pin = clock_pin;
+    s_latch_pin = latch_pin;
+}
+
+void sim_watch_data(uint8_t data_pin)
+{
+    if (s_watch_count >= SIM_MAX_WATCH) return;
+    sim_watch_t *w = &s_watch[s_watch_count++];
+    w->pin = data_pin;
+    w->log = calloc(SIM_MAX_LATCHES, sizeof(sim_latch_t));
+    if (!w->log) abort();
+}
+
+const sim_latch_t *sim_latches(uint8_t data_pin, uint32_t *count)
+{
+    for (uint8_t i = 0; i < s_watch_count; i++) {
+        if (s_watch[i].pin == data_pin) {
+            if (count) *count = s_watch[i].count;
+            return s_watch[i].log;
+        }
+    }
+    if (count) *count = 0;
+    return NULL;
+}
+
+uint32_t sim_clock_edges(void) { return s_clock_edges; }
@@ -0,0 +1,63 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Хостовый симулятор для проверки драйвера без железа.
+ *
+ * - Виртуальное время: time_us_64() возвращает время симуляции, которое
+ *   двигает только sim_run_until(). Обработчики выполняются мгновенно.
+ * - Таймеры: repeating_timer и alarm исполняются в порядке времени срабатывания
+ *   с семантикой Pico SDK (отрицательная задержка — от предыдущего срабатывания).
+ *   Аппаратные будильники (hardware_alarm_*) срабатывают на своей цели;
+ *   прошедшая цель не взводится (hardware_alarm_set_target возвращает true).
+ * - GPIO: для линий, назначенных sim_watch_data(), моделируется цепочка 74HC595:
+ *   по фронту CLOCK бит DATA вдвигается в регистр, по фронту LATCH содержимое
+ *   регистра записывается в журнал защелкиваний.
+ * - RTC идет по виртуальному времени с момента rtc_set_datetime().
+ * - Датчик освещенности (sim_als.c) заменяет display_als.c: уровень задает тест.
+ */
+
+#define SIM_MAX_LATCHES  8192u
+
+typedef struct {
+    uint64_t t_us;
+    uint32_t bits;     // Последние вдвинутые биты: первый бит кадра — старший
+} sim_latch_t;
+
+/* Сброс времени, таймеров, линий и журналов. */
+void sim_reset(void);
+
+/* Выполнение всех событий до момента t_us включительно. */
+void sim_run_until(uint64_t t_us);
+
+/* Линии CLOCK/LATCH, общие для всех наблюдаемых цепочек. */
+void sim_set_bus(uint8_t clock_pin, uint8_t latch_pin);
+
+/* Наблюдение за цепочкой на линии DATA. */
+void sim_watch_data(uint8_t data_pin);
+
+/* Журнал защелкиваний цепочки. */
+const sim_latch_t *sim_latches(uint8_t data_pin, uint32_t *count);
+
+/* Число фронтов CLOCK с момента сброса. */
+uint32_t sim_clock_edges(void);
+
+/*
+ * Самая короткая и самая длинная задержка busy_wait_at_least_cycles() в нс
+ * (по частоте clk_sys на момент вызова) с предыдущего запроса. Счетчики сбрасываются.
+ */
+void sim_wait_range_ns(uint32_t *min_ns, uint32_t *max_ns);
+
+/* Ядро, от имени которого выполняется код (get_core_num()). */
+void sim_set_core(uint32_t core);
+
+/* Освещенность для модели датчика: отфильтрованное значение АЦП (12 бит). */
+void sim_set_light(uint16_t raw);
+
+/* Активные таймеры и взведенные будильники (для проверки утечек). */
+uint32_t sim_pending_events(void);
+
+#endif // SIM_H
@@ -0,0 +1,46 @@
+#include "display_als.h"
+#include "sim.h"
+
+/*
+ * Модель датчика освещенности для хостовых тестов (вместо display_als.c).
+ * Фильтра и DMA нет: значение АЦП задает sim_set_light(), публикация —
+ * с тем же гистерезисом, что и в драйвере.
+ */
+
+#define SIM_ALS_DEFAULT_HYSTERESIS  2u
+
+static bool     s_running;
+static uint8_t  s_hysteresis = SIM_ALS_DEFAULT_HYSTERESIS;
+static uint16_t s_raw;
+static uint8_t  s_level;
+static bool     s_level_valid;
+
+void sim_set_light(uint16_t raw) { s_raw = raw > 4095u ? 4095u : raw; }
+
+bool display_als_start(const display_als_config_t *cfg)
+{
+    s_hysteresis = (cfg && cfg->hysteresis) ? cfg->hysteresis : SIM_ALS_DEFAULT_HYSTERESIS;
+    s_level_valid = false;
+    s_running = true;
+    return true;
+}
+
+void display_als_stop(void) { s_running = false; }
+
+bool display_als_is_running(void) { return s_running; }
+
+bool display_als_poll(uint8_t *level)
+{
+    if (!s_running) return false;
+    uint8_t now = (uint8_t)(((uint32_t)s_raw * 255u) / 4095u);
+    uint8_t diff = now > s_level ? (uint8_t)(now - s_level) : (uint8_t)(s_level - now);
+    if (s_level_valid && diff < s_hysteresis) return false;
+    s_level = now;
+    s_level_valid = true;
+    if (level) *level = now;
+    return true;
+}
+
+uint8_t display_als_get_level(void) { return s_level; }
+
+uint16_t display_als_get_raw(void) { return s_raw; }
@@ -0,0 +1,116 @@
+/**
+ * Host check: easing curves (display_ease.h).
+ *
+ * Scenario:
+ *   - every curve evaluated at all 65536 Q16 points and all 256 Q8 points
+ *   - a custom table set and cleared
+ *
+ * Expected:
+ *   - f(0) = 0 and f(1) = 1 exactly in Q16 and Q8, so effects start and end on
+ *     their exact levels
+ *   - every curve except OUT_BOUNCE is non-decreasing
+ *   - OUT_BOUNCE stays within [0, 1]
+ *   - IN_OUT_* curves pass through 1/2 at t = 1/2
+ *   - a NULL custom table falls back to linear
+ */
+
+#include <stdio.h>
+
+#include "display_ease.h"
+
+static const char *const k_names[DISPLAY_EASE_COUNT] = {
+    "DEFAULT", "LINEAR", "IN_QUAD", "IN_CUBIC", "OUT_CUBIC", "IN_OUT_CUBIC",
+    "IN_OUT_SINE", "IN_EXPO", "OUT_EXPO", "OUT_BOUNCE", "CUSTOM",
+};
+
+static uint16_t s_custom[DISPLAY_EASE_LUT_SIZE];
+
+static int check_curve(display_ease_t curve)
+{
+    const char *name = k_names[curve];
+    int failures = 0;
+
+    if (display_ease_q16(curve, 0) != 0 || display_ease_q16(curve, DISPLAY_EASE_ONE) != DISPLAY_EASE_ONE) {
+        printf("FAIL %s: q16 endpoints %u..%u\n", name, (unsigned)display_ease_q16(curve, 0),
+               (unsigned)display_ease_q16(curve, DISPLAY_EASE_ONE));
+        failures++;
+    }
+    if (display_ease_q8(curve, 0) != 0 || display_ease_q8(curve, 255) != 255) {
+        printf("FAIL %s: q8 endpoints %u..%u\n", name, (unsigned)display_ease_q8(curve, 0),
+               (unsigned)display_ease_q8(curve, 255));
+        failures++;
+    }
+
+    // Отскок по определению немонотонен
+    if (curve == DISPLAY_EASE_OUT_BOUNCE) return failures;
+
+    uint16_t prev = 0;
+    for (uint32_t t = 0; t <= DISPLAY_EASE_ONE; t++) {
+        uint16_t v = display_ease_q16(curve, (uint16_t)t);
+        if (v < prev) {
+            printf("FAIL %s: q16 decreases at t=%lu (%u -> %u)\n", name, (unsigned long)t, (unsigned)prev,
+                   (unsigned)v);
+            return failures + 1;
+        }
+        prev = v;
+    }
+    uint8_t prev8 = 0;
+    for (uint32_t t = 0; t <= 255u; t++) {
+        uint8_t v = display_ease_q8(curve, (uint8_t)t);
+        if (v < prev8) {
+            printf("FAIL %s: q8 decreases at t=%lu\n", name, (unsigned long)t);
+            return failures + 1;
+        }
+        prev8 = v;
+    }
+    return failures;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    // Пользовательская таблица: t^2 с точными концами
+    for (uint32_t i = 0; i < DISPLAY_EASE_LUT_SIZE; i++) {
+        s_custom[i] = (uint16_t)(i * i * DISPLAY_EASE_ONE / ((DISPLAY_EASE_LUT_SIZE - 1u) * (DISPLAY_EASE_LUT_SIZE - 1u)));
+    }
+    display_ease_set_custom(s_custom);
+
+    for (uint32_t c = 0; c < DISPLAY_EASE_COUNT; c++) failures += check_curve((display_ease_t)c);
+
+    // Отскок не выходит за [0, 1]: uint16_t не покажет переполнение, поэтому проверка скачка
+    uint16_t prev = 0;
+    for (uint32_t t = 0; t <= DISPLAY_EASE_ONE; t++) {
+        uint16_t v = display_ease_q16(DISPLAY_EASE_OUT_BOUNCE, (uint16_t)t);
+        int32_t jump = (int32_t)v - (int32_t)prev;
+        if (jump > 4096 || jump < -4096) {
+            printf("FAIL OUT_BOUNCE: jump %ld at t=%lu\n", (long)jump, (unsigned long)t);
+            failures++;
+            break;
+        }
+        prev = v;
+    }
+
+    // Симметричные кривые проходят через середину (допуск — шаг интерполяции)
+    static const display_ease_t k_symmetric[] = { DISPLAY_EASE_IN_OUT_CUBIC, DISPLAY_EASE_IN_OUT_SINE };
+    for (uint32_t i = 0; i < 2u; i++) {
+        uint16_t mid = display_ease_q16(k_symmetric[i], 32768u);
+        if (mid < 32768u - 512u || mid > 32768u + 512u) {
+            printf("FAIL %s: f(1/2) = %u\n", k_names[k_symmetric[i]], (unsigned)mid);
+            failures++;
+        }
+    }
+
+    display_ease_set_custom(NULL);
+    if (display_ease_q16(DISPLAY_EASE_CUSTOM, 12345u) != 12345u) {
+        printf("FAIL CUSTOM without a table is not linear\n");
+        failures++;
+    }
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
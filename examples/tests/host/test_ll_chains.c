@@ -0,0 +1,183 @@
+/**
+ * Host check: parallel chain scan-out (display_ll chain_count > 1).
+ *
+ * Scenario:
+ *   - record what the single-chain driver latches for two different 4-digit contents
+ *   - drive both contents at once as two chains sharing CLOCK/LATCH (8 digits)
+ *   - compare each chain's latch timeline with the single-chain reference
+ *
+ * Expected:
+ *   - every chain sees exactly the frames (and PWM-off moments) of the single path
+ *   - clock edges per run are the same as for one chain
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "display_ll.h"
+#include "sim.h"
+
+#define TEST_DATA_PIN    2
+#define TEST_DATA2_PIN   5
+#define TEST_CLOCK_PIN   3
+#define TEST_LATCH_PIN   4
+#define TEST_DIGITS      4
+#define TEST_REFRESH_HZ  200
+#define TEST_RUN_US      50000u
+#define TEST_FRAME_MASK  0xFFFFu   // Сетка (8 бит) + сегменты: содержимое регистров цепочки
+
+static const vfd_segment_map_t k_content[2][TEST_DIGITS] = {
+    { 0x3F, 0x06, 0x5B, 0x4F },
+    { 0x66, 0x6D, 0x7D, 0x07 },
+};
+
+// Полная яркость, PWM с гашением, нулевая и минимальная
+static const uint8_t k_bright[2][TEST_DIGITS] = {
+    { 255, 128,   0,   7 },
+    {  60, 255, 200,   1 },
+};
+
+typedef struct {
+    sim_latch_t frames[SIM_MAX_LATCHES];
+    uint32_t    count;
+    uint32_t    clock_edges;
+} timeline_t;
+
+static timeline_t s_ref[2];
+static timeline_t s_chain[2];
+
+/*
+ * Видимое состояние цепочки: из нескольких защелкиваний в один момент
+ * остается последнее, повтор одинаковых кадров не считается изменением.
+ */
+static void timeline_from_log(timeline_t *tl, uint8_t pin)
+{
+    uint32_t n = 0;
+    const sim_latch_t *log = sim_latches(pin, &n);
+    tl->count = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        if (i + 1u < n && log[i + 1u].t_us == log[i].t_us) continue;
+        uint32_t bits = log[i].bits & TEST_FRAME_MASK;
+        if (tl->count > 0 && tl->frames[tl->count - 1u].bits == bits) continue;
+        tl->frames[tl->count].t_us = log[i].t_us;
+        tl->frames[tl->count].bits = bits;
+        tl->count++;
+    }
+    tl->clock_edges = sim_clock_edges();
+}
+
+static void run_single(uint8_t set, timeline_t *out)
+{
+    static display_ll_t ll;
+    memset(&ll, 0, sizeof(ll));
+
+    sim_reset();
+    sim_set_bus(TEST_CLOCK_PIN, TEST_LATCH_PIN);
+    sim_watch_data(TEST_DATA_PIN);
+
+    display_ll_select(&ll);
+    display_ll_config_t cfg = {
+        .data_pin = TEST_DATA_PIN,
+        .clock_pin = TEST_CLOCK_PIN,
+        .latch_pin = TEST_LATCH_PIN,
+        .digit_count = TEST_DIGITS,
+        .refresh_rate_hz = TEST_REFRESH_HZ,
+    };
+    display_ll_init(&cfg);
+    display_ll_enable_gamma(false);
+    for (uint8_t i = 0; i < TEST_DIGITS; i++) {
+        display_ll_set_digit_raw(i, k_content[set][i]);
+        display_ll_set_brightness(i, k_bright[set][i]);
+    }
+    display_ll_start_refresh();
+    sim_run_until(TEST_RUN_US);
+    timeline_from_log(out, TEST_DATA_PIN);
+    display_ll_deinit();
+    display_ll_select(NULL);
+}
+
+static void run_chains(void)
+{
+    static display_ll_t ll;
+    memset(&ll, 0, sizeof(ll));
+
+    sim_reset();
+    sim_set_bus(TEST_CLOCK_PIN, TEST_LATCH_PIN);
+    sim_watch_data(TEST_DATA_PIN);
+    sim_watch_data(TEST_DATA2_PIN);
+
+    display_ll_select(&ll);
+    display_ll_config_t cfg = {
+        .data_pin = TEST_DATA_PIN,
+        .clock_pin = TEST_CLOCK_PIN,
+        .latch_pin = TEST_LATCH_PIN,
+        .digit_count = 2 * TEST_DIGITS,
+        .refresh_rate_hz = TEST_REFRESH_HZ,
+        .chain_count = 2,
+        .chain_data_pins = { TEST_DATA2_PIN },
+    };
+    display_ll_init(&cfg);
+    display_ll_enable_gamma(false);
+    for (uint8_t c = 0; c < 2; c++) {
+        for (uint8_t i = 0; i < TEST_DIGITS; i++) {
+            display_ll_set_digit_raw((uint8_t)(c * TEST_DIGITS + i), k_content[c][i]);
+            display_ll_set_brightness((uint8_t)(c * TEST_DIGITS + i), k_bright[c][i]);
+        }
+    }
+    display_ll_start_refresh();
+    sim_run_until(TEST_RUN_US);
+    timeline_from_log(&s_chain[0], TEST_DATA_PIN);
+    timeline_from_log(&s_chain[1], TEST_DATA2_PIN);
+    display_ll_deinit();
+    display_ll_select(NULL);
+}
+
+static int compare(const char *name, const timeline_t *ref, const timeline_t *got)
+{
+    if (ref->count != got->count) {
+        printf("FAIL %s: %u state changes, expected %u\n", name, (unsigned)got->count, (unsigned)ref->count);
+        return 1;
+    }
+    for (uint32_t i = 0; i < ref->count; i++) {
+        if (ref->frames[i].t_us != got->frames[i].t_us || ref->frames[i].bits != got->frames[i].bits) {
+            printf("FAIL %s: change %u is 0x%06X @%llu us, expected 0x%06X @%llu us\n", name, (unsigned)i,
+                   (unsigned)got->frames[i].bits, (unsigned long long)got->frames[i].t_us,
+                   (unsigned)ref->frames[i].bits, (unsigned long long)ref->frames[i].t_us);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(void)
+{
+    int failed = 0;
+
+    run_single(0, &s_ref[0]);
+    run_single(1, &s_ref[1]);
+    run_chains();
+
+    failed |= compare("chain 0", &s_ref[0], &s_chain[0]);
+    failed |= compare("chain 1", &s_ref[1], &s_chain[1]);
+
+    if (s_ref[0].count < 2u * TEST_DIGITS) {
+        printf("FAIL reference run produced only %u changes\n", (unsigned)s_ref[0].count);
+        failed = 1;
+    }
+    if (sim_pending_events() != 0) {
+        printf("FAIL %u timer events left after deinit\n", (unsigned)sim_pending_events());
+        failed = 1;
+    }
+
+    // Стоимость: K цепочек за то же число тактов CLOCK, что и одна
+    printf("clock edges: single %u + %u, chains %u\n", (unsigned)s_ref[0].clock_edges,
+           (unsigned)s_ref[1].clock_edges, (unsigned)s_chain[0].clock_edges);
+    if (s_chain[0].clock_edges > s_ref[0].clock_edges + s_ref[1].clock_edges / 2u) {
+        printf("FAIL parallel scan-out is not cheaper than serial\n");
+        failed = 1;
+    }
+
+    printf(failed ? "ll_chains: FAILED\n" : "ll_chains: OK (%u state changes per chain)\n",
+           (unsigned)s_ref[0].count);
+    return failed;
+}
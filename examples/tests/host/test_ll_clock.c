@@ -0,0 +1,133 @@
+/**
+ * Host check: clk_sys changes while refresh is running (display_ll_set_sys_clock_khz).
+ *
+ * Scenario:
+ *   - record the latch timeline at a constant 125 MHz
+ *   - repeat, switching clk_sys between 48 and 133 MHz every few milliseconds
+ *
+ * Expected:
+ *   - identical latch timeline (slot and PWM-off moments do not depend on clk_sys)
+ *   - no missed slots
+ *   - CLOCK/LATCH pulses never shorter than 24 ns and at most one clk_sys cycle longer
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "display_ll.h"
+#include "sim.h"
+
+#define TEST_DATA_PIN    2
+#define TEST_CLOCK_PIN   3
+#define TEST_LATCH_PIN   4
+#define TEST_DIGITS      4
+#define TEST_REFRESH_HZ  120
+#define TEST_STEP_US     7000u
+#define TEST_STEPS       40u
+#define TEST_PULSE_NS    24u
+
+static const vfd_segment_map_t k_content[TEST_DIGITS] = { 0x3F, 0x06, 0x5B, 0x4F };
+static const uint8_t k_bright[TEST_DIGITS] = { 255, 90, 7, 180 };
+static const uint32_t k_clocks_khz[] = { 48000, 133000, 96000, 125000, 48000, 133000 };
+
+static sim_latch_t s_ref[SIM_MAX_LATCHES];
+static uint32_t    s_ref_count;
+
+static int run(bool switch_clock, uint32_t *missed)
+{
+    static display_ll_t ll;
+    memset(&ll, 0, sizeof(ll));
+    int failures = 0;
+
+    sim_reset();
+    sim_set_bus(TEST_CLOCK_PIN, TEST_LATCH_PIN);
+    sim_watch_data(TEST_DATA_PIN);
+
+    display_ll_select(&ll);
+    display_ll_config_t cfg = {
+        .data_pin = TEST_DATA_PIN,
+        .clock_pin = TEST_CLOCK_PIN,
+        .latch_pin = TEST_LATCH_PIN,
+        .digit_count = TEST_DIGITS,
+        .refresh_rate_hz = TEST_REFRESH_HZ,
+    };
+    display_ll_set_sys_clock_khz(125000, true);
+    if (!display_ll_init(&cfg) || !display_ll_start_refresh()) {
+        printf("FAIL init\n");
+        return 1;
+    }
+    display_ll_set_frame(k_content, TEST_DIGITS);
+    for (uint8_t i = 0; i < TEST_DIGITS; i++) display_ll_set_brightness(i, k_bright[i]);
+
+    uint64_t t = 0;
+    for (uint32_t step = 0; step < TEST_STEPS; step++) {
+        uint32_t khz = 125000;
+        if (switch_clock) {
+            khz = k_clocks_khz[step % (sizeof(k_clocks_khz) / sizeof(k_clocks_khz[0]))];
+            if (!display_ll_set_sys_clock_khz(khz, true)) {
+                printf("FAIL set clock %lu kHz\n", (unsigned long)khz);
+                failures++;
+            }
+        }
+        sim_wait_range_ns(NULL, NULL);
+
+        t += TEST_STEP_US;
+        sim_run_until(t);
+
+        uint32_t min_ns, max_ns;
+        sim_wait_range_ns(&min_ns, &max_ns);
+        uint32_t cycle_ns = 1000000u / khz + 1u;
+        if (min_ns < TEST_PULSE_NS || max_ns > TEST_PULSE_NS + cycle_ns) {
+            printf("FAIL %lu kHz: pulse %lu..%lu ns, expected %u..%lu\n",
+                   (unsigned long)khz, (unsigned long)min_ns, (unsigned long)max_ns,
+                   TEST_PULSE_NS, (unsigned long)(TEST_PULSE_NS + cycle_ns));
+            failures++;
+        }
+    }
+
+    display_ll_stats_t st;
+    display_ll_get_stats(&st);
+    *missed = st.missed_slots;
+
+    display_ll_deinit();
+    return failures;
+}
+
+int main(void)
+{
+    int failures = 0;
+    uint32_t missed = 0;
+
+    failures += run(false, &missed);
+    const sim_latch_t *log = sim_latches(TEST_DATA_PIN, &s_ref_count);
+    memcpy(s_ref, log, s_ref_count * sizeof(sim_latch_t));
+
+    failures += run(true, &missed);
+    uint32_t count = 0;
+    log = sim_latches(TEST_DATA_PIN, &count);
+
+    if (count != s_ref_count) {
+        printf("FAIL %lu latches with clock changes, %lu without\n",
+               (unsigned long)count, (unsigned long)s_ref_count);
+        failures++;
+    } else {
+        for (uint32_t i = 0; i < count; i++) {
+            if (log[i].t_us != s_ref[i].t_us || log[i].bits != s_ref[i].bits) {
+                printf("FAIL latch %lu differs: t=%llu bits=%08lx, expected t=%llu bits=%08lx\n",
+                       (unsigned long)i,
+                       (unsigned long long)log[i].t_us, (unsigned long)log[i].bits,
+                       (unsigned long long)s_ref[i].t_us, (unsigned long)s_ref[i].bits);
+                failures++;
+                break;
+            }
+        }
+    }
+
+    if (missed != 0) {
+        printf("FAIL %lu missed slots\n", (unsigned long)missed);
+        failures++;
+    }
+
+    if (failures == 0) printf("PASS clock scaling: %lu latches\n", (unsigned long)count);
+    return failures ? 1 : 0;
+}
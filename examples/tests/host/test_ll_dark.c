@@ -0,0 +1,151 @@
+/**
+ * Host check: dark suspend (display_ll_config_t.dark_suspend).
+ *
+ * Scenario:
+ *   - 4 digits at 200 Hz with dark_suspend, a lit frame for 20 ms
+ *   - all brightness set to 0, run 50 ms
+ *   - one digit lit again, run 20 ms
+ *   - the same dark frame without dark_suspend
+ *
+ * Expected:
+ *   - the dark frame suspends the scan at the next digit 0 (within one cycle)
+ *   - while suspended: no latches, no CLOCK edges, no armed timer events
+ *   - lighting a digit resumes at once; the first latch follows within one slot
+ *     and shows the lit digit
+ *   - without dark_suspend the dark frame keeps scanning
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "display_ll.h"
+#include "sim.h"
+
+#define TEST_DATA_PIN    2
+#define TEST_CLOCK_PIN   3
+#define TEST_LATCH_PIN   4
+#define TEST_DIGITS      4
+#define TEST_REFRESH_HZ  200
+#define TEST_SLOT_US     (1000000u / (TEST_REFRESH_HZ * TEST_DIGITS))
+#define TEST_CYCLE_US    (TEST_SLOT_US * TEST_DIGITS)
+
+static const vfd_segment_map_t k_content[TEST_DIGITS] = { 0x3F, 0x06, 0x5B, 0x4F };
+
+static display_ll_t s_ll;
+
+static bool setup(bool dark_suspend)
+{
+    memset(&s_ll, 0, sizeof(s_ll));
+    sim_reset();
+    sim_set_bus(TEST_CLOCK_PIN, TEST_LATCH_PIN);
+    sim_watch_data(TEST_DATA_PIN);
+
+    display_ll_select(&s_ll);
+    display_ll_config_t cfg = {
+        .data_pin = TEST_DATA_PIN,
+        .clock_pin = TEST_CLOCK_PIN,
+        .latch_pin = TEST_LATCH_PIN,
+        .digit_count = TEST_DIGITS,
+        .refresh_rate_hz = TEST_REFRESH_HZ,
+        .dark_suspend = dark_suspend,
+    };
+    if (!display_ll_init(&cfg)) return false;
+    display_ll_enable_gamma(false);
+    display_ll_set_frame(k_content, TEST_DIGITS);
+    for (uint8_t i = 0; i < TEST_DIGITS; i++) display_ll_set_brightness(i, 255);
+    return display_ll_start_refresh();
+}
+
+static void teardown(void)
+{
+    display_ll_deinit();
+    display_ll_select(NULL);
+}
+
+static uint32_t latch_count(void)
+{
+    uint32_t n = 0;
+    sim_latches(TEST_DATA_PIN, &n);
+    return n;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    // 1. Светящийся кадр, затем темный
+    if (!setup(true)) {
+        printf("FAIL init\n");
+        return 1;
+    }
+    sim_run_until(20000);
+    if (display_ll_is_suspended() || latch_count() == 0) {
+        printf("FAIL lit frame: suspended=%d latches=%lu\n", display_ll_is_suspended(),
+               (unsigned long)latch_count());
+        failures++;
+    }
+
+    for (uint8_t i = 0; i < TEST_DIGITS; i++) display_ll_set_brightness(i, 0);
+    sim_run_until(20000 + TEST_CYCLE_US);
+    if (!display_ll_is_suspended()) {
+        printf("FAIL dark frame not suspended after one cycle\n");
+        failures++;
+    }
+
+    // 2. Пауза: ни защелкиваний, ни тактов, ни взведенных будильников
+    uint32_t latches = latch_count();
+    uint32_t edges = sim_clock_edges();
+    sim_run_until(70000);
+    if (latch_count() != latches || sim_clock_edges() != edges || sim_pending_events() != 0) {
+        printf("FAIL suspended scan is active: latches +%lu, clock edges +%lu, events %lu\n",
+               (unsigned long)(latch_count() - latches), (unsigned long)(sim_clock_edges() - edges),
+               (unsigned long)sim_pending_events());
+        failures++;
+    }
+
+    // 3. Выход: сразу из сеттера, первый кадр — в пределах слота
+    display_ll_set_brightness(2, 255);
+    if (display_ll_is_suspended()) {
+        printf("FAIL lit digit did not resume the scan\n");
+        failures++;
+    }
+    sim_run_until(90000);
+    uint32_t n = 0;
+    const sim_latch_t *log = sim_latches(TEST_DATA_PIN, &n);
+    if (n <= latches || log[latches].t_us > 70000u + TEST_SLOT_US) {
+        printf("FAIL resume: first latch %s\n", n > latches ? "too late" : "missing");
+        failures++;
+    } else {
+        bool digit2 = false;
+        for (uint32_t i = latches; i < n; i++) {
+            if ((log[i].bits & 0xFFu) == k_content[2]) digit2 = true;
+        }
+        if (!digit2) {
+            printf("FAIL resumed scan never shows digit 2\n");
+            failures++;
+        }
+    }
+    teardown();
+
+    // 4. Без dark_suspend темный кадр продолжает развертку
+    if (!setup(false)) {
+        printf("FAIL init (no dark_suspend)\n");
+        return 1;
+    }
+    for (uint8_t i = 0; i < TEST_DIGITS; i++) display_ll_set_brightness(i, 0);
+    sim_run_until(10000);
+    latches = latch_count();
+    sim_run_until(20000);
+    if (display_ll_is_suspended() || latch_count() == latches) {
+        printf("FAIL dark frame without dark_suspend: suspended=%d\n", display_ll_is_suspended());
+        failures++;
+    }
+    teardown();
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,147 @@
+/**
+ * Host check: adaptive refresh governor (refresh_min_hz / refresh_max_hz).
+ *
+ * The simulator runs handlers in zero time, so every measurement window sees
+ * no ISR load and the governor only steps the rate up.
+ *
+ * Scenario:
+ *   - 4 digits at 100 Hz, governor range 60..200 Hz
+ *   - run 1 s of virtual time in 100 us steps
+ *
+ * Expected:
+ *   - the rate climbs by rate/8 per window: 100, 112, 126, 141, 158, 177, 199, 200
+ *   - at every step display_ll_get_refresh_rate() matches the slot period in use
+ *     (a new rate is reported only once its period applies at digit 0)
+ *   - at least one decision waited for the cycle boundary
+ *   - at the top rate the slots are 1250 us apart
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "display_ll.h"
+#include "sim.h"
+
+#define TEST_DATA_PIN    2
+#define TEST_CLOCK_PIN   3
+#define TEST_LATCH_PIN   4
+#define TEST_DIGITS      4
+#define TEST_REFRESH_HZ  100
+#define TEST_MIN_HZ      60
+#define TEST_MAX_HZ      200
+#define TEST_STEP_US     100u
+#define TEST_RUN_US      1000000u
+
+static const uint16_t k_rates[] = { 100, 112, 126, 141, 158, 177, 199, 200 };
+#define TEST_RATE_COUNT  (sizeof(k_rates) / sizeof(k_rates[0]))
+
+int main(void)
+{
+    static display_ll_t ll;
+    int failures = 0;
+
+    sim_reset();
+    sim_set_bus(TEST_CLOCK_PIN, TEST_LATCH_PIN);
+    sim_watch_data(TEST_DATA_PIN);
+
+    display_ll_select(&ll);
+    display_ll_config_t cfg = {
+        .data_pin = TEST_DATA_PIN,
+        .clock_pin = TEST_CLOCK_PIN,
+        .latch_pin = TEST_LATCH_PIN,
+        .digit_count = TEST_DIGITS,
+        .refresh_rate_hz = TEST_REFRESH_HZ,
+        .refresh_min_hz = TEST_MIN_HZ,
+        .refresh_max_hz = TEST_MAX_HZ,
+    };
+    if (!display_ll_init(&cfg)) {
+        printf("FAIL init\n");
+        return 1;
+    }
+    display_ll_enable_gamma(false);
+    for (uint8_t i = 0; i < TEST_DIGITS; i++) {
+        display_ll_set_digit_raw(i, 0x7F);
+        display_ll_set_brightness(i, 255);
+    }
+    display_ll_start_refresh();
+
+    uint16_t seen[TEST_RATE_COUNT + 4];
+    uint32_t seen_count = 0;
+    uint32_t pending_steps = 0;
+
+    for (uint64_t t = TEST_STEP_US; t <= TEST_RUN_US; t += TEST_STEP_US) {
+        sim_run_until(t);
+
+        uint16_t rate = display_ll_get_refresh_rate();
+        uint32_t period = 1000000u / ((uint32_t)rate * TEST_DIGITS);
+        if (period != ll.slot_period_us) {
+            printf("FAIL @%llu us: reported %u Hz, slot period %lu us (expected %lu)\n",
+                   (unsigned long long)t, (unsigned)rate, (unsigned long)ll.slot_period_us,
+                   (unsigned long)period);
+            failures++;
+            break;
+        }
+        if (ll.gov_pending_period_us) pending_steps++;
+
+        if (seen_count == 0 || seen[seen_count - 1u] != rate) {
+            if (seen_count == TEST_RATE_COUNT + 4) {
+                printf("FAIL too many rate changes\n");
+                failures++;
+                break;
+            }
+            seen[seen_count++] = rate;
+        }
+    }
+
+    if (seen_count != TEST_RATE_COUNT) {
+        printf("FAIL %lu distinct rates, expected %lu\n", (unsigned long)seen_count, (unsigned long)TEST_RATE_COUNT);
+        failures++;
+    } else {
+        for (uint32_t i = 0; i < TEST_RATE_COUNT; i++) {
+            if (seen[i] != k_rates[i]) {
+                printf("FAIL step %lu: %u Hz, expected %u Hz\n", (unsigned long)i, (unsigned)seen[i],
+                       (unsigned)k_rates[i]);
+                failures++;
+                break;
+            }
+        }
+    }
+
+    // Решение регулятора, принятое не на разряде 0, ждет границы цикла
+    if (pending_steps == 0) {
+        printf("FAIL no governor decision waited for the cycle boundary\n");
+        failures++;
+    }
+
+    // Разряд 0 защелкивается раз в цикл: на верхней частоте цикл 4 * 1250 мкс
+    uint32_t n = 0;
+    const sim_latch_t *log = sim_latches(TEST_DATA_PIN, &n);
+    uint64_t first0 = 0, last0 = 0;
+    uint32_t cycles = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        if (log[i].t_us < TEST_RUN_US - 100000u) continue;
+        if (((log[i].bits >> 8) & 0xFFu) != 0x01u) continue;   // Сетка разряда 0
+        if (cycles > 0 && log[i].t_us == last0) continue;
+        if (cycles == 0) first0 = log[i].t_us;
+        last0 = log[i].t_us;
+        cycles++;
+    }
+    if (cycles < 2 || (last0 - first0) != (uint64_t)(cycles - 1u) * TEST_DIGITS * 1250u) {
+        printf("FAIL top rate cycle: %lu cycles over %llu us\n", (unsigned long)cycles,
+               (unsigned long long)(last0 - first0));
+        failures++;
+    }
+
+    display_ll_deinit();
+    display_ll_select(NULL);
+
+    printf("rates:");
+    for (uint32_t i = 0; i < seen_count; i++) printf(" %u", (unsigned)seen[i]);
+    printf(", pending at %lu steps\n", (unsigned long)pending_steps);
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,132 @@
+/**
+ * Host check: power limiter (display_ll_set_power_budget).
+ *
+ * Load of a digit = lit segments x brightness, maximum 4 x 8 x 255 = 8160.
+ *
+ * Scenario (4 digits at 255: 8, 8, 1 and 0 segments, load 4335):
+ *   - GLOBAL at 250 permille (limit 2040)
+ *   - PER_DIGIT at 250 permille (510 per digit)
+ *   - GLOBAL at 600 permille (limit above the load)
+ *   - GLOBAL at 250 permille, then digit 2 gets all 8 segments (load 6120)
+ *   - budget 0
+ *
+ * Expected:
+ *   - GLOBAL: every digit scaled by 120/256 -> PWM 119, throttle 534
+ *   - PER_DIGIT: only the two full digits limited -> 63, 63, 255, 255, throttle 709
+ *   - under budget: PWM untouched, throttle 0
+ *   - single-digit update rescales all digits -> 85/256, PWM 84, throttle 671
+ *   - budget 0 switches the limiter off
+ *   - limited load never exceeds the budget
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "display_ll.h"
+#include "sim.h"
+
+#define TEST_DATA_PIN    2
+#define TEST_CLOCK_PIN   3
+#define TEST_LATCH_PIN   4
+#define TEST_DIGITS      4
+#define TEST_REFRESH_HZ  200
+
+static const vfd_segment_map_t k_content[TEST_DIGITS] = { 0xFF, 0xFF, 0x01, 0x00 };
+
+static display_ll_t s_ll;
+
+static int check(const char *name, const uint8_t *pwm, uint16_t throttle)
+{
+    int failures = 0;
+    for (uint8_t i = 0; i < TEST_DIGITS; i++) {
+        if (s_ll.pwm[i] != pwm[i]) {
+            printf("FAIL %s: digit %u PWM %u, expected %u\n", name, (unsigned)i, (unsigned)s_ll.pwm[i],
+                   (unsigned)pwm[i]);
+            failures++;
+        }
+    }
+
+    display_ll_stats_t st;
+    display_ll_get_stats(&st);
+    if (display_ll_get_power_throttle() != throttle || st.throttle_permille != throttle) {
+        printf("FAIL %s: throttle %u (stats %u), expected %u\n", name, (unsigned)display_ll_get_power_throttle(),
+               (unsigned)st.throttle_permille, (unsigned)throttle);
+        failures++;
+    }
+
+    // Нагрузка после ограничителя укладывается в бюджет
+    uint32_t effective = 0;
+    for (uint8_t i = 0; i < TEST_DIGITS; i++) {
+        effective += (uint32_t)__builtin_popcount(s_ll.seg_buffer[i]) * s_ll.pwm[i];
+    }
+    if (s_ll.power_budget != 0 && effective > s_ll.power_limit) {
+        printf("FAIL %s: load %lu over limit %lu\n", name, (unsigned long)effective,
+               (unsigned long)s_ll.power_limit);
+        failures++;
+    }
+    return failures;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    sim_reset();
+    sim_set_bus(TEST_CLOCK_PIN, TEST_LATCH_PIN);
+    sim_watch_data(TEST_DATA_PIN);
+
+    display_ll_select(&s_ll);
+    display_ll_config_t cfg = {
+        .data_pin = TEST_DATA_PIN,
+        .clock_pin = TEST_CLOCK_PIN,
+        .latch_pin = TEST_LATCH_PIN,
+        .digit_count = TEST_DIGITS,
+        .refresh_rate_hz = TEST_REFRESH_HZ,
+    };
+    if (!display_ll_init(&cfg)) {
+        printf("FAIL init\n");
+        return 1;
+    }
+    display_ll_enable_gamma(false);
+    display_ll_set_frame(k_content, TEST_DIGITS);
+    display_ll_set_brightness_all(255);
+    if (s_ll.total_load != 4335u) {
+        printf("FAIL load %lu, expected 4335\n", (unsigned long)s_ll.total_load);
+        failures++;
+    }
+
+    // 1. Общий коэффициент: (2040 << 8) / 4335 = 120
+    display_ll_set_power_budget(250, DISPLAY_LL_POWER_GLOBAL);
+    static const uint8_t k_global[TEST_DIGITS] = { 119, 119, 119, 119 };
+    failures += check("GLOBAL 250", k_global, 534);
+
+    // 2. Поразрядно: 255 * 510 / 2040 = 63 у полных разрядов, остальные не тронуты
+    display_ll_set_power_budget(250, DISPLAY_LL_POWER_PER_DIGIT);
+    static const uint8_t k_per_digit[TEST_DIGITS] = { 63, 63, 255, 255 };
+    failures += check("PER_DIGIT 250", k_per_digit, 709);
+
+    // 3. Нагрузка в пределах бюджета
+    display_ll_set_power_budget(600, DISPLAY_LL_POWER_GLOBAL);
+    static const uint8_t k_full[TEST_DIGITS] = { 255, 255, 255, 255 };
+    failures += check("GLOBAL 600", k_full, 0);
+
+    // 4. Изменение одного разряда пересчитывает коэффициент для всех: (2040 << 8) / 6120 = 85
+    display_ll_set_power_budget(250, DISPLAY_LL_POWER_GLOBAL);
+    display_ll_set_digit_raw(2, 0xFF);
+    static const uint8_t k_rescaled[TEST_DIGITS] = { 84, 84, 84, 84 };
+    failures += check("GLOBAL 250 + digit 2", k_rescaled, 671);
+
+    // 5. Ограничитель выключен
+    display_ll_set_power_budget(0, DISPLAY_LL_POWER_GLOBAL);
+    failures += check("off", k_full, 0);
+
+    display_ll_deinit();
+    display_ll_select(NULL);
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
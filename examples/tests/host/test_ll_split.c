@@ -0,0 +1,150 @@
+/**
+ * Host check: split grid/segment data lines (display_ll bus = SPLIT / SPLIT3).
+ *
+ * Scenario:
+ *   - record the serial driver (one DATA line) for 4 and 10 digits
+ *   - repeat with SPLIT (grid + segment lines) and SPLIT3 (+ second grid byte line)
+ *   - rebuild the serial register contents from the separate lines and compare
+ *
+ * Expected:
+ *   - identical latch timeline (frames and PWM-off moments)
+ *   - 8 clocks per frame for SPLIT / SPLIT3, 16 for SPLIT with two grid bytes
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "display_ll.h"
+#include "sim.h"
+
+#define TEST_DATA_PIN    2
+#define TEST_CLOCK_PIN   3
+#define TEST_LATCH_PIN   4
+#define TEST_SEG_PIN     5
+#define TEST_GRID_HI_PIN 6
+#define TEST_REFRESH_HZ  200
+#define TEST_RUN_US      50000u
+
+static const vfd_segment_map_t k_content[VFD_MAX_DIGITS] = {
+    0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F
+};
+static const uint8_t k_bright[VFD_MAX_DIGITS] = {
+    255, 128, 0, 7, 60, 255, 200, 1, 90, 255
+};
+
+typedef struct {
+    sim_latch_t frames[SIM_MAX_LATCHES];
+    uint32_t    count;
+    uint32_t    latches;
+    uint32_t    clock_edges;
+} timeline_t;
+
+static timeline_t s_serial;
+static timeline_t s_split;
+
+/* Добавление защелкивания: из нескольких в один момент остается последнее, повторы пропускаются. */
+static void timeline_push(timeline_t *tl, uint64_t t_us, uint32_t bits, bool last_at_t)
+{
+    tl->latches++;
+    if (!last_at_t) return;
+    if (tl->count > 0 && tl->frames[tl->count - 1u].bits == bits) return;
+    tl->frames[tl->count].t_us = t_us;
+    tl->frames[tl->count].bits = bits;
+    tl->count++;
+}
+
+static void run(display_ll_bus_t bus, uint8_t digits, timeline_t *out)
+{
+    static display_ll_t ll;
+    memset(&ll, 0, sizeof(ll));
+    memset(out, 0, sizeof(*out));
+
+    sim_reset();
+    sim_set_bus(TEST_CLOCK_PIN, TEST_LATCH_PIN);
+    sim_watch_data(TEST_DATA_PIN);
+    sim_watch_data(TEST_SEG_PIN);
+    sim_watch_data(TEST_GRID_HI_PIN);
+
+    display_ll_select(&ll);
+    display_ll_config_t cfg = {
+        .data_pin = TEST_DATA_PIN,
+        .clock_pin = TEST_CLOCK_PIN,
+        .latch_pin = TEST_LATCH_PIN,
+        .digit_count = digits,
+        .refresh_rate_hz = TEST_REFRESH_HZ,
+        .bus = bus,
+        .seg_data_pin = TEST_SEG_PIN,
+        .grid_hi_data_pin = TEST_GRID_HI_PIN,
+    };
+    if (!display_ll_init(&cfg)) {
+        printf("FAIL init bus %d, %u digits\n", (int)bus, (unsigned)digits);
+        return;
+    }
+    display_ll_enable_gamma(false);
+    for (uint8_t i = 0; i < digits; i++) {
+        display_ll_set_digit_raw(i, k_content[i]);
+        display_ll_set_brightness(i, k_bright[i]);
+    }
+    display_ll_start_refresh();
+    sim_run_until(TEST_RUN_US);
+
+    uint32_t n = 0, n_seg = 0, n_hi = 0;
+    const sim_latch_t *grid = sim_latches(TEST_DATA_PIN, &n);
+    const sim_latch_t *seg  = sim_latches(TEST_SEG_PIN, &n_seg);
+    const sim_latch_t *hi   = sim_latches(TEST_GRID_HI_PIN, &n_hi);
+    bool ext = digits > 8;
+
+    for (uint32_t i = 0; i < n; i++) {
+        // Содержимое регистров в раскладке последовательной шины: [grid lo][grid hi][seg]
+        uint32_t bits;
+        if (bus == DISPLAY_LL_BUS_SERIAL) {
+            bits = grid[i].bits & (ext ? 0xFFFFFFu : 0xFFFFu);
+        } else if (bus == DISPLAY_LL_BUS_SPLIT3) {
+            bits = ((grid[i].bits & 0xFFu) << 16) | ((hi[i].bits & 0xFFu) << 8) | (seg[i].bits & 0xFFu);
+        } else {
+            bits = ((grid[i].bits & (ext ? 0xFFFFu : 0xFFu)) << 8) | (seg[i].bits & 0xFFu);
+        }
+        bool last_at_t = (i + 1u >= n) || grid[i + 1u].t_us != grid[i].t_us;
+        timeline_push(out, grid[i].t_us, bits, last_at_t);
+    }
+    out->clock_edges = sim_clock_edges();
+
+    display_ll_deinit();
+    display_ll_select(NULL);
+}
+
+static int check(const char *name, display_ll_bus_t bus, uint8_t digits, uint32_t clocks_per_frame)
+{
+    run(DISPLAY_LL_BUS_SERIAL, digits, &s_serial);
+    run(bus, digits, &s_split);
+
+    if (s_serial.count < digits || s_serial.count != s_split.count) {
+        printf("FAIL %s: %u state changes, serial %u\n", name, (unsigned)s_split.count, (unsigned)s_serial.count);
+        return 1;
+    }
+    for (uint32_t i = 0; i < s_serial.count; i++) {
+        if (s_serial.frames[i].t_us != s_split.frames[i].t_us || s_serial.frames[i].bits != s_split.frames[i].bits) {
+            printf("FAIL %s: change %u is 0x%06X @%llu us, serial 0x%06X @%llu us\n", name, (unsigned)i,
+                   (unsigned)s_split.frames[i].bits, (unsigned long long)s_split.frames[i].t_us,
+                   (unsigned)s_serial.frames[i].bits, (unsigned long long)s_serial.frames[i].t_us);
+            return 1;
+        }
+    }
+    if (s_split.clock_edges != s_split.latches * clocks_per_frame) {
+        printf("FAIL %s: %u clocks for %u frames, expected %u per frame\n", name,
+               (unsigned)s_split.clock_edges, (unsigned)s_split.latches, (unsigned)clocks_per_frame);
+        return 1;
+    }
+    printf("%s: OK, %u clocks vs %u serial\n", name, (unsigned)s_split.clock_edges, (unsigned)s_serial.clock_edges);
+    return 0;
+}
+
+int main(void)
+{
+    int failed = 0;
+    failed |= check("split 4 digits", DISPLAY_LL_BUS_SPLIT, 4, 8);
+    failed |= check("split 10 digits", DISPLAY_LL_BUS_SPLIT, 10, 16);
+    failed |= check("split3 10 digits", DISPLAY_LL_BUS_SPLIT3, 10, 8);
+    printf(failed ? "ll_split: FAILED\n" : "ll_split: OK\n");
+    return failed;
+}
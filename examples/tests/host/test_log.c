@@ -0,0 +1,174 @@
+/**
+ * Host check: deferred log ring (logging.h, display_log.c).
+ *
+ * Built with VFD_LOG_LEVEL = WARN.
+ *
+ * Scenario:
+ *   - LOG_INFO / LOG_DEBUG with side effects in the arguments
+ *   - interleaved LOG_WARN / LOG_ERROR from both cores with advancing time
+ *   - more records than the ring holds
+ *   - records with float and 64-bit conversions
+ *
+ * Expected:
+ *   - filtered calls leave nothing in the ring and do not evaluate arguments
+ *   - nothing is printed until display_log_drain()
+ *   - drained lines are in time order across cores, arguments formatted as printf would
+ *   - overflow is counted and reported once, the ring keeps the oldest records
+ *   - unsupported formats are printed as "unsupported log format: <fmt>" instead of being replayed
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "logging.h"
+#include "sim.h"
+
+#define TEST_RING_LEN  32u
+
+static FILE *s_capture;
+static int   s_saved_fd = -1;
+
+static void capture_begin(void)
+{
+    fflush(stdout);
+    s_capture  = tmpfile();
+    s_saved_fd = dup(STDOUT_FILENO);
+    dup2(fileno(s_capture), STDOUT_FILENO);
+}
+
+/* Возвращает захваченный вывод (освобождает вызывающий). */
+static char *capture_end(void)
+{
+    fflush(stdout);
+    dup2(s_saved_fd, STDOUT_FILENO);
+    close(s_saved_fd);
+
+    long len = ftell(s_capture);
+    char *out = calloc(1, (size_t)len + 1);
+    rewind(s_capture);
+    if (len > 0 && fread(out, 1, (size_t)len, s_capture) != (size_t)len) out[0] = '\0';
+    fclose(s_capture);
+    return out;
+}
+
+static uint32_t count_lines(const char *s)
+{
+    uint32_t n = 0;
+    for (; *s; s++) if (*s == '\n') n++;
+    return n;
+}
+
+static int s_evaluated;
+/* Используется только в отсеченных вызовах */
+__attribute__((unused)) static int side_effect(void) { return ++s_evaluated; }
+
+int main(void)
+{
+    int failures = 0;
+    display_log_stats_t st;
+
+    sim_reset();
+
+    // 1. Отсечение уровня при сборке
+    LOG_INFO("info %d", side_effect());
+    LOG_DEBUG("debug %d", side_effect());
+    display_log_get_stats(&st);
+    if (s_evaluated != 0 || st.written != 0) {
+        printf("FAIL filtered calls: evaluated=%d written=%lu\n", s_evaluated, (unsigned long)st.written);
+        failures++;
+    }
+
+    // 2. Запись с двух ядер, вывод в порядке времени
+    capture_begin();
+    sim_run_until(1000);
+    sim_set_core(1);
+    LOG_WARN("core1 first %u", 7u);
+    sim_run_until(2000);
+    sim_set_core(0);
+    LOG_ERROR("core0 %s %d", "second", -5);
+    sim_run_until(3000);
+    sim_set_core(1);
+    LOG_WARN("core1 third %lu %x", (unsigned long)123456, 0xBEEFu);
+    sim_run_until(4000);
+    sim_set_core(0);
+    LOG_WARN("plain");
+    char *before = capture_end();
+
+    display_log_get_stats(&st);
+    if (before[0] != '\0' || st.written != 4 || st.pending != 4) {
+        printf("FAIL write printed early or lost: '%s' written=%lu pending=%u\n",
+               before, (unsigned long)st.written, (unsigned)st.pending);
+        failures++;
+    }
+    free(before);
+
+    capture_begin();
+    uint32_t n1 = display_log_drain(3);
+    uint32_t n2 = display_log_drain(0);
+    char *out = capture_end();
+
+    const char *expect[] = {
+        "[0.001000] core1 first 7",
+        "[0.002000] core0 second -5",
+        "[0.003000] core1 third 123456 beef",
+        "[0.004000] plain",
+    };
+    const char *p = out;
+    for (uint32_t i = 0; i < 4; i++) {
+        const char *hit = strstr(p, expect[i]);
+        if (!hit) {
+            printf("FAIL line %lu '%s' missing or out of order\n", (unsigned long)i, expect[i]);
+            failures++;
+            break;
+        }
+        p = hit + strlen(expect[i]);
+    }
+    if (n1 != 3 || n2 != 1 || count_lines(out) != 4 || !strstr(out, "[ERROR] ")) {
+        printf("FAIL drain: n1=%lu n2=%lu output:\n%s", (unsigned long)n1, (unsigned long)n2, out);
+        failures++;
+    }
+    free(out);
+
+    // 3. Переполнение: старые записи сохраняются, потеря сообщается один раз
+    for (uint32_t i = 0; i < TEST_RING_LEN + 5u; i++) LOG_ERROR("rec %lu", (unsigned long)i);
+    display_log_get_stats(&st);
+    if (st.dropped != 5 || st.pending != TEST_RING_LEN) {
+        printf("FAIL overflow: dropped=%lu pending=%u\n", (unsigned long)st.dropped, (unsigned)st.pending);
+        failures++;
+    }
+
+    capture_begin();
+    uint32_t n3 = display_log_drain(0);
+    uint32_t n4 = display_log_drain(0);
+    out = capture_end();
+    if (n3 != TEST_RING_LEN || n4 != 0 || !strstr(out, "5 log records dropped") ||
+        !strstr(out, "rec 0\n") || strstr(out, "rec 32") || count_lines(out) != TEST_RING_LEN + 1u) {
+        printf("FAIL overflow drain: n3=%lu n4=%lu\n", (unsigned long)n3, (unsigned long)n4);
+        failures++;
+    }
+    free(out);
+
+    // 4. Форматы, которые нельзя воспроизвести из uintptr_t
+    LOG_WARN("temp %.1f", 21.5);
+    LOG_WARN("uptime %llu us", (unsigned long long)5000000000ull);
+    LOG_WARN("ok %5lu%%", (unsigned long)42);
+    capture_begin();
+    uint32_t n5 = display_log_drain(0);
+    out = capture_end();
+    if (n5 != 3 || !strstr(out, "unsupported log format: temp %.1f\n") ||
+        !strstr(out, "unsupported log format: uptime %llu us\n") || !strstr(out, "ok    42%\n")) {
+        printf("FAIL unsupported formats: n5=%lu output:\n%s", (unsigned long)n5, out);
+        failures++;
+    }
+    free(out);
+
+    printf("records %lu, dropped %lu\n", (unsigned long)(st.written), (unsigned long)st.dropped);
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,267 @@
+/**
+ * Host check: Morph schedule for every display_morph_order_t.
+ *
+ * Built with DISPLAY_RNG_FIXED_SEED = 0x5EED.
+ *
+ * Start 00 3F 06 FF, target FF 3F 00 0F on 4 digits: 14 changed bits
+ * (digit 0: all 8, digit 1: none, digit 2: bits 1-2, digit 3: bits 4-7), 28 steps.
+ *
+ * Scenario:
+ *   - display_fx_morph_ordered() started with each order and stopped
+ *   - RANDOM started twice, RNG reseeded in between
+ *   - SWEEP run to the end on virtual time
+ *
+ * Expected:
+ *   - every changed bit is scheduled exactly once
+ *   - flips are sorted by the order key (ties keep the left-to-right position):
+ *       SWEEP        digit * 8 + bit                   14 groups
+ *       PARALLEL     rank of the bit within its digit   8 groups
+ *       CENTER_OUT   |2 * digit - 3| * 8 + bit         10 groups
+ *       SEGMENT_PATH contour rank A-B-C-D-E-F-G-DP      8 groups
+ *   - flips with one key share a step, group g flips at 1 + g * steps / groups
+ *   - RANDOM: one flip per step, not the SWEEP order, repeats under the same seed
+ *   - during the run LL shows exactly the flips due by the current step,
+ *     at the end the content is the target
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "display_api.h"
+#include "display_fx.h"
+#include "display_state.h"
+#include "hardware/rtc.h"
+#include "sim.h"
+
+#define TEST_DATA_PIN    2
+#define TEST_CLOCK_PIN   3
+#define TEST_LATCH_PIN   4
+#define TEST_DIGITS      4
+#define TEST_REFRESH_HZ  100
+#define TEST_STEPS       28u
+#define TEST_DURATION_MS 280u
+#define TEST_FLIPS       14u
+#define TEST_LOOP_US     1000u
+
+static const vfd_segment_map_t k_start[TEST_DIGITS]  = { 0x00, 0x3F, 0x06, 0xFF };
+static const vfd_segment_map_t k_target[TEST_DIGITS] = { 0xFF, 0x3F, 0x00, 0x0F };
+
+// Ранг бита на контуре A-B-C-D-E-F-G-DP (бит 0 — C, 1 — B, 2 — G, 6 — A)
+static const uint8_t k_path_rank[8] = { 2, 1, 6, 3, 4, 5, 0, 7 };
+
+static const char *const k_names[] = { "SWEEP", "RANDOM", "CENTER_OUT", "PARALLEL", "SEGMENT_PATH" };
+
+static display_t *s_disp;
+
+// Стартовый контент, выведенный в LL до начала эффекта
+static void set_start(void)
+{
+    memcpy(display_content_buffer(), k_start, TEST_DIGITS);
+    display_process();
+}
+
+// Ключ порядка для позиции d * 8 + b (rank — номер бита среди измененных в разряде)
+static uint32_t order_key(display_morph_order_t order, uint8_t pos, uint8_t rank)
+{
+    uint8_t d = pos >> 3, b = pos & 7u;
+    switch (order) {
+        case DISPLAY_MORPH_PARALLEL:     return rank;
+        case DISPLAY_MORPH_SEGMENT_PATH: return k_path_rank[b];
+        case DISPLAY_MORPH_CENTER_OUT: {
+            int dist = 2 * (int)d - (TEST_DIGITS - 1);
+            return (uint32_t)(dist < 0 ? -dist : dist) * 8u + b;
+        }
+        default:                         return pos;
+    }
+}
+
+static int check_schedule(display_morph_order_t order, uint32_t groups_expected)
+{
+    const char *name = k_names[order];
+    uint8_t rank_of[TEST_DIGITS * 8];
+    uint8_t seen[TEST_DIGITS * 8] = { 0 };
+    uint32_t changed = 0;
+
+    for (uint8_t d = 0; d < TEST_DIGITS; d++) {
+        uint8_t rank = 0;
+        for (uint8_t b = 0; b < 8u; b++) {
+            if ((k_start[d] ^ k_target[d]) & (1u << b)) {
+                rank_of[d * 8u + b] = rank++;
+                changed++;
+            }
+        }
+    }
+    if (s_disp->fx_morph_flips != changed || changed != TEST_FLIPS) {
+        printf("FAIL %s: %u flips, expected %lu\n", name, (unsigned)s_disp->fx_morph_flips, (unsigned long)changed);
+        return 1;
+    }
+
+    // Каждый измененный бит — ровно один раз
+    for (uint8_t i = 0; i < TEST_FLIPS; i++) {
+        uint8_t pos = s_disp->fx_morph_order[i];
+        uint8_t d = pos >> 3;
+        if (d >= TEST_DIGITS || !((k_start[d] ^ k_target[d]) & (1u << (pos & 7u))) || seen[pos]++) {
+            printf("FAIL %s: flip %u at position %u is not a single changed bit\n", name, (unsigned)i,
+                   (unsigned)pos);
+            return 1;
+        }
+    }
+
+    // Группы: ключ и шаг
+    uint32_t groups = 1;
+    for (uint8_t i = 1; i < TEST_FLIPS; i++) {
+        uint8_t p0 = s_disp->fx_morph_order[i - 1u], p1 = s_disp->fx_morph_order[i];
+        bool same_step = s_disp->fx_morph_flip_step[i] == s_disp->fx_morph_flip_step[i - 1u];
+        if (order == DISPLAY_MORPH_RANDOM) {
+            if (same_step) {
+                printf("FAIL %s: flips %u and %u share a step\n", name, (unsigned)(i - 1u), (unsigned)i);
+                return 1;
+            }
+            groups++;
+            continue;
+        }
+        uint32_t k0 = order_key(order, p0, rank_of[p0]), k1 = order_key(order, p1, rank_of[p1]);
+        if (k1 < k0 || (k1 == k0 && p1 < p0)) {
+            printf("FAIL %s: flip %u (pos %u, key %lu) after pos %u, key %lu\n", name, (unsigned)i, (unsigned)p1,
+                   (unsigned long)k1, (unsigned)p0, (unsigned long)k0);
+            return 1;
+        }
+        if (same_step != (k0 == k1)) {
+            printf("FAIL %s: flips %u and %u: keys %lu/%lu, steps %u/%u\n", name, (unsigned)(i - 1u), (unsigned)i,
+                   (unsigned long)k0, (unsigned long)k1, (unsigned)s_disp->fx_morph_flip_step[i - 1u],
+                   (unsigned)s_disp->fx_morph_flip_step[i]);
+            return 1;
+        }
+        if (k1 != k0) groups++;
+    }
+    if (groups != groups_expected) {
+        printf("FAIL %s: %lu groups, expected %lu\n", name, (unsigned long)groups, (unsigned long)groups_expected);
+        return 1;
+    }
+
+    // Равномерное распределение групп по шагам 1..steps
+    uint32_t group = 0;
+    for (uint8_t i = 0; i < TEST_FLIPS; i++) {
+        if (i > 0 && s_disp->fx_morph_flip_step[i] != s_disp->fx_morph_flip_step[i - 1u]) group++;
+        uint32_t expect = 1u + group * TEST_STEPS / groups;
+        if (s_disp->fx_morph_flip_step[i] != expect) {
+            printf("FAIL %s: flip %u at step %u, expected %lu\n", name, (unsigned)i,
+                   (unsigned)s_disp->fx_morph_flip_step[i], (unsigned long)expect);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static bool start(display_morph_order_t order)
+{
+    display_fx_stop();
+    set_start();
+    return display_fx_morph_ordered(TEST_DURATION_MS, k_target, TEST_STEPS, order);
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    sim_reset();
+    sim_set_bus(TEST_CLOCK_PIN, TEST_LATCH_PIN);
+    datetime_t noon = { .year = 2024, .month = 6, .day = 1, .dotw = 6, .hour = 12, .min = 0, .sec = 0 };
+    rtc_set_datetime(&noon);
+
+    display_ll_config_t cfg = {
+        .data_pin = TEST_DATA_PIN,
+        .clock_pin = TEST_CLOCK_PIN,
+        .latch_pin = TEST_LATCH_PIN,
+        .digit_count = TEST_DIGITS,
+        .refresh_rate_hz = TEST_REFRESH_HZ,
+    };
+    display_init_ex(&cfg);
+    s_disp = display_current();
+    if (!s_disp->initialized) {
+        printf("FAIL init\n");
+        return 1;
+    }
+
+    // 1. Расписание для каждого порядка
+    static const struct {
+        display_morph_order_t order;
+        uint32_t groups;
+    } k_cases[] = {
+        { DISPLAY_MORPH_SWEEP, 14 },
+        { DISPLAY_MORPH_PARALLEL, 8 },
+        { DISPLAY_MORPH_CENTER_OUT, 10 },
+        { DISPLAY_MORPH_SEGMENT_PATH, 8 },
+        { DISPLAY_MORPH_RANDOM, 14 },
+    };
+    uint8_t sweep[TEST_FLIPS];
+    for (uint32_t i = 0; i < sizeof(k_cases) / sizeof(k_cases[0]); i++) {
+        if (!start(k_cases[i].order)) {
+            printf("FAIL %s: not started\n", k_names[k_cases[i].order]);
+            failures++;
+            continue;
+        }
+        failures += check_schedule(k_cases[i].order, k_cases[i].groups);
+        if (k_cases[i].order == DISPLAY_MORPH_SWEEP) memcpy(sweep, s_disp->fx_morph_order, TEST_FLIPS);
+    }
+
+    // 2. RANDOM: не порядок SWEEP, повторяется при том же seed
+    uint8_t random[TEST_FLIPS];
+    s_disp->fx_rng_seeded = false;
+    start(DISPLAY_MORPH_RANDOM);
+    memcpy(random, s_disp->fx_morph_order, TEST_FLIPS);
+    s_disp->fx_rng_seeded = false;
+    start(DISPLAY_MORPH_RANDOM);
+    if (memcmp(random, sweep, TEST_FLIPS) == 0 || memcmp(random, s_disp->fx_morph_order, TEST_FLIPS) != 0) {
+        printf("FAIL RANDOM: sweep order=%d, reproducible=%d\n", memcmp(random, sweep, TEST_FLIPS) == 0,
+               memcmp(random, s_disp->fx_morph_order, TEST_FLIPS) == 0);
+        failures++;
+    }
+
+    // 3. Прогон SWEEP: в LL ровно переключения, наступившие к текущему шагу
+    if (!start(DISPLAY_MORPH_SWEEP)) {
+        printf("FAIL SWEEP run: not started\n");
+        failures++;
+    }
+    uint64_t now_us = 0;
+    uint64_t end_us = (uint64_t)(TEST_DURATION_MS + 50u) * 1000u;
+    while (s_disp->fx_active && now_us < end_us) {
+        now_us += TEST_LOOP_US;
+        sim_run_until(now_us);
+        display_process();
+        if (!s_disp->fx_active) break;
+
+        uint32_t step = s_disp->fx_morph_step;
+        uint8_t applied = s_disp->fx_morph_applied;
+        vfd_segment_map_t expect[TEST_DIGITS];
+        memcpy(expect, k_start, TEST_DIGITS);
+        for (uint8_t i = 0; i < applied; i++) {
+            uint8_t pos = s_disp->fx_morph_order[i];
+            expect[pos >> 3] ^= (vfd_segment_map_t)(1u << (pos & 7u));
+        }
+        bool due_ok = (applied == 0 || s_disp->fx_morph_flip_step[applied - 1u] <= step) &&
+                      (applied == TEST_FLIPS || s_disp->fx_morph_flip_step[applied] > step);
+        if (!due_ok || memcmp(display_ll_get_buffer(), expect, TEST_DIGITS) != 0) {
+            printf("FAIL SWEEP run @%llu us: step %lu, %u flips applied, LL %s\n", (unsigned long long)now_us,
+                   (unsigned long)step, (unsigned)applied,
+                   memcmp(display_ll_get_buffer(), expect, TEST_DIGITS) ? "differs" : "ok");
+            failures++;
+            break;
+        }
+    }
+    sim_run_until(now_us + TEST_LOOP_US);
+    display_process();
+    if (s_disp->fx_active || memcmp(display_content_buffer(), k_target, TEST_DIGITS) != 0 ||
+        memcmp(display_ll_get_buffer(), k_target, TEST_DIGITS) != 0) {
+        printf("FAIL SWEEP run: active=%d, content %s target\n", s_disp->fx_active,
+               memcmp(display_content_buffer(), k_target, TEST_DIGITS) ? "is not" : "is");
+        failures++;
+    }
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,221 @@
+/**
+ * Host check: overlay registry (display_overlay.h) on virtual time.
+ *
+ * Scenario:
+ *   1. LOW (priority 30, frames 01/02/04 of 100 ms) starts at 0 ms;
+ *      HIGH (priority 200, one 100 ms frame 40) is requested at 150 ms
+ *   2. BLOCK (priority 200, 100 ms) plays while Q1 (50), Q2 (100), Q3 (50)
+ *      and Q4 (200) are requested in that order, then a fifth request
+ *
+ * Expected:
+ *   1. HIGH preempts at once; LOW resumes at 250 ms on frame 02 for the 50 ms
+ *      it had left, then shows 04 and ends at 400 ms
+ *      - HIGH stats: actual 100 ms, suspended 0
+ *      - LOW stats: requested 300, actual 300 (preemption excluded), suspended 100
+ *      - content is back on LL once both are over
+ *   2. equal priority does not preempt; with the queue full (4) the fifth
+ *      request is refused; play order BLOCK, Q4, Q2, Q1, Q3 (priority, then FIFO)
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "display_api.h"
+#include "display_overlay.h"
+#include "display_state.h"
+#include "hardware/rtc.h"
+#include "sim.h"
+
+#define TEST_DATA_PIN    2
+#define TEST_CLOCK_PIN   3
+#define TEST_LATCH_PIN   4
+#define TEST_DIGITS      4
+#define TEST_REFRESH_HZ  100
+#define TEST_LOOP_US     1000u
+#define TEST_MAX_SEQ     8u
+
+static const uint8_t k_low_data[] = {
+    ANIM_FILL(0x01), ANIM_SHOW(100),
+    ANIM_FILL(0x02), ANIM_SHOW(100),
+    ANIM_FILL(0x04), ANIM_SHOW(100),
+    ANIM_END()
+};
+static const uint8_t k_high_data[]  = { ANIM_FILL(0x40), ANIM_SHOW(100), ANIM_END() };
+static const uint8_t k_block_data[] = { ANIM_FILL(0x7F), ANIM_SHOW(100), ANIM_END() };
+static const uint8_t k_q1_data[]    = { ANIM_FILL(0x08), ANIM_SHOW(20), ANIM_END() };
+static const uint8_t k_q2_data[]    = { ANIM_FILL(0x10), ANIM_SHOW(20), ANIM_END() };
+static const uint8_t k_q3_data[]    = { ANIM_FILL(0x20), ANIM_SHOW(20), ANIM_END() };
+static const uint8_t k_q4_data[]    = { ANIM_FILL(0x3F), ANIM_SHOW(20), ANIM_END() };
+
+static const display_anim_t k_low   = { k_low_data,   sizeof(k_low_data),   1 };
+static const display_anim_t k_high  = { k_high_data,  sizeof(k_high_data),  1 };
+static const display_anim_t k_block = { k_block_data, sizeof(k_block_data), 1 };
+static const display_anim_t k_q1    = { k_q1_data,    sizeof(k_q1_data),    1 };
+static const display_anim_t k_q2    = { k_q2_data,    sizeof(k_q2_data),    1 };
+static const display_anim_t k_q3    = { k_q3_data,    sizeof(k_q3_data),    1 };
+static const display_anim_t k_q4    = { k_q4_data,    sizeof(k_q4_data),    1 };
+
+static display_t *s_disp;
+static uint64_t s_now_us;
+
+// Последовательность показанных анимаций (возобновление — новая запись)
+static const display_anim_t *s_seq[TEST_MAX_SEQ];
+static uint32_t s_seq_len;
+static display_overlay_stats_t s_done[TEST_MAX_SEQ];
+static uint32_t s_done_len;
+
+static void on_ov_done(overlay_type_t type)
+{
+    (void)type;
+    if (s_done_len < TEST_MAX_SEQ) display_overlay_get_last_stats(&s_done[s_done_len++]);
+}
+
+static void run_to(uint32_t ms)
+{
+    while (s_now_us < (uint64_t)ms * 1000u) {
+        s_now_us += TEST_LOOP_US;
+        sim_run_until(s_now_us);
+        display_process();
+
+        const display_anim_t *anim = s_disp->ov_active ? s_disp->ov_player.anim : NULL;
+        if (anim && (s_seq_len == 0 || s_seq[s_seq_len - 1u] != anim) && s_seq_len < TEST_MAX_SEQ) {
+            s_seq[s_seq_len++] = anim;
+        }
+    }
+}
+
+static int check_ll(const char *when, vfd_segment_map_t seg)
+{
+    const vfd_segment_map_t *buf = display_ll_get_buffer();
+    for (uint8_t i = 0; i < TEST_DIGITS; i++) {
+        if (buf[i] != seg) {
+            printf("FAIL %s: digit %u shows %02X, expected %02X\n", when, (unsigned)i, (unsigned)buf[i],
+                   (unsigned)seg);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int check_seq(const char *name, const display_anim_t *const *expect, uint32_t n)
+{
+    if (s_seq_len != n) {
+        printf("FAIL %s: %lu overlays played, expected %lu\n", name, (unsigned long)s_seq_len, (unsigned long)n);
+        return 1;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        if (s_seq[i] != expect[i]) {
+            printf("FAIL %s: overlay %lu out of order\n", name, (unsigned long)i);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int check_stats(const char *name, const display_overlay_stats_t *st, uint32_t requested, uint32_t actual,
+                       uint32_t suspended)
+{
+    // Допуск — шаг главного цикла
+    if (st->requested_ms != requested || st->actual_ms < actual || st->actual_ms > actual + 1u ||
+        st->suspended_ms < suspended || st->suspended_ms > suspended + 1u) {
+        printf("FAIL %s stats: requested %lu, actual %lu, suspended %lu (expected %lu, %lu, %lu)\n", name,
+               (unsigned long)st->requested_ms, (unsigned long)st->actual_ms, (unsigned long)st->suspended_ms,
+               (unsigned long)requested, (unsigned long)actual, (unsigned long)suspended);
+        return 1;
+    }
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    sim_reset();
+    sim_set_bus(TEST_CLOCK_PIN, TEST_LATCH_PIN);
+    datetime_t noon = { .year = 2024, .month = 6, .day = 1, .dotw = 6, .hour = 12, .min = 0, .sec = 0 };
+    rtc_set_datetime(&noon);
+
+    display_ll_config_t cfg = {
+        .data_pin = TEST_DATA_PIN,
+        .clock_pin = TEST_CLOCK_PIN,
+        .latch_pin = TEST_LATCH_PIN,
+        .digit_count = TEST_DIGITS,
+        .refresh_rate_hz = TEST_REFRESH_HZ,
+    };
+    display_init_ex(&cfg);
+    s_disp = display_current();
+    if (!s_disp->initialized) {
+        printf("FAIL init\n");
+        return 1;
+    }
+    s_disp->on_overlay_finished = on_ov_done;
+
+    display_show_number(1234);
+    display_process();
+    vfd_segment_map_t content[TEST_DIGITS];
+    memcpy(content, display_ll_get_buffer(), TEST_DIGITS);
+
+    // 1. Вытеснение и возобновление
+    display_overlay_play_prio(&k_low, 0, 30);
+    run_to(150);
+    failures += check_ll("LOW @150", 0x02);
+    if (!display_overlay_play_prio(&k_high, 0, DISPLAY_OVERLAY_PRIO_ALARM) || display_overlay_pending() != 1) {
+        printf("FAIL HIGH did not preempt (pending %u)\n", (unsigned)display_overlay_pending());
+        failures++;
+    }
+    run_to(200);
+    failures += check_ll("HIGH @200", 0x40);
+    run_to(260);
+    failures += check_ll("LOW resumed @260", 0x02);
+    run_to(320);
+    failures += check_ll("LOW @320", 0x04);
+    run_to(410);
+    if (s_disp->ov_active || memcmp(display_ll_get_buffer(), content, TEST_DIGITS) != 0) {
+        printf("FAIL content not restored after LOW (active=%d)\n", s_disp->ov_active);
+        failures++;
+    }
+
+    static const display_anim_t *const k_seq_preempt[] = { &k_low, &k_high, &k_low };
+    failures += check_seq("preemption", k_seq_preempt, 3);
+    if (s_done_len != 2) {
+        printf("FAIL %lu overlays finished, expected 2\n", (unsigned long)s_done_len);
+        failures++;
+    } else {
+        failures += check_stats("HIGH", &s_done[0], 100, 100, 0);
+        failures += check_stats("LOW", &s_done[1], 300, 300, 100);
+    }
+
+    // 2. Очередь: приоритет, затем FIFO; равный приоритет не вытесняет
+    s_seq_len = 0;
+    s_done_len = 0;
+    uint32_t t0 = (uint32_t)(s_now_us / 1000u);
+    bool ok = display_overlay_play_prio(&k_block, 0, DISPLAY_OVERLAY_PRIO_ALARM);
+    ok = display_overlay_play_prio(&k_q1, 0, 50) && ok;
+    ok = display_overlay_play_prio(&k_q2, 0, 100) && ok;
+    ok = display_overlay_play_prio(&k_q3, 0, 50) && ok;
+    ok = display_overlay_play_prio(&k_q4, 0, DISPLAY_OVERLAY_PRIO_ALARM) && ok;
+    if (!ok || s_disp->ov_stack_len != 0 || display_overlay_pending() != DISPLAY_OVERLAY_QUEUE_LEN) {
+        printf("FAIL queue: accepted=%d, suspended %u, pending %u\n", ok, (unsigned)s_disp->ov_stack_len,
+               (unsigned)display_overlay_pending());
+        failures++;
+    }
+    if (display_overlay_play_prio(&k_q1, 0, 50)) {
+        printf("FAIL request accepted with the queue full\n");
+        failures++;
+    }
+    run_to(t0 + 300u);
+
+    static const display_anim_t *const k_seq_queue[] = { &k_block, &k_q4, &k_q2, &k_q1, &k_q3 };
+    failures += check_seq("queue", k_seq_queue, 5);
+    if (s_done_len != 5 || s_disp->ov_active || memcmp(display_ll_get_buffer(), content, TEST_DIGITS) != 0) {
+        printf("FAIL queue drain: %lu finished, active=%d\n", (unsigned long)s_done_len, s_disp->ov_active);
+        failures++;
+    }
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
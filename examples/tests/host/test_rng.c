@@ -0,0 +1,147 @@
+/**
+ * Host check: RNG streams (display_rng.h).
+ *
+ * Built with DISPLAY_RNG_FIXED_SEED = 0x5EED.
+ *
+ * Scenario:
+ *   - display_rng_seed_from_hw() twice, streams initialised after each seed
+ *   - streams drawn interleaved and one at a time
+ *   - display_rng_stream_range() with limit 3 * 2^30, where x % limit would put
+ *     twice as many values into [0, 2^30) as into the rest, and with limit 6
+ *   - shuffle of 0..79
+ *
+ * Expected:
+ *   - the hardware seed is the fixed one and every sequence repeats exactly
+ *   - different stream ids give different sequences, drawing from one stream
+ *     does not shift another; fill() matches next()
+ *   - range results stay below the limit and are uniform within 2 %
+ *   - shuffle is a permutation and is reproducible
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "display_rng.h"
+
+#define TEST_SEQ_LEN     64u
+#define TEST_SAMPLES     300000u
+#define TEST_BIG_LIMIT   0xC0000000u   // 3 * 2^30
+#define TEST_SMALL_LIMIT 6u
+#define TEST_ITEMS       80u
+
+static void draw(display_rng_stream_t *s, uint32_t *out, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) out[i] = display_rng_stream_next(s);
+}
+
+int main(void)
+{
+    int failures = 0;
+    static uint32_t a[TEST_SEQ_LEN], b[TEST_SEQ_LEN], c[TEST_SEQ_LEN], d[TEST_SEQ_LEN];
+
+    // 1. Фиксированный seed вместо аппаратной энтропии
+    display_rng_seed(0x5EED);
+    for (uint32_t i = 0; i < TEST_SEQ_LEN; i++) a[i] = display_rng_next();
+    display_rng_seed_from_hw();
+    for (uint32_t i = 0; i < TEST_SEQ_LEN; i++) b[i] = display_rng_next();
+    if (memcmp(a, b, sizeof(a)) != 0) {
+        printf("FAIL display_rng_seed_from_hw() does not use DISPLAY_RNG_FIXED_SEED\n");
+        failures++;
+    }
+
+    // 2. Потоки: воспроизводимы, различны, не влияют друг на друга
+    display_rng_stream_t s0, s1;
+    display_rng_seed_from_hw();
+    display_rng_stream_init(&s0, 0);
+    display_rng_stream_init(&s1, 1);
+    draw(&s0, a, TEST_SEQ_LEN);
+    draw(&s1, b, TEST_SEQ_LEN);
+
+    display_rng_seed_from_hw();
+    display_rng_stream_init(&s0, 0);
+    display_rng_stream_init(&s1, 1);
+    for (uint32_t i = 0; i < TEST_SEQ_LEN; i++) {
+        c[i] = display_rng_stream_next(&s0);
+        d[i] = display_rng_stream_next(&s1);
+        (void)display_rng_next();   // Общий генератор потоки не сдвигает
+    }
+    if (memcmp(a, c, sizeof(a)) != 0 || memcmp(b, d, sizeof(b)) != 0) {
+        printf("FAIL stream sequences depend on draw order\n");
+        failures++;
+    }
+    if (memcmp(a, b, sizeof(a)) == 0) {
+        printf("FAIL streams 0 and 1 are identical\n");
+        failures++;
+    }
+
+    display_rng_stream_init(&s0, 0);
+    display_rng_stream_fill(&s0, c, TEST_SEQ_LEN);
+    if (memcmp(a, c, sizeof(a)) != 0) {
+        printf("FAIL fill() differs from next()\n");
+        failures++;
+    }
+
+    // 3. Диапазон без смещения: x % limit дал бы 1/2 вместо 1/3
+    display_rng_stream_init(&s0, 2);
+    uint32_t low = 0, over = 0;
+    for (uint32_t i = 0; i < TEST_SAMPLES; i++) {
+        uint32_t v = display_rng_stream_range(&s0, TEST_BIG_LIMIT);
+        if (v >= TEST_BIG_LIMIT) over++;
+        if (v < 0x40000000u) low++;
+    }
+    uint32_t expect = TEST_SAMPLES / 3u;
+    if (over != 0 || low < expect - expect / 50u || low > expect + expect / 50u) {
+        printf("FAIL range(3 * 2^30): %lu of %lu below 2^30 (expected ~%lu), %lu out of range\n",
+               (unsigned long)low, (unsigned long)TEST_SAMPLES, (unsigned long)expect, (unsigned long)over);
+        failures++;
+    }
+
+    uint32_t bucket[TEST_SMALL_LIMIT] = { 0 };
+    over = 0;
+    for (uint32_t i = 0; i < TEST_SAMPLES; i++) {
+        uint32_t v = display_rng_stream_range(&s0, TEST_SMALL_LIMIT);
+        if (v < TEST_SMALL_LIMIT) bucket[v]++;
+        else over++;
+    }
+    expect = TEST_SAMPLES / TEST_SMALL_LIMIT;
+    for (uint32_t i = 0; i < TEST_SMALL_LIMIT; i++) {
+        if (bucket[i] < expect - expect / 50u || bucket[i] > expect + expect / 50u) {
+            printf("FAIL range(6): value %lu drawn %lu times (expected ~%lu)\n", (unsigned long)i,
+                   (unsigned long)bucket[i], (unsigned long)expect);
+            failures++;
+        }
+    }
+    if (over != 0 || display_rng_stream_range(&s0, 0) != 0 || display_rng_stream_range(&s0, 1) != 0) {
+        printf("FAIL range edge cases (%lu out of range)\n", (unsigned long)over);
+        failures++;
+    }
+
+    // 4. Перемешивание: перестановка, повторяется при том же seed
+    uint8_t items[TEST_ITEMS], again[TEST_ITEMS];
+    for (uint32_t i = 0; i < TEST_ITEMS; i++) items[i] = again[i] = (uint8_t)i;
+    display_rng_stream_init(&s0, 3);
+    display_rng_stream_shuffle(&s0, items, TEST_ITEMS);
+    display_rng_stream_init(&s0, 3);
+    display_rng_stream_shuffle(&s0, again, TEST_ITEMS);
+
+    uint8_t seen[TEST_ITEMS] = { 0 };
+    uint32_t moved = 0;
+    for (uint32_t i = 0; i < TEST_ITEMS; i++) {
+        if (items[i] < TEST_ITEMS) seen[items[i]]++;
+        if (items[i] != i) moved++;
+    }
+    bool permutation = true;
+    for (uint32_t i = 0; i < TEST_ITEMS; i++) permutation = permutation && seen[i] == 1;
+    if (!permutation || moved < TEST_ITEMS / 2u || memcmp(items, again, sizeof(items)) != 0) {
+        printf("FAIL shuffle: permutation=%d moved=%lu reproducible=%d\n", permutation, (unsigned long)moved,
+               memcmp(items, again, sizeof(items)) == 0);
+        failures++;
+    }
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
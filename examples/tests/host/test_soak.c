@@ -0,0 +1,408 @@
+/**
+ * Host soak: HL core, FX, overlays and brightness on virtual time.
+ *
+ *   test_soak [hours] [seed]      (default: 24 hours, seed 1)
+ *
+ * Scenario:
+ *   - the main loop calls display_process() every SOAK_LOOP_US of virtual time,
+ *     LL refresh runs on the simulated hardware alarm
+ *   - RTC starts at 12:00 with night mode on: a full day has two night transitions
+ *   - random actions every 20 ms .. 3 s: all built-in FX, overlays of every
+ *     priority (preemption, queue, overflow), FX/overlay stops, content and dot
+ *     changes, user brightness, short auto-brightness phases with a changing light
+ *
+ * Expected (checked after every display_process):
+ *   - idle (no FX, no overlay): LL frame is the content with dots, LL brightness
+ *     of every digit is the core base level
+ *   - fx_active / ov_active clear within the requested duration (plus slack),
+ *     never both at once; stops take effect immediately
+ *   - every accepted FX ends with one on_effect_finished; every accepted overlay
+ *     ends with one on_overlay_finished unless cancelled by display_overlay_stop()
+ *   - a finished overlay reports actual_ms close to requested_ms, preemption excluded
+ *   - night mode: once the ramp is over, the base level follows the RTC hour
+ *
+ * Reports simulated frames (display_process calls) per wall-clock second.
+ * The first failure dumps the event trace (convert with tools/vfd_trace.py).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "display_api.h"
+#include "display_fx.h"
+#include "display_overlay.h"
+#include "display_trace.h"
+#include "logging.h"
+#include "hardware/rtc.h"
+#include "sim.h"
+
+#define TEST_DATA_PIN       2
+#define TEST_CLOCK_PIN      3
+#define TEST_LATCH_PIN      4
+#define TEST_DIGITS         4
+#define TEST_REFRESH_HZ     100
+
+#define SOAK_DEFAULT_HOURS  24u
+#define SOAK_LOOP_US        1000u                  // Период главного цикла
+#define SOAK_FX_SLACK_MS    100u                   // Запас на кадр эффекта и шаг цикла
+#define SOAK_OV_SLACK_MS    200u
+#define SOAK_SETTLE_MS      3000u                  // Период обновления яркости + запас
+#define SOAK_MAX_FAILURES   20
+
+#define US_PER_HOUR         3600000000ull
+
+static const vfd_segment_map_t k_target[TEST_DIGITS] = { 0x3F, 0x06, 0x5B, 0x4F };
+
+// Оверлей приложения: кадры с яркостью — проверка восстановления базового уровня
+static const uint8_t k_alert_data[] = {
+    ANIM_FILL(0x7F), ANIM_BRIGHT(255), ANIM_SHOW(100),
+    ANIM_CLEAR(),    ANIM_BRIGHT(40),  ANIM_SHOW(100),
+    ANIM_END()
+};
+static const display_anim_t k_alert = { k_alert_data, sizeof(k_alert_data), 3 };
+
+static const uint8_t k_prio[] = {
+    DISPLAY_OVERLAY_PRIO_BOOT, DISPLAY_OVERLAY_PRIO_STATUS,
+    DISPLAY_OVERLAY_PRIO_DEFAULT, DISPLAY_OVERLAY_PRIO_ALARM,
+};
+
+typedef struct {
+    uint64_t frames;
+    uint32_t fx_started, fx_finished;
+    uint32_t ov_accepted, ov_finished, ov_cancelled, ov_rejected;
+    uint32_t night_flips, night_verified;
+    uint32_t idle_checks;
+} soak_stats_t;
+
+static soak_stats_t s_st;
+static uint32_t     s_rng;
+static int          s_failures;
+
+static uint64_t s_now_us;
+static uint64_t s_fx_deadline_us;       // Граница завершения принятого эффекта
+static uint64_t s_ov_deadline_us;       // Конец всей цепочки оверлеев
+static uint64_t s_settle_from_us;       // Последнее событие, после которого яркость может отставать
+static uint64_t s_auto_until_us;        // Конец фазы автояркости (0 = ночной режим)
+static bool     s_content_dirty;        // Контент менялся под эффектом или оверлеем
+static bool     s_pending_flip;
+static bool     s_was_night;
+
+static uint32_t soak_rand(void)
+{
+    // xorshift32: поток действий не зависит от RNG библиотеки
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+static uint32_t soak_range(uint32_t lo, uint32_t hi) { return lo + soak_rand() % (hi - lo + 1u); }
+
+static void on_fx_done(fx_type_t type) { (void)type; s_st.fx_finished++; }
+static void fail(const char *what, unsigned long a, unsigned long b)
+{
+    printf("FAIL t=%.3f s: %s (%lu, %lu)\n", (double)s_now_us / 1e6, what, a, b);
+    if (s_failures++ == 0) display_trace_dump();
+}
+
+static void on_ov_done(overlay_type_t type)
+{
+    (void)type;
+    s_st.ov_finished++;
+
+    // Главный цикл не перегружен: фактическая длительность без времени вытеснения близка к запрошенной
+    display_overlay_stats_t st;
+    display_overlay_get_last_stats(&st);
+    if (st.requested_ms && st.actual_ms > st.requested_ms + st.requested_ms / 8u + SOAK_OV_SLACK_MS) {
+        fail("overlay actual_ms (actual, requested)", st.actual_ms, st.requested_ms);
+    }
+}
+
+static bool rtc_is_night(uint32_t *sec_of_day)
+{
+    display_t *d = display_current();
+    datetime_t dt;
+    rtc_get_datetime(&dt);
+    *sec_of_day = (uint32_t)dt.hour * 3600u + (uint32_t)dt.min * 60u + (uint32_t)dt.sec;
+    uint8_t start = d->night_start_hour, end = d->night_end_hour;
+    return (start < end) ? (dt.hour >= start && dt.hour < end) : (dt.hour >= start || dt.hour < end);
+}
+
+// ============================================================================
+//  ДЕЙСТВИЯ
+// ============================================================================
+
+static void soak_fx_accepted(bool ok, uint32_t duration_ms)
+{
+    if (!ok) return;
+    s_st.fx_started++;
+    s_fx_deadline_us = s_now_us + (uint64_t)(duration_ms + SOAK_FX_SLACK_MS) * 1000u;
+}
+
+static void soak_ov_accepted(bool ok, uint32_t duration_ms)
+{
+    if (!ok) {
+        s_st.ov_rejected++;
+        return;
+    }
+    s_st.ov_accepted++;
+    // Цепочка выполняется последовательно: граница — сумма длительностей
+    uint64_t from = s_ov_deadline_us > s_now_us ? s_ov_deadline_us : s_now_us;
+    s_ov_deadline_us = from + (uint64_t)(duration_ms + duration_ms / 8u + SOAK_OV_SLACK_MS) * 1000u;
+}
+
+static void soak_start_fx(void)
+{
+    uint32_t ms = soak_range(200, 4000);
+    bool ok;
+    switch (soak_range(0, 13)) {
+        case 0:  ok = display_fx_fade_in(ms); break;
+        case 1:  ok = display_fx_fade_out(ms); break;
+        case 2:  ok = display_fx_pulse(ms); break;
+        case 3:  ok = display_fx_wave(ms); break;
+        case 4:  ok = display_fx_glitch(ms); break;
+        case 5:  ok = display_fx_matrix(ms, soak_range(20, 120)); break;
+        case 6:  ok = display_fx_morph(ms, k_target, soak_range(4, 40)); break;
+        case 7:  ok = display_fx_dissolve(ms); break;
+        case 8:  ok = display_fx_assemble(ms); break;
+        case 9:  ok = display_fx_slot_machine(ms, k_target, soak_range(30, 100)); break;
+        case 10: ok = display_fx_decode(ms, k_target); break;
+        case 11: ok = display_fx_pingpong(ms, k_target, (uint8_t)soak_range(1, 3)); break;
+        case 12: ok = display_fx_marquee("soak test", soak_range(50, 300)); break;
+        default: ok = display_fx_slide_in("12", soak_range(50, 300)); break;
+    }
+    // Бегущая строка и въезд: длительность считает эффект
+    if (ok) ms = display_current()->fx_duration_ms;
+    soak_fx_accepted(ok, ms);
+}
+
+static void soak_start_overlay(void)
+{
+    uint32_t ms = soak_range(300, 3000);
+    switch (soak_range(0, 3)) {
+        case 0:  soak_ov_accepted(display_overlay_boot(ms), ms); break;
+        case 1:  soak_ov_accepted(display_overlay_wifi(ms), ms); break;
+        case 2:  soak_ov_accepted(display_overlay_ntp(ms), ms); break;
+        default: {
+            uint8_t prio = k_prio[soak_range(0, sizeof(k_prio) - 1u)];
+            bool ok = display_overlay_play_prio(&k_alert, 0, prio);
+            soak_ov_accepted(ok, display_anim_duration_ms(&k_alert, 100));
+            break;
+        }
+    }
+}
+
+static void soak_set_content(void)
+{
+    switch (soak_range(0, 2)) {
+        case 0:  display_show_number((int32_t)soak_range(0, 9999)); break;
+        case 1:  display_show_time((uint8_t)soak_range(0, 23), (uint8_t)soak_range(0, 59), soak_rand() & 1u); break;
+        default: display_show_text((soak_rand() & 1u) ? "SOAK" : "-on-"); break;
+    }
+    if (display_is_effect_running() || display_is_overlay_running()) s_content_dirty = true;
+}
+
+static void soak_action(void)
+{
+    uint32_t r = soak_range(0, 99);
+
+    if (r < 30) {
+        soak_start_fx();
+    } else if (r < 55) {
+        soak_start_overlay();
+    } else if (r < 75) {
+        soak_set_content();
+    } else if (r < 80) {
+        display_fx_stop();
+        if (display_current()->fx_active) fail("fx_active after display_fx_stop", 0, 0);
+    } else if (r < 82) {
+        s_st.ov_cancelled += display_overlay_pending();
+        display_overlay_stop();
+        s_ov_deadline_us = 0;
+        if (display_current()->ov_active) fail("ov_active after display_overlay_stop", 0, 0);
+    } else if (r < 87) {
+        display_set_dots_config((uint16_t)soak_range(0, 0xF), soak_rand() & 1u);
+        if (display_is_effect_running() || display_is_overlay_running()) s_content_dirty = true;
+    } else if (r < 93) {
+        display_set_brightness((uint8_t)soak_range(20, 255));
+        s_settle_from_us = s_now_us;
+    } else if (r < 95 && s_auto_until_us == 0) {
+        // Короткая фаза автояркости, затем возврат к ночному режиму
+        sim_set_light((uint16_t)soak_range(256, 4095));
+        display_set_auto_brightness(true);
+        s_auto_until_us = s_now_us + (uint64_t)soak_range(10, 120) * 1000000u;
+        s_settle_from_us = s_now_us;
+    } else if (s_auto_until_us) {
+        sim_set_light((uint16_t)soak_range(256, 4095));
+    }
+}
+
+// ============================================================================
+//  ИНВАРИАНТЫ
+// ============================================================================
+
+static void soak_check(void)
+{
+    display_t *d = display_current();
+    display_ll_t *ll = &d->ll;
+
+    if (d->fx_active && d->ov_active) fail("fx_active and ov_active together", 0, 0);
+    if (d->fx_active && s_now_us > s_fx_deadline_us) {
+        fail("fx_active stuck (fx_type, duration_ms)", d->fx_type, d->fx_duration_ms);
+        display_fx_stop();
+    }
+    if (d->ov_active && s_now_us > s_ov_deadline_us) {
+        fail("ov_active stuck (ov_type, pending)", d->ov_type, display_overlay_pending());
+        s_st.ov_cancelled += display_overlay_pending();
+        display_overlay_stop();
+    }
+
+    // Каждый принятый запрос завершается ровно одним колбэком
+    uint32_t fx_open = d->fx_active ? 1u : 0u;
+    if (s_st.fx_started != s_st.fx_finished + fx_open) {
+        fail("FX callbacks (started, finished)", s_st.fx_started, s_st.fx_finished);
+        s_st.fx_finished = s_st.fx_started - fx_open;
+    }
+    uint32_t ov_open = (d->ov_active ? 1u : 0u) + display_overlay_pending();
+    if (s_st.ov_accepted != s_st.ov_finished + s_st.ov_cancelled + ov_open) {
+        fail("overlay callbacks (accepted, finished)", s_st.ov_accepted, s_st.ov_finished);
+        s_st.ov_finished = s_st.ov_accepted - s_st.ov_cancelled - ov_open;
+    }
+
+    if (d->ov_active) s_settle_from_us = s_now_us;   // Под оверлеем яркость не обновляется
+    if (d->fx_active || d->ov_active) return;
+
+    // Простой: контент с точками и базовая яркость
+    if (!s_content_dirty) {
+        s_st.idle_checks++;
+        for (uint8_t i = 0; i < TEST_DIGITS; i++) {
+            vfd_segment_map_t want = d->content_buffer[i];
+            if ((d->dot_map & (1u << i)) && (!d->dot_blink_enabled || d->dot_state)) {
+                want |= (vfd_segment_map_t)(1u << d->dot_bit);
+            }
+            if (ll->seg_buffer[i] != want) {
+                fail("content not restored (digit, segments)", i, ll->seg_buffer[i]);
+                break;
+            }
+            if (ll->brightness[i] != d->brightness_level) {
+                fail("brightness not at base (ll, base)", ll->brightness[i], d->brightness_level);
+                break;
+            }
+        }
+    }
+    s_content_dirty = false;
+
+    // Ночной режим: после перехода уровень соответствует часу RTC
+    uint32_t sod;
+    bool night = rtc_is_night(&sod);
+    if (night != s_was_night) {
+        s_was_night = night;
+        s_st.night_flips++;
+        s_pending_flip = true;
+    }
+    if (!d->night_mode_enabled || d->ramp_active) return;
+    if (s_now_us - s_settle_from_us < SOAK_SETTLE_MS * 1000ull) return;
+    if (sod % 3600u < SOAK_SETTLE_MS / 1000u) return;            // Час только что сменился
+
+    uint8_t want = night ? d->night_brightness : d->user_brightness_level;
+    if (d->brightness_level != want) {
+        fail("night mode level (level, expected)", d->brightness_level, want);
+        s_settle_from_us = s_now_us;
+    } else if (s_pending_flip) {
+        s_pending_flip = false;
+        s_st.night_verified++;
+    }
+}
+
+// ============================================================================
+//  MAIN
+// ============================================================================
+
+static double wall_s(void) { return (double)clock() / CLOCKS_PER_SEC; }
+
+int main(int argc, char **argv)
+{
+    uint32_t hours = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : SOAK_DEFAULT_HOURS;
+    s_rng = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 0) : 1u;
+    if (hours == 0) hours = 1;
+    if (s_rng == 0) s_rng = 1;
+    uint32_t seed = s_rng;
+
+    sim_reset();
+    sim_set_bus(TEST_CLOCK_PIN, TEST_LATCH_PIN);
+    datetime_t noon = { .year = 2024, .month = 6, .day = 1, .dotw = 6, .hour = 12, .min = 0, .sec = 0 };
+    rtc_set_datetime(&noon);
+
+    display_ll_config_t cfg = {
+        .data_pin = TEST_DATA_PIN,
+        .clock_pin = TEST_CLOCK_PIN,
+        .latch_pin = TEST_LATCH_PIN,
+        .digit_count = TEST_DIGITS,
+        .refresh_rate_hz = TEST_REFRESH_HZ,
+    };
+    display_init_ex(&cfg);
+    display_t *d = display_current();
+    if (!d->initialized) {
+        printf("FAIL init\n");
+        return 1;
+    }
+    d->on_effect_finished = on_fx_done;
+    d->on_overlay_finished = on_ov_done;
+    display_show_number(1234);
+    display_set_night_mode(true);
+    display_trace_clear();
+
+    uint64_t end_us = (uint64_t)hours * US_PER_HOUR;
+    uint64_t next_action_us = 0;
+    double t0 = wall_s();
+
+    while (s_now_us < end_us && s_failures < SOAK_MAX_FAILURES) {
+        s_now_us += SOAK_LOOP_US;
+        sim_run_until(s_now_us);
+
+        if (s_auto_until_us && s_now_us >= s_auto_until_us) {
+            s_auto_until_us = 0;
+            display_set_night_mode(true);
+            s_settle_from_us = s_now_us;
+        }
+        if (s_now_us >= next_action_us) {
+            soak_action();
+            next_action_us = s_now_us + (uint64_t)((soak_rand() & 3u) ? soak_range(20, 500) : soak_range(500, 3000)) * 1000u;
+        }
+
+        display_process();
+        s_st.frames++;
+        soak_check();
+
+        if ((s_st.frames & 0xFFFFu) == 0) display_log_drain(0);
+    }
+
+    double wall = wall_s() - t0;
+    display_log_drain(0);
+    display_ll_deinit();
+
+    double sim_s = (double)s_now_us / 1e6;
+    printf("seed %lu: %.1f h simulated in %.2f s, %.0f frames/s (x%.0f real time)\n",
+           (unsigned long)seed, sim_s / 3600.0, wall, wall > 0 ? (double)s_st.frames / wall : 0.0,
+           wall > 0 ? sim_s / wall : 0.0);
+    printf("fx %lu/%lu, overlays %lu finished %lu cancelled %lu rejected %lu, idle checks %lu, night %lu/%lu\n",
+           (unsigned long)s_st.fx_started, (unsigned long)s_st.fx_finished,
+           (unsigned long)s_st.ov_accepted, (unsigned long)s_st.ov_finished,
+           (unsigned long)s_st.ov_cancelled, (unsigned long)s_st.ov_rejected,
+           (unsigned long)s_st.idle_checks, (unsigned long)s_st.night_verified, (unsigned long)s_st.night_flips);
+
+    // Каждая смена дня и ночи подтверждена (последняя может прийтись на конец прогона)
+    if (s_st.night_verified + 1u < s_st.night_flips || (hours >= 24u && s_st.night_flips < 2u)) {
+        printf("FAIL night transitions verified %lu of %lu\n",
+               (unsigned long)s_st.night_verified, (unsigned long)s_st.night_flips);
+        s_failures++;
+    }
+    if (s_failures) {
+        printf("FAILED (%d)\n", s_failures);
+        return 1;
+    }
+    printf("PASS soak\n");
+    return 0;
+}
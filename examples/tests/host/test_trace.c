@@ -0,0 +1,152 @@
+/**
+ * Host check: event trace of LL frame commits (VFD_TRACE=1).
+ *
+ * Scenario:
+ *   - start refresh, publish a frame, republish the same frame, publish a new one
+ *   - application marks from the other core in between
+ *   - rewrite one digit unchanged, then change one digit via display_ll_set_digit_raw()
+ *   - record more events than the ring holds
+ *
+ * Expected:
+ *   - one LL_FRAME per changed frame (unchanged frames leave no event),
+ *     whichever setter wrote it
+ *   - each LL_FRAME followed by LL_VISIBLE with latency at most one slot period
+ *   - events of both cores come out in time order
+ *   - overflow keeps the newest events and counts the recorded and overwritten ones
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "display_ll.h"
+#include "display_trace.h"
+#include "sim.h"
+
+#define TEST_DATA_PIN    2
+#define TEST_CLOCK_PIN   3
+#define TEST_LATCH_PIN   4
+#define TEST_DIGITS      4
+#define TEST_REFRESH_HZ  100
+#define TEST_SLOT_US     (1000000u / (TEST_REFRESH_HZ * TEST_DIGITS))
+
+static const vfd_segment_map_t k_frame_a[TEST_DIGITS] = { 0x3F, 0x06, 0x5B, 0x4F };
+static const vfd_segment_map_t k_frame_b[TEST_DIGITS] = { 0x66, 0x6D, 0x7D, 0x07 };
+static const vfd_segment_map_t k_frame_c[TEST_DIGITS] = { 0x66, 0x6D, 0x79, 0x07 };  // b с другим разрядом 2
+
+static display_trace_event_t s_events[2u * VFD_TRACE_RING_LEN];
+
+int main(void)
+{
+    static display_ll_t ll;
+    int failures = 0;
+
+    sim_reset();
+    sim_set_bus(TEST_CLOCK_PIN, TEST_LATCH_PIN);
+    sim_watch_data(TEST_DATA_PIN);
+
+    display_ll_select(&ll);
+    display_ll_config_t cfg = {
+        .data_pin = TEST_DATA_PIN,
+        .clock_pin = TEST_CLOCK_PIN,
+        .latch_pin = TEST_LATCH_PIN,
+        .digit_count = TEST_DIGITS,
+        .refresh_rate_hz = TEST_REFRESH_HZ,
+    };
+    if (!display_ll_init(&cfg) || !display_ll_start_refresh()) {
+        printf("FAIL init\n");
+        return 1;
+    }
+    display_trace_clear();
+
+    // 1. Публикации кадров и отметки приложения с другого ядра
+    sim_run_until(1003);
+    display_ll_set_frame(k_frame_a, TEST_DIGITS);
+    sim_run_until(5000);
+    sim_set_core(1);
+    display_trace_mark(1, 0);
+    sim_set_core(0);
+    display_ll_set_frame(k_frame_a, TEST_DIGITS);       // Без изменений
+    sim_run_until(10001);
+    display_ll_set_frame(k_frame_b, TEST_DIGITS);
+    sim_set_core(1);
+    sim_run_until(15000);
+    display_trace_mark(2, 0);
+    sim_set_core(0);
+    sim_run_until(20000);
+
+    // Поразрядная запись (эффекты, восстановление снимка) идет тем же путем
+    display_ll_set_digit_raw(1, k_frame_b[1]);          // Без изменений
+    display_ll_set_digit_raw(2, k_frame_c[2]);
+    sim_run_until(25000);
+
+    uint32_t n = display_trace_read(s_events, 2u * VFD_TRACE_RING_LEN);
+    static const uint8_t expect[] = {
+        DISPLAY_TRACE_LL_FRAME, DISPLAY_TRACE_LL_VISIBLE, DISPLAY_TRACE_MARK,
+        DISPLAY_TRACE_LL_FRAME, DISPLAY_TRACE_LL_VISIBLE, DISPLAY_TRACE_MARK,
+        DISPLAY_TRACE_LL_FRAME, DISPLAY_TRACE_LL_VISIBLE,
+    };
+    if (n != sizeof(expect)) {
+        printf("FAIL %lu events, expected %u\n", (unsigned long)n, (unsigned)sizeof(expect));
+        failures++;
+    }
+    for (uint32_t i = 0; i < n && i < sizeof(expect); i++) {
+        const display_trace_event_t *e = &s_events[i];
+        if (e->event != expect[i]) {
+            printf("FAIL event %lu: %u, expected %u\n", (unsigned long)i, e->event, expect[i]);
+            failures++;
+            continue;
+        }
+        if (i > 0 && (int32_t)(e->t_us - s_events[i - 1u].t_us) < 0) {
+            printf("FAIL event %lu out of order\n", (unsigned long)i);
+            failures++;
+        }
+        if (e->event == DISPLAY_TRACE_LL_VISIBLE && (e->a == 0 || e->a > TEST_SLOT_US)) {
+            printf("FAIL visible latency %lu us, slot %u us\n", (unsigned long)e->a, TEST_SLOT_US);
+            failures++;
+        }
+        if (e->event == DISPLAY_TRACE_MARK && e->core != 1) {
+            printf("FAIL mark recorded on core %u\n", e->core);
+            failures++;
+        }
+        if (e->event != DISPLAY_TRACE_MARK && e->id != (uint32_t)(uintptr_t)&ll) {
+            printf("FAIL event %lu instance %08lx\n", (unsigned long)i, (unsigned long)e->id);
+            failures++;
+        }
+    }
+    if (n >= 4 && s_events[3].a != display_trace_pack(k_frame_b, TEST_DIGITS)) {
+        printf("FAIL frame payload %08lx\n", (unsigned long)s_events[3].a);
+        failures++;
+    }
+    if (n >= 7 && s_events[6].a != display_trace_pack(k_frame_c, TEST_DIGITS)) {
+        printf("FAIL digit payload %08lx\n", (unsigned long)s_events[6].a);
+        failures++;
+    }
+
+    // 2. Переполнение: остаются последние события
+    display_trace_clear();
+    for (uint32_t i = 0; i < VFD_TRACE_RING_LEN + 10u; i++) display_trace_mark(i, 0);
+    display_trace_stats_t st;
+    display_trace_get_stats(&st);
+    n = display_trace_read(s_events, 2u * VFD_TRACE_RING_LEN);
+    if (st.recorded != VFD_TRACE_RING_LEN + 10u || st.overwritten != 10 ||
+        n != VFD_TRACE_RING_LEN || s_events[0].a != 10 ||
+        s_events[n - 1u].a != VFD_TRACE_RING_LEN + 9u) {
+        printf("FAIL overflow: overwritten=%lu read=%lu first=%lu\n",
+               (unsigned long)st.overwritten, (unsigned long)n, (unsigned long)s_events[0].a);
+        failures++;
+    }
+
+    // 3. Выключенная запись
+    display_trace_enable(false);
+    display_ll_set_frame(k_frame_a, TEST_DIGITS);
+    sim_run_until(30000);
+    display_trace_enable(true);
+    if (display_trace_read(s_events, 2u * VFD_TRACE_RING_LEN) != 0) {
+        printf("FAIL events recorded while disabled\n");
+        failures++;
+    }
+
+    display_ll_deinit();
+    if (failures == 0) printf("PASS trace\n");
+    return failures ? 1 : 0;
+}
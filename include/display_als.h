@@ -0,0 +1,54 @@
+#ifndef DISPLAY_ALS_H
+#define DISPLAY_ALS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Модуль датчика освещенности (Ambient Light Sensor).
+ * АЦП работает в режиме free-running, отсчеты через FIFO и DMA складываются
+ * в кольцевой буфер. Главный цикл только забирает накопленные отсчеты
+ * (display_als_poll) и никогда не ждет АЦП.
+ *
+ * Внимание: пока модуль запущен, АЦП занят. Не вызывайте adc_read() в приложении.
+ */
+
+/* Конфигурация датчика. Нулевые поля заменяются значениями по умолчанию. */
+typedef struct {
+    uint16_t adc_pin;          // GPIO датчика (26..29)
+    uint16_t sample_rate_hz;   // Частота отсчетов (0 = 1000 Гц)
+    uint8_t  filter_shift;     // EMA: alpha = 1 / 2^shift (0 = 4)
+    uint8_t  hysteresis;       // Мин. изменение уровня для публикации (0 = 2)
+} display_als_config_t;
+
+/* Запуск фонового сбора отсчетов. Возвращает false, если нет свободного канала DMA. */
+bool display_als_start(const display_als_config_t *cfg);
+
+/* Остановка АЦП и освобождение канала DMA. */
+void display_als_stop(void);
+
+/* Проверка, запущен ли сбор отсчетов. */
+bool display_als_is_running(void);
+
+/*
+ * Обработка накопленных отсчетов (фильтр + гистерезис). Не блокирует.
+ * Возвращает true и записывает новый уровень (0..255) в *level,
+ * если отфильтрованный уровень сместился не меньше чем на гистерезис.
+ */
+bool display_als_poll(uint8_t *level);
+
+/* Последний опубликованный уровень (0..255). */
+uint8_t display_als_get_level(void);
+
+/* Отфильтрованное значение АЦП (12 бит). */
+uint16_t display_als_get_raw(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DISPLAY_ALS_H
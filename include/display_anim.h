@@ -0,0 +1,89 @@
+#ifndef DISPLAY_ANIM_H
+#define DISPLAY_ANIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "display_ll.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Проигрыватель покадровых анимаций (Segment Animation Player).
+ *
+ * Анимация — поток байтовых команд во flash. Кадр описывается только
+ * изменениями относительно предыдущего (delta), повторяющиеся маски
+ * сжимаются командами FILL/RUN (RLE). Команда SHOW завершает кадр и задает
+ * его длительность. Проигрыватель держит в RAM только текущий кадр
+ * (VFD_MAX_DIGITS байт) и позицию в потоке, без динамической памяти.
+ *
+ * Пример (мигание "8888"):
+ *   static const uint8_t blink_data[] = {
+ *       ANIM_FILL(0x7F), ANIM_SHOW(200),
+ *       ANIM_CLEAR(),    ANIM_SHOW(200),
+ *       ANIM_END()
+ *   };
+ *   static const display_anim_t blink = { blink_data, sizeof(blink_data), 5 };
+ */
+
+/* Команды потока */
+#define DISPLAY_ANIM_OP_SET     0x00u  // 0x0p, seg       : разряд p (0..15) = seg
+#define DISPLAY_ANIM_OP_RUN     0x10u  // 0x1n, start, seg: n+1 разрядов начиная со start = seg
+#define DISPLAY_ANIM_OP_FILL    0x20u  // 0x20, seg       : все разряды = seg
+#define DISPLAY_ANIM_OP_CLEAR   0x21u  // 0x21            : все разряды = 0
+#define DISPLAY_ANIM_OP_BRIGHT  0x30u  // 0x30, level     : яркость всех разрядов (линейная, 0..255)
+#define DISPLAY_ANIM_OP_SHOW    0x40u  // 0x40, t         : показать кадр t * 10 мс (0 = период по умолчанию)
+#define DISPLAY_ANIM_OP_END     0xFFu  // Конец последовательности
+
+#define DISPLAY_ANIM_TICK_MS    10u
+
+/* Макросы для описания анимаций */
+#define ANIM_SET(pos, seg)       (uint8_t)(DISPLAY_ANIM_OP_SET | ((pos) & 0x0Fu)), (uint8_t)(seg)
+#define ANIM_RUN(start, n, seg)  (uint8_t)(DISPLAY_ANIM_OP_RUN | (((n) - 1u) & 0x0Fu)), (uint8_t)(start), (uint8_t)(seg)
+#define ANIM_FILL(seg)           (uint8_t)DISPLAY_ANIM_OP_FILL, (uint8_t)(seg)
+#define ANIM_CLEAR()             (uint8_t)DISPLAY_ANIM_OP_CLEAR
+#define ANIM_BRIGHT(level)       (uint8_t)DISPLAY_ANIM_OP_BRIGHT, (uint8_t)(level)
+#define ANIM_SHOW(ms)            (uint8_t)DISPLAY_ANIM_OP_SHOW, (uint8_t)((ms) / DISPLAY_ANIM_TICK_MS)
+#define ANIM_SHOW_DEFAULT()      (uint8_t)DISPLAY_ANIM_OP_SHOW, (uint8_t)0
+#define ANIM_END()               (uint8_t)DISPLAY_ANIM_OP_END
+
+/* Описание анимации (обычно static const во flash). */
+typedef struct {
+    const uint8_t *data;
+    uint16_t       len;
+    uint8_t        loops;       // Число повторов (0 = бесконечно, до остановки)
+} display_anim_t;
+
+/* Состояние проигрывателя. */
+typedef struct {
+    const display_anim_t *anim;
+    uint16_t              pc;          // Позиция в потоке
+    uint8_t               loop;        // Завершенных повторов
+    bool                  shown;       // В текущем проходе был хотя бы один кадр
+    bool                  bright_set;  // Анимация меняла яркость
+    uint8_t               brightness;  // Последняя яркость из потока (линейная)
+    vfd_segment_map_t     frame[VFD_MAX_DIGITS];
+} display_anim_player_t;
+
+/* Подготовка проигрывателя. Кадр очищается. */
+void display_anim_begin(display_anim_player_t *p, const display_anim_t *anim);
+
+/*
+ * Декодирование следующего кадра в p->frame.
+ * Возвращает false, когда последовательность закончилась (или поток некорректен).
+ * *frame_ms: длительность кадра (0 = период по умолчанию вызывающего кода).
+ */
+bool display_anim_next_frame(display_anim_player_t *p, uint32_t *frame_ms);
+
+/* Число кадров за один проход (для расчета периода по общей длительности). */
+uint16_t display_anim_frame_count(const display_anim_t *anim);
+
+/* Номинальная длительность всех повторов (0 для бесконечной анимации). */
+uint32_t display_anim_duration_ms(const display_anim_t *anim, uint32_t default_frame_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DISPLAY_ANIM_H
@@ -4,12 +4,24 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "display_ll.h"
+#include "display_ease.h"
+#include "display_anim.h"
+#include "display_als.h"
 
 /*
  * High-Level API.
  * Предоставляет функции для управления контентом, эффектами и режимами дисплея.
  */
 
+/* Порядок переключения сегментов в эффекте Morph */
+typedef enum {
+    DISPLAY_MORPH_SWEEP = 0,      // Слева направо, по одному сегменту (по умолчанию)
+    DISPLAY_MORPH_RANDOM,         // Случайный порядок
+    DISPLAY_MORPH_CENTER_OUT,     // От центра к краям, симметричные разряды одновременно
+    DISPLAY_MORPH_PARALLEL,       // Все разряды одновременно, сегмент за сегментом
+    DISPLAY_MORPH_SEGMENT_PATH,   // По контуру знака (A-B-C-D-E-F-G-DP), все разряды одновременно
+} display_morph_order_t;
+
 /* Режим работы дисплея */
 typedef enum {
     DISPLAY_MODE_CONTENT = 0,     // Отображение основного контента
@@ -17,6 +29,42 @@ typedef enum {
     DISPLAY_MODE_OVERLAY          // Активен оверлей (уведомление)
 } display_mode_t;
 
+/* Полный тип состояния (нужен display_mode_t выше) */
+#include "display_state.h"
+
+/* =====================
+ *  НЕСКОЛЬКО ДИСПЛЕЕВ
+ * ===================== */
+
+/*
+ * Экземпляр дисплея: состояние ядра вместе с драйвером LL.
+ * Память выделяет приложение (обычно static, обнуленная). Функции display_*_ex
+ * принимают экземпляр явно (см. "ЯВНЫЙ ЭКЗЕМПЛЯР"), остальные работают с выбранным;
+ * без вызова display_select() используется встроенный экземпляр по умолчанию,
+ * и однодисплейный код не меняется.
+ *
+ *   static display_t clock_tube, status_tube;
+ *   display_init_instance(&clock_tube, &clock_cfg);
+ *   display_init_instance(&status_tube, &status_cfg);
+ *   display_show_text_ex(&status_tube, "ok");
+ *   display_select(&clock_tube);
+ *   display_show_number(1234);          // clock_tube
+ *   ...
+ *   display_process_all();              // в главном цикле
+ *
+ * Развертку всех экземпляров выполняет один общий таймер LL.
+ * Датчик освещенности один на систему: автояркость включается в одном экземпляре.
+ */
+typedef display_state_t display_t;
+
+#define DISPLAY_MAX_INSTANCES  DISPLAY_LL_MAX_INSTANCES
+
+/* Выбор текущего экземпляра (NULL — по умолчанию). Возвращает предыдущий. */
+display_t *display_select(display_t *disp);
+
+/* Текущий экземпляр. */
+display_t *display_current(void);
+
 /* 
  * Стандартная инициализация (использует пины по умолчанию).
  * digit_count: Количество разрядов дисплея.
@@ -30,6 +78,31 @@ void display_init(uint8_t digit_count);
  */
 void display_init_ex(const display_ll_config_t *cfg);
 
+/* Загрузочный кадр для display_init_fast(). */
+typedef struct {
+    const vfd_segment_map_t *frame;       // Сегменты по разрядам (NULL — пустой кадр)
+    uint8_t                  frame_len;
+    uint8_t                  brightness;  // Линейная яркость кадра (0 = VFD_MAX_BRIGHTNESS)
+} display_boot_config_t;
+
+/*
+ * Быстрый старт: развертка запускается сразу с загрузочным кадром.
+ * АЦП, посев генератора эффектов, переход к пользовательской яркости и лог
+ * выполняются в следующих вызовах display_process(), по одному шагу за вызов.
+ * boot: может быть NULL (пустой кадр на полной яркости).
+ */
+void display_init_fast(const display_ll_config_t *cfg, const display_boot_config_t *boot);
+
+/* Времена старта, мкс от сброса (time_us_32). */
+typedef struct {
+    uint32_t init_us;         // Вызов инициализации
+    uint32_t first_frame_us;  // Первый кадр выведен целиком (0 = еще нет)
+    uint32_t ready_us;        // Отложенные шаги завершены (0 = еще нет)
+} display_boot_stats_t;
+
+/* false, если экземпляр еще не инициализировался. */
+bool display_get_boot_stats(display_boot_stats_t *out);
+
 
 /* =====================
  *  ОТРИСОВКА КОНТЕНТА
@@ -38,6 +111,12 @@ void display_init_ex(const display_ll_config_t *cfg);
 /* Вывод целого числа с выравниванием по правому краю. */
 void display_show_number(int32_t value);
 
+/*
+ * Формирование сегментов числа в buf (как display_show_number) без вывода.
+ * buf: не меньше digit_count элементов. Удобно как цель для Slot Machine / Morph.
+ */
+void display_render_number(int32_t value, vfd_segment_map_t *buf);
+
 /* Вывод текстовой строки. */
 void display_show_text(const char *text);
 
@@ -88,9 +167,44 @@ bool display_fx_matrix(uint32_t duration_ms, uint32_t frame_ms);
 /* Запуск эффекта морфинга (плавное превращение). */
 bool display_fx_morph(uint32_t duration_ms, const vfd_segment_map_t *target, uint32_t steps);
 
+/* Морфинг с выбором порядка переключения сегментов. */
+bool display_fx_morph_ordered(uint32_t duration_ms, const vfd_segment_map_t *target, uint32_t steps,
+                              display_morph_order_t order);
+
 /* Запуск эффекта рассыпания (Dissolve). */
 bool display_fx_dissolve(uint32_t duration_ms);
 
+/* Запуск эффекта сборки (Assemble): сегменты контента появляются в случайном порядке. */
+bool display_fx_assemble(uint32_t duration_ms);
+
+/*
+ * Кривая сглаживания для следующего запуска эффекта на этом экземпляре.
+ * Настройка одноразовая: успешный старт эффекта забирает ее и возвращает
+ * DISPLAY_EASE_DEFAULT (собственная кривая эффекта), поэтому она не переходит
+ * на последующие эффекты. Вызывайте непосредственно перед display_fx_*().
+ * Влияет на Fade, Pulse, Wave, Matrix, Morph, Dissolve/Assemble.
+ */
+void display_fx_set_easing(display_ease_t curve);
+
+/*
+ * Slot Machine: изменившиеся разряды прокручивают цифры, как барабаны,
+ * и останавливаются слева направо на target. Фиксирует target по завершении.
+ * frame_ms: период смены цифры на барабане (0 = 60 мс).
+ */
+bool display_fx_slot_machine(uint32_t duration_ms, const vfd_segment_map_t *target, uint32_t frame_ms);
+
+/*
+ * Decode: разряды показывают случайные сегменты и "расшифровываются" слева направо.
+ * target == NULL — расшифровывается текущий контент. Фиксирует target по завершении.
+ */
+bool display_fx_decode(uint32_t duration_ms, const vfd_segment_map_t *target);
+
+/*
+ * Ping-Pong: маркер проходит по дисплею туда-обратно (passes проходов, 0 = 3),
+ * на последнем проходе разряды за маркером сменяются на target.
+ */
+bool display_fx_pingpong(uint32_t duration_ms, const vfd_segment_map_t *target, uint8_t passes);
+
 /* Принудительная остановка текущего эффекта. */
 void display_fx_stop(void);
 
@@ -107,6 +221,12 @@ bool display_overlay_wifi(uint32_t duration_ms);
 /* Запуск анимации синхронизации NTP. */
 bool display_overlay_ntp(uint32_t duration_ms);
 
+/*
+ * Проигрывание анимации из flash как оверлея (формат — display_anim.h).
+ * frame_ms: длительность кадров ANIM_SHOW_DEFAULT() (0 = 100 мс).
+ */
+bool display_overlay_play(const display_anim_t *anim, uint32_t frame_ms);
+
 /* Остановка оверлея и возврат к контенту. */
 void display_overlay_stop(void);
 
@@ -117,12 +237,29 @@ void display_overlay_stop(void);
 /* Установка глобального уровня яркости (0-255). */
 void display_set_brightness(uint8_t value);
 
+/* Наибольшая длительность перехода яркости, мс (большие значения ограничиваются). */
+#define DISPLAY_BRIGHTNESS_RAMP_MAX_MS  60000u
+
+/*
+ * Длительность плавного перехода яркости (автояркость, ночной режим), мс.
+ * 0 = переходы мгновенные. По умолчанию 1500 мс, не больше DISPLAY_BRIGHTNESS_RAMP_MAX_MS.
+ */
+void display_set_brightness_ramp(uint32_t ramp_ms);
+
 /* Включение или выключение ночного режима. */
 void display_set_night_mode(bool enable);
 
 /* Включение или выключение автоматической яркости (по датчику). */
 void display_set_auto_brightness(bool enable);
 
+/*
+ * Параметры датчика освещенности для автояркости: пин (26..29), частота отсчетов,
+ * фильтр (EMA) и гистерезис. Нулевые поля — значения по умолчанию (пин не меняется,
+ * гистерезис ядра — 2). Работающий датчик перезапускается с новыми параметрами.
+ * Возвращает false при неверном пине или если датчик не удалось перезапустить.
+ */
+bool display_set_als_config(const display_als_config_t *cfg);
+
 /* Управление автоматическим миганием разделительных точек. */
 void display_set_dot_blinking(bool enable);
 
@@ -159,4 +296,76 @@ bool display_is_overlay_running(void);
  */
 void display_process(void);
 
+/*
+ * Обработка всех инициализированных экземпляров (display_process_ex для каждого).
+ * Текущий выбор не меняется, в том числе если обработчик on_*_finished вызвал display_select().
+ */
+void display_process_all(void);
+
+/* =====================
+ *   ЯВНЫЙ ЭКЗЕМПЛЯР
+ * ===================== */
+
+/*
+ * Варианты с явным экземпляром: не зависят от display_select() и не меняют его.
+ * Функции без экземпляра — обертки над ними для display_current().
+ * На время вызова экземпляр становится текущим для внутренних модулей, поэтому
+ * обработчики on_*_finished, вызванные из display_process_ex(), видят свой экземпляр.
+ * disp == NULL: вызов игнорируется (false / NULL).
+ */
+
+/* false — неверная конфигурация, ошибка LL или заняты все DISPLAY_MAX_INSTANCES мест (в лог). */
+bool display_init_instance(display_t *disp, const display_ll_config_t *cfg);
+bool display_init_fast_instance(display_t *disp, const display_ll_config_t *cfg,
+                                const display_boot_config_t *boot);
+bool display_get_boot_stats_ex(const display_t *disp, display_boot_stats_t *out);
+
+void display_show_number_ex(display_t *disp, int32_t value);
+void display_render_number_ex(const display_t *disp, int32_t value, vfd_segment_map_t *buf);
+void display_show_text_ex(display_t *disp, const char *text);
+void display_show_time_ex(display_t *disp, uint8_t hours, uint8_t minutes, bool show_colon);
+void display_show_date_ex(display_t *disp, uint8_t day, uint8_t month);
+vfd_segment_map_t *display_content_buffer_ex(display_t *disp);
+
+void display_set_brightness_ex(display_t *disp, uint8_t value);
+void display_set_brightness_ramp_ex(display_t *disp, uint32_t ramp_ms);
+void display_set_night_mode_ex(display_t *disp, bool enable);
+void display_set_auto_brightness_ex(display_t *disp, bool enable);
+bool display_set_als_config_ex(display_t *disp, const display_als_config_t *cfg);
+void display_set_dot_blinking_ex(display_t *disp, bool enable);
+void display_set_dots_config_ex(display_t *disp, uint16_t mask, bool blink);
+
+display_mode_t display_get_mode_ex(const display_t *disp);
+bool display_is_effect_running_ex(const display_t *disp);
+bool display_is_overlay_running_ex(const display_t *disp);
+
+void display_process_ex(display_t *disp);
+
+bool display_fx_marquee_ex(display_t *disp, const char *text, uint32_t speed_ms);
+bool display_fx_slide_in_ex(display_t *disp, const char *text, uint32_t speed_ms);
+bool display_fx_wave_ex(display_t *disp, uint32_t duration_ms);
+bool display_fx_pulse_ex(display_t *disp, uint32_t duration_ms);
+bool display_fx_fade_in_ex(display_t *disp, uint32_t duration_ms);
+bool display_fx_fade_out_ex(display_t *disp, uint32_t duration_ms);
+bool display_fx_glitch_ex(display_t *disp, uint32_t duration_ms);
+bool display_fx_matrix_ex(display_t *disp, uint32_t duration_ms, uint32_t frame_ms);
+bool display_fx_morph_ex(display_t *disp, uint32_t duration_ms, const vfd_segment_map_t *target, uint32_t steps);
+bool display_fx_morph_ordered_ex(display_t *disp, uint32_t duration_ms, const vfd_segment_map_t *target,
+                                 uint32_t steps, display_morph_order_t order);
+bool display_fx_dissolve_ex(display_t *disp, uint32_t duration_ms);
+bool display_fx_assemble_ex(display_t *disp, uint32_t duration_ms);
+bool display_fx_slot_machine_ex(display_t *disp, uint32_t duration_ms, const vfd_segment_map_t *target,
+                                uint32_t frame_ms);
+bool display_fx_decode_ex(display_t *disp, uint32_t duration_ms, const vfd_segment_map_t *target);
+bool display_fx_pingpong_ex(display_t *disp, uint32_t duration_ms, const vfd_segment_map_t *target, uint8_t passes);
+void display_fx_set_easing_ex(display_t *disp, display_ease_t curve);
+void display_fx_tick_ex(display_t *disp);
+void display_fx_stop_ex(display_t *disp);
+
+bool display_overlay_boot_ex(display_t *disp, uint32_t duration_ms);
+bool display_overlay_wifi_ex(display_t *disp, uint32_t duration_ms);
+bool display_overlay_ntp_ex(display_t *disp, uint32_t duration_ms);
+bool display_overlay_play_ex(display_t *disp, const display_anim_t *anim, uint32_t frame_ms);
+void display_overlay_stop_ex(display_t *disp);
+
 #endif // DISPLAY_API_H
\ No newline at end of file
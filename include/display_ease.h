@@ -0,0 +1,55 @@
+#ifndef DISPLAY_EASE_H
+#define DISPLAY_EASE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Модуль кривых сглаживания (Easing).
+ * Кривые хранятся во flash как таблицы из 256 точек в формате Q16,
+ * промежуточные значения получаются линейной интерполяцией.
+ * Вычисление не использует деление и плавающую точку.
+ *
+ * Аргумент и результат — доля в Q16: 0 = 0.0, 65535 ≈ 1.0.
+ */
+
+#define DISPLAY_EASE_LUT_SIZE 256u
+#define DISPLAY_EASE_ONE      65535u
+
+typedef enum {
+    DISPLAY_EASE_DEFAULT = 0,     // Собственная кривая эффекта
+    DISPLAY_EASE_LINEAR,
+    DISPLAY_EASE_IN_QUAD,
+    DISPLAY_EASE_IN_CUBIC,
+    DISPLAY_EASE_OUT_CUBIC,
+    DISPLAY_EASE_IN_OUT_CUBIC,
+    DISPLAY_EASE_IN_OUT_SINE,
+    DISPLAY_EASE_IN_EXPO,
+    DISPLAY_EASE_OUT_EXPO,
+    DISPLAY_EASE_OUT_BOUNCE,
+    DISPLAY_EASE_CUSTOM,          // Таблица пользователя (display_ease_set_custom)
+    DISPLAY_EASE_COUNT
+} display_ease_t;
+
+/* Значение кривой в точке t (Q16). DEFAULT и неизвестные значения — линейная. */
+uint16_t display_ease_q16(display_ease_t curve, uint16_t t);
+
+/* То же в Q8: 0..255. */
+uint8_t display_ease_q8(display_ease_t curve, uint8_t t);
+
+/*
+ * Установка пользовательской кривой.
+ * lut: DISPLAY_EASE_LUT_SIZE точек Q16, равномерно от t=0 до t=1.
+ * Таблица не копируется и должна существовать, пока используется (обычно const во flash).
+ * NULL сбрасывает кривую к линейной.
+ */
+void display_ease_set_custom(const uint16_t *lut);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DISPLAY_EASE_H
@@ -0,0 +1,107 @@
+#ifndef DISPLAY_FX_H
+#define DISPLAY_FX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "display_state.h"
+#include "display_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Интерфейс эффектов (FX Plugin API).
+ * Каждый эффект — таблица функций (vtable) и флаги. Встроенные эффекты
+ * описаны такими же таблицами внутри display_fx.c, пользовательские
+ * регистрируются во время работы и получают тип FX_USER_FIRST + n.
+ *
+ * Состояние пользовательского эффекта живет в арене, которую предоставляет
+ * приложение (display_fx_set_arena). В одном дисплее одновременно активен
+ * только один эффект, поэтому арена одна на экземпляр и обнуляется перед
+ * каждым стартом. Реестр эффектов общий для всех экземпляров.
+ */
+
+#define DISPLAY_FX_MAX_USER          8u
+#define DISPLAY_FX_DEFAULT_FPS       50u       // Частота кадров движка по умолчанию
+
+#define DISPLAY_FX_FLAG_BLOCKING     (1u << 0) // Эффект захватывает сегменты (контент не выводится)
+#define DISPLAY_FX_FLAG_BRIGHTNESS   (1u << 1) // Эффект управляет яркостью (ядро не пишет ее в LL)
+
+/* Контекст вызова. Заполняется движком перед каждым обратным вызовом. */
+typedef struct {
+    void                    *state;           // Область состояния (state_size байт) или NULL
+    const vfd_segment_map_t *content;         // Снимок контента на момент старта
+    uint32_t                 elapsed_ms;      // Время с начала эффекта
+    uint32_t                 duration_ms;
+    uint32_t                 frame_ms;
+    uint16_t                 progress_q16;    // Прогресс после кривой сглаживания (0..65535)
+    uint8_t                  digit_count;
+    uint8_t                  base_brightness; // Амплитуда яркости (линейная, 0..255)
+} display_fx_ctx_t;
+
+typedef struct {
+    const char *name;
+    uint32_t    flags;        // DISPLAY_FX_FLAG_*
+    size_t      state_size;   // Требуемый объем арены (0 — без состояния)
+
+    /* Подготовка. Возвращает false, чтобы отменить запуск. Может быть NULL. */
+    bool (*start)(display_fx_ctx_t *ctx, const void *args);
+
+    /* Кадр эффекта. Возвращает false, чтобы завершить эффект досрочно. Обязателен. */
+    bool (*tick)(display_fx_ctx_t *ctx);
+
+    /* Вызывается перед восстановлением снимка. Может быть NULL. */
+    void (*finish)(display_fx_ctx_t *ctx);
+} display_fx_vtable_t;
+
+/*
+ * Регистрация пользовательского эффекта.
+ * vt должна существовать все время работы (обычно static const).
+ * Возвращает false, если таблица некорректна или все слоты заняты.
+ */
+bool display_fx_register(const display_fx_vtable_t *vt, fx_type_t *out_type);
+
+/* Арена для состояния пользовательских эффектов текущего дисплея. Память должна быть выровнена под их данные. */
+void display_fx_set_arena(void *mem, size_t size);
+
+/*
+ * Запуск зарегистрированного эффекта.
+ * args передается в start() без изменений.
+ */
+bool display_fx_start(fx_type_t type, uint32_t duration_ms, uint32_t frame_ms, const void *args);
+
+/* Счетчики кадров текущего (или последнего) эффекта. Сбрасываются при старте. */
+typedef struct {
+    uint32_t frames_rendered;  // Отрисовано кадров
+    uint32_t frames_skipped;   // Пропущено из-за задержек главного цикла
+    uint32_t frame_period_us;  // Период кадра движка
+    uint32_t requested_ms;     // Запрошенная длительность
+    uint32_t actual_ms;        // Фактическая (0, пока эффект идет)
+} display_fx_stats_t;
+
+/*
+ * Частота кадров движка FX (0 = DISPLAY_FX_DEFAULT_FPS).
+ * Кадр вычисляется только при наступлении его времени; эффекты видят
+ * квантованное время n * period, поэтому результат не зависит от скорости цикла.
+ */
+void display_fx_set_frame_rate(uint16_t fps);
+
+/* Получение счетчиков кадров. */
+bool display_fx_get_stats(display_fx_stats_t *stats);
+
+/* Флаги активного эффекта (0, если эффект не запущен). */
+uint32_t display_fx_get_flags(void);
+
+/* Варианты с явным экземпляром (см. display_api.h, "ЯВНЫЙ ЭКЗЕМПЛЯР"). */
+void display_fx_set_arena_ex(display_t *disp, void *mem, size_t size);
+bool display_fx_start_ex(display_t *disp, fx_type_t type, uint32_t duration_ms, uint32_t frame_ms, const void *args);
+void display_fx_set_frame_rate_ex(display_t *disp, uint16_t fps);
+bool display_fx_get_stats_ex(const display_t *disp, display_fx_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DISPLAY_FX_H
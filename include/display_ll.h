@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "hardware/irq.h"
 
 /*
  * Low-Level API.
@@ -13,6 +14,8 @@
 #define VFD_MAX_DIGITS      10
 #define VFD_MAX_BRIGHTNESS  255
 
+#define DISPLAY_LL_MAX_CHAINS  4   // Параллельных цепочек 74HC595 на один экземпляр
+
 /* 
  * Тип данных для карты сегментов (8 бит).
  * Каждый бит соответствует состоянию сегмента (A-G, DP).
@@ -20,6 +23,16 @@
  */
 typedef uint8_t vfd_segment_map_t;
 
+/*
+ * Разводка линий DATA (CLOCK и LATCH общие).
+ * Раздельные линии сдвигаются одновременно: слот занимает 8 тактов вместо 16-24.
+ */
+typedef enum {
+    DISPLAY_LL_BUS_SERIAL = 0,  // Сетка и сегменты последовательно через data_pin
+    DISPLAY_LL_BUS_SPLIT,       // Сетка на data_pin, сегменты на seg_data_pin
+    DISPLAY_LL_BUS_SPLIT3,      // SPLIT + второй байт сетки (> 8 разрядов) на grid_hi_data_pin
+} display_ll_bus_t;
+
 /* Конфигурация драйвера низкого уровня. */
 typedef struct {
     uint8_t data_pin;          // GPIO: Data (DS)
@@ -27,14 +40,254 @@ typedef struct {
     uint8_t latch_pin;         // GPIO: Latch (ST_CP)
     uint8_t digit_count;       // Количество разрядов (1..VFD_MAX_DIGITS)
     uint16_t refresh_rate_hz;  // Частота обновления экрана (рек. 100-120 Гц)
+
+    // Адаптивный регулятор частоты (Governor). 0/0 = выключен.
+    uint16_t refresh_min_hz;   // Нижняя граница частоты при перегрузке
+    uint16_t refresh_max_hz;   // Верхняя граница частоты при простое
+    uint8_t  governor_load_pct;// Допустимая доля CPU в ISR, % (0 = LL_GOV_DEFAULT_LOAD_PCT)
+
+    // Энергосбережение: остановка развертки, пока кадр полностью темный
+    bool dark_suspend;
+
+    // Параллельные цепочки (общие CLOCK/LATCH, у каждой своя линия DATA).
+    // 0/1 = одна цепочка на data_pin. Цепочка c показывает разряды
+    // [c * n, (c + 1) * n), n = digit_count / chain_count; цепочка 0 — на data_pin.
+    uint8_t chain_count;
+    uint8_t chain_data_pins[DISPLAY_LL_MAX_CHAINS - 1];  // DATA цепочек 1..chain_count-1
+
+    // Раздельные линии сетки и сегментов (только для одной цепочки)
+    display_ll_bus_t bus;
+    uint8_t seg_data_pin;       // DATA регистра сегментов (SPLIT, SPLIT3)
+    uint8_t grid_hi_data_pin;   // DATA регистра сеток 8-15 (SPLIT3)
 } display_ll_config_t;
 
+/* Режим ограничителя мощности. */
+typedef enum {
+    DISPLAY_LL_POWER_GLOBAL = 0,   // Общий коэффициент для всех разрядов
+    DISPLAY_LL_POWER_PER_DIGIT,    // Ограничение только "тяжелых" разрядов
+} display_ll_power_mode_t;
+
+/* =====================
+ *      ЭКЗЕМПЛЯРЫ
+ * ===================== */
+
+#define DISPLAY_LL_MAX_INSTANCES  4
+
+/*
+ * Состояние экземпляра драйвера (одна цепочка регистров и ламп).
+ * Память предоставляет приложение: static-переменная или поле своей структуры.
+ * Поля приватные, изменяются только через API.
+ */
+typedef struct display_ll
+{
+    // Флаги состояния
+    bool initialized;
+    bool refresh_running;
+
+    // Конфигурация GPIO
+    uint8_t data_pin;
+    uint8_t clock_pin;
+    uint8_t latch_pin;
+
+    // Параметры дисплея
+    uint8_t  digit_count;
+    uint8_t  scan_digits;           // Слотов в цикле развертки (разрядов на цепочку)
+    uint16_t refresh_rate_hz;       // Частота, которой соответствует slot_period_us
+    uint32_t slot_period_us;
+
+    // Буферы данных
+    vfd_segment_map_t seg_buffer[VFD_MAX_DIGITS];
+    uint8_t           brightness[VFD_MAX_DIGITS];   // Запрошенная яркость
+    uint8_t           pwm[VFD_MAX_DIGITS];          // Итоговый PWM (после ограничителя)
+
+    // Контекст развертки
+    uint8_t current_digit;
+    bool extended_grid_mode;
+
+    // Параллельные цепочки: линии DATA и состояние текущего слота
+    uint8_t  chain_count;                           // 1 = обычный режим
+    uint8_t  chain_pins[DISPLAY_LL_MAX_CHAINS];
+    uint32_t chain_mask[DISPLAY_LL_MAX_CHAINS];     // Маски GPIO линий DATA
+    uint32_t data_mask;                             // Все линии DATA
+    uint16_t chain_grid;                            // Сетка текущего слота
+    uint8_t  chain_lit;                             // Цепочки, которые еще светятся в слоте
+    vfd_segment_map_t chain_segs[DISPLAY_LL_MAX_CHAINS];
+    uint32_t chain_cut_us[DISPLAY_LL_MAX_CHAINS];   // Отсечки PWM от начала слота
+    uint32_t chain_cut_at;                          // Отсечка, на которую назначено гашение
+
+    // Раздельные линии DATA (bus != SERIAL)
+    display_ll_bus_t bus;
+    uint8_t  seg_data_pin;
+    uint8_t  grid_hi_data_pin;
+    uint32_t bus_mask;                              // Все линии DATA шины
+
+    // Энергосбережение: маска "светящихся" разрядов (сегменты != 0 и яркость != 0)
+    bool     dark_suspend;
+    bool     suspended;
+    uint16_t lit_mask;
+
+    // Ограничитель мощности
+    uint16_t power_budget;          // ‰ от максимума, 0 = выключен
+    display_ll_power_mode_t power_mode;
+    uint32_t power_limit;           // Лимит в единицах (сегменты × яркость)
+    uint32_t power_digit_limit;     // Лимит на разряд (режим PER_DIGIT)
+    uint16_t power_scale;           // Глобальный коэффициент Q8 (256 = 1.0)
+    uint16_t digit_load[VFD_MAX_DIGITS];
+    uint32_t total_load;
+
+    // Гашение PWM (событие будильника гашения)
+    bool     clear_pending;
+    uint32_t clear_at_us;           // Абсолютное время гашения (time_us_32)
+    uint32_t edge_count;
+    uint32_t edge_late_max_us;
+    uint64_t edge_late_sum_us;
+    uint32_t edges_dropped;         // Гашения, вытесненные следующим слотом
+
+    bool gamma_enabled;
+
+    // Регулятор частоты (Governor)
+    bool     gov_enabled;
+    uint16_t gov_min_hz;
+    uint16_t gov_max_hz;
+    uint8_t  gov_load_pct;
+    uint32_t gov_pending_period_us; // Новый период, применяется на границе цикла (0 = нет)
+    uint16_t gov_pending_rate_hz;   // Частота для gov_pending_period_us
+
+    // Измерения нагрузки (окно LL_GOV_WINDOW_US)
+    uint32_t win_start_us;
+    uint32_t win_busy_us;
+    uint32_t win_missed;
+    uint32_t next_slot_us;          // Ожидаемое время следующего слота
+    uint8_t  isr_load_pct;
+    uint32_t missed_slots;
+    uint32_t first_frame_us;        // Конец первого полного цикла развертки (time_us_32, 0 = еще нет)
+    uint32_t trace_commit_us;       // Публикация кадра, еще не выведенного (VFD_TRACE)
+
+} display_ll_t;
+
+/*
+ * Выбор экземпляра, к которому относятся вызовы display_ll_* без суффикса _ex.
+ * NULL — встроенный экземпляр по умолчанию. Возвращает предыдущий выбор.
+ *
+ * Выбор влияет только на API: запущенные экземпляры (до DISPLAY_LL_MAX_INSTANCES)
+ * обслуживаются одним общим таймером (см. display_ll_set_timer_config).
+ * У каждого экземпляра свой период слота и свои моменты гашения PWM;
+ * совпавшие по времени события выполняются за один проход ISR.
+ */
+display_ll_t *display_ll_select(display_ll_t *ll);
+
+/* Текущий выбранный экземпляр. */
+display_ll_t *display_ll_current(void);
+
+/* Статистика развертки (заполняется из ISR, читается в любой момент). */
+typedef struct {
+    uint16_t refresh_rate_hz;  // Текущая частота обновления (с учетом регулятора)
+    uint8_t  isr_load_pct;     // Доля времени CPU в ISR за последнее окно измерения
+    uint32_t missed_slots;     // Пропущенные слоты развертки (с момента старта)
+    uint16_t load_permille;    // Запрошенная нагрузка (сегменты × яркость), ‰ от максимума
+    uint16_t throttle_permille;// Насколько ограничитель снизил нагрузку, ‰
+    uint32_t edge_late_max_us; // Опоздание фронта гашения PWM относительно расчетного
+    uint32_t edge_late_avg_us;
+    uint32_t edges_dropped;    // Гашения, не успевшие до следующего слота (разряд светил весь слот)
+    uint32_t first_frame_us;   // Первый кадр выведен целиком, мкс от сброса (0 = еще нет)
+} display_ll_stats_t;
+
+/* =====================
+ *    ТАЙМЕР РАЗВЕРТКИ
+ * ===================== */
+
+/*
+ * Общий таймер развертки — два аппаратных будильника RP2040, запрограммированных
+ * напрямую (без alarm pool SDK): слоты и гашения PWM. Прерывание гашения
+ * приоритетнее, поэтому фронт гашения не ждет вывода слотов других экземпляров.
+ * ISR и весь путь вывода (сдвиг, защелка, гашение) размещены в RAM.
+ */
+typedef struct {
+    int8_t  alarm_num;          // Будильник слотов 0..3 или DISPLAY_LL_ALARM_ANY
+    uint8_t irq_priority;       // Приоритет NVIC 0x00..0xC0 или DISPLAY_LL_IRQ_PRIORITY_DEFAULT
+    int8_t  edge_alarm_num;     // Будильник гашения 0..3 или DISPLAY_LL_ALARM_ANY
+    uint8_t edge_irq_priority;  // Выше (численно меньше) irq_priority или DISPLAY_LL_IRQ_PRIORITY_DEFAULT
+} display_ll_timer_config_t;
+
+/* Любой свободный будильник. */
+#define DISPLAY_LL_ALARM_ANY             (-1)
+
+/*
+ * Приоритет по умолчанию: для слотов — PICO_DEFAULT_IRQ_PRIORITY, для гашения —
+ * DISPLAY_LL_EDGE_IRQ_PRIORITY, а если он не выше приоритета слотов — 0x00.
+ * Значение 0xFF само по себе не задается (тот же уровень NVIC, что и 0xC0).
+ */
+#define DISPLAY_LL_IRQ_PRIORITY_DEFAULT  0xFF
+
+/* Приоритет прерывания гашения по умолчанию (на уровень выше PICO_DEFAULT_IRQ_PRIORITY). */
+#define DISPLAY_LL_EDGE_IRQ_PRIORITY  0x40
+
+/* Настройки по умолчанию: любые свободные будильники, приоритеты SDK и гашения. */
+#define DISPLAY_LL_TIMER_CONFIG_DEFAULT {                      \
+    .alarm_num         = DISPLAY_LL_ALARM_ANY,                 \
+    .irq_priority      = DISPLAY_LL_IRQ_PRIORITY_DEFAULT,      \
+    .edge_alarm_num    = DISPLAY_LL_ALARM_ANY,                 \
+    .edge_irq_priority = DISPLAY_LL_IRQ_PRIORITY_DEFAULT,      \
+}
+
+/*
+ * Выбор будильников и приоритетов прерываний.
+ * Применяется, только пока не запущен ни один экземпляр (иначе false).
+ * Будильники захватываются при первом display_ll_start_refresh().
+ *
+ * Все поля значимы: 0 — будильник 0 и приоритет 0x00. Начинайте
+ * с DISPLAY_LL_TIMER_CONFIG_DEFAULT и меняйте нужные поля.
+ * false: номер будильника > 3, одинаковые будильники или приоритет гашения
+ * не выше приоритета слотов (NVIC RP2040 различает 4 уровня: 0x00, 0x40, 0x80, 0xC0).
+ */
+bool display_ll_set_timer_config(const display_ll_timer_config_t *cfg);
+
+/* Статистика прерывания развертки (слоты; гашения — в display_ll_stats_t). С момента старта или сброса. */
+typedef struct {
+    uint32_t irq_count;        // Входов в ISR
+    uint32_t latency_max_us;   // Задержка входа в ISR относительно цели будильника
+    uint32_t latency_avg_us;
+    uint32_t isr_max_us;       // Самый длинный проход ISR
+} display_ll_timer_stats_t;
+
+void display_ll_get_timer_stats(display_ll_timer_stats_t *out);
+void display_ll_reset_timer_stats(void);
+
+/*
+ * Безопасный режим на время записи во flash (сборка с VFD_FLASH_SAFE).
+ * enter запрещает на текущем ядре все прерывания NVIC, кроме будильников развертки
+ * (их обработчики могут выполняться из flash); exit восстанавливает их.
+ * Вызывать на ядре, которое запустило развертку; второе ядро на время
+ * операции должно быть остановлено (multicore_lockout) или работать из RAM.
+ * Порядок действий — см. LL_API.md. false: режим недоступен или уже включен.
+ */
+bool display_ll_flash_safe_enter(void);
+void display_ll_flash_safe_exit(void);
+
+/* =====================
+ *      ЧАСТОТА ЯДРА
+ * ===================== */
+
+/*
+ * Перенастройка драйвера под текущую clk_sys: задержка импульсов CLOCK/LATCH
+ * (LL_SHIFT_PULSE_NS) и окно измерения нагрузки. Вызывать после смены частоты,
+ * сделанной в обход display_ll_set_sys_clock_khz(). Развертка не останавливается.
+ */
+void display_ll_retime(void);
+
+/*
+ * Смена clk_sys (set_sys_clock_khz) с перенастройкой драйвера.
+ * При повышении частоты задержка импульса увеличивается до переключения,
+ * при понижении — уменьшается после, поэтому импульсы не короче нормы на любом шаге.
+ */
+bool display_ll_set_sys_clock_khz(uint32_t khz, bool required);
+
 /* =====================
  *     ИНИЦИАЛИЗАЦИЯ
  * ===================== */
 
 /*
- * Инициализация драйвера, настройка GPIO и выделение ресурсов.
+ * Инициализация выбранного экземпляра, настройка GPIO и выделение ресурсов.
  * Возвращает true при успешной инициализации.
  */
 bool display_ll_init(const display_ll_config_t *cfg);
@@ -45,12 +298,33 @@ void display_ll_deinit(void);
 /* Проверка статуса инициализации драйвера. */
 bool display_ll_is_initialized(void);
 
-/* Запуск фонового процесса обновления дисплея (мультиплексирования). */
+/*
+ * Запуск фонового процесса обновления дисплея (мультиплексирования).
+ * Возвращает false, если заняты все DISPLAY_LL_MAX_INSTANCES мест общего таймера.
+ */
 bool display_ll_start_refresh(void);
 
 /* Остановка фонового процесса обновления. */
 void display_ll_stop_refresh(void);
 
+/*
+ * Текущая частота обновления (Гц) — та, с которой идет развертка.
+ * При включенном регуляторе может отличаться от refresh_rate_hz из конфигурации;
+ * новая частота регулятора учитывается с начала следующего цикла развертки.
+ */
+uint16_t display_ll_get_refresh_rate(void);
+
+/* Снимок статистики развертки (нагрузка ISR, пропуски, частота). */
+void display_ll_get_stats(display_ll_stats_t *out);
+
+/*
+ * Развертка приостановлена из-за темного кадра (dark_suspend).
+ * Экземпляр не обслуживается таймером, линии регистров в нуле. Когда приостановлены
+ * все экземпляры, общий таймер остановлен — ядро может уходить в сон (__wfi).
+ * Возобновление происходит автоматически при записи непустых сегментов/яркости.
+ */
+bool display_ll_is_suspended(void);
+
 /* =====================
  *   БУФЕР И СЕГМЕНТЫ
  * ===================== */
@@ -58,12 +332,23 @@ void display_ll_stop_refresh(void);
 /* Получение количества сконфигурированных разрядов. */
 uint8_t display_ll_get_digit_count(void);
 
-/* Получение указателя на сырой буфер сегментов. */
-vfd_segment_map_t *display_ll_get_buffer(void);
+/*
+ * Текущий буфер сегментов (только чтение). Запись — через display_ll_set_digit_raw()
+ * или display_ll_set_frame(): они обновляют маску светящихся разрядов, ограничитель
+ * мощности и выводят развертку из паузы (dark_suspend).
+ */
+const vfd_segment_map_t *display_ll_get_buffer(void);
 
 /* Установка паттерна сегментов для указанного разряда. */
 void display_ll_set_digit_raw(uint8_t index, vfd_segment_map_t segments);
 
+/*
+ * Публикация целого кадра (count разрядов начиная с 0).
+ * Производные данные (маска светящихся разрядов, ограничитель мощности)
+ * пересчитываются один раз на кадр, а не на каждый разряд.
+ */
+void display_ll_set_frame(const vfd_segment_map_t *segments, uint8_t count);
+
 /* =====================
  *        ЯРКОСТЬ
  * ===================== */
@@ -74,6 +359,19 @@ void display_ll_set_brightness(uint8_t index, uint8_t level);
 /* Установка одинаковой яркости для всех разрядов (0..255). */
 void display_ll_set_brightness_all(uint8_t level);
 
+/*
+ * Ограничитель мощности (Duty Budget).
+ * Нагрузка разряда оценивается как (число горящих сегментов × яркость),
+ * максимум — все сегменты всех разрядов на 255.
+ * budget_permille: допустимая доля максимума, ‰ (0 = ограничитель выключен).
+ * При превышении PWM масштабируется глобально или только у перегруженных разрядов.
+ * Расчет выполняется при публикации кадра/яркости, ISR читает готовые значения.
+ */
+void display_ll_set_power_budget(uint16_t budget_permille, display_ll_power_mode_t mode);
+
+/* Текущая степень ограничения, ‰ (0 = ограничение не действует). */
+uint16_t display_ll_get_power_throttle(void);
+
 /* =====================
  *    ГАММА-КОРРЕКЦИЯ
  * ===================== */
@@ -81,7 +379,45 @@ void display_ll_set_brightness_all(uint8_t level);
 /* Преобразование линейного значения яркости в скорректированное (Gamma). */
 uint8_t display_ll_apply_gamma(uint8_t linear);
 
+/*
+ * Обратное преобразование: скорректированное значение -> линейное (воспринимаемое).
+ * Используется для интерполяции яркости в гамма-домене.
+ */
+uint8_t display_ll_gamma_inverse(uint8_t corrected);
+
 /* Включение или выключение автоматической гамма-коррекции. */
 void display_ll_enable_gamma(bool enable);
 
+/* =====================
+ *   ЯВНЫЙ ЭКЗЕМПЛЯР
+ * ===================== */
+
+/*
+ * Те же функции для переданного экземпляра, независимо от display_ll_select().
+ * Функции без суффикса _ex — обертки над ними для выбранного экземпляра.
+ * ll == NULL: вызов игнорируется (false / 0 / NULL).
+ */
+bool     display_ll_init_ex(display_ll_t *ll, const display_ll_config_t *cfg);
+void     display_ll_deinit_ex(display_ll_t *ll);
+bool     display_ll_is_initialized_ex(const display_ll_t *ll);
+bool     display_ll_start_refresh_ex(display_ll_t *ll);
+void     display_ll_stop_refresh_ex(display_ll_t *ll);
+uint16_t display_ll_get_refresh_rate_ex(const display_ll_t *ll);
+void     display_ll_get_stats_ex(const display_ll_t *ll, display_ll_stats_t *out);
+bool     display_ll_is_suspended_ex(const display_ll_t *ll);
+
+uint8_t  display_ll_get_digit_count_ex(const display_ll_t *ll);
+const vfd_segment_map_t *display_ll_get_buffer_ex(const display_ll_t *ll);
+void     display_ll_set_digit_raw_ex(display_ll_t *ll, uint8_t index, vfd_segment_map_t segments);
+void     display_ll_set_frame_ex(display_ll_t *ll, const vfd_segment_map_t *segments, uint8_t count);
+
+void     display_ll_set_brightness_ex(display_ll_t *ll, uint8_t index, uint8_t level);
+void     display_ll_set_brightness_all_ex(display_ll_t *ll, uint8_t level);
+void     display_ll_set_power_budget_ex(display_ll_t *ll, uint16_t budget_permille, display_ll_power_mode_t mode);
+uint16_t display_ll_get_power_throttle_ex(const display_ll_t *ll);
+
+uint8_t  display_ll_apply_gamma_ex(const display_ll_t *ll, uint8_t linear);
+uint8_t  display_ll_gamma_inverse_ex(const display_ll_t *ll, uint8_t corrected);
+void     display_ll_enable_gamma_ex(display_ll_t *ll, bool enable);
+
 #endif // DISPLAY_LL_H
\ No newline at end of file
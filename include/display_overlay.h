@@ -0,0 +1,78 @@
+#ifndef DISPLAY_OVERLAY_H
+#define DISPLAY_OVERLAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "display_state.h"
+#include "display_anim.h"
+#include "display_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Реестр оверлеев (Overlay Registry).
+ * Оверлей — анимация (display_anim.h) с числовым приоритетом.
+ *
+ * - Свободно: оверлей запускается сразу.
+ * - Активен оверлей с меньшим приоритетом: он вытесняется в стек
+ *   (до DISPLAY_OVERLAY_STACK_DEPTH) и продолжится с того же кадра.
+ * - Иначе запрос ставится в очередь (до DISPLAY_OVERLAY_QUEUE_LEN).
+ *   Переполнение очереди — запрос отклоняется (false).
+ *
+ * По завершении оверлея продолжается вытесненный или запускается
+ * ожидающий с наибольшим приоритетом (при равенстве — вытесненный, затем FIFO).
+ * Вся память статическая.
+ */
+
+#define DISPLAY_OVERLAY_MAX_USER      8u
+
+#define DISPLAY_OVERLAY_PRIO_BOOT     10u
+#define DISPLAY_OVERLAY_PRIO_STATUS   20u   // WiFi, NTP
+#define DISPLAY_OVERLAY_PRIO_DEFAULT  50u   // display_overlay_play()
+#define DISPLAY_OVERLAY_PRIO_ALARM    200u  // Рекомендуемый для будильников и тревог
+
+/* Описание оверлея (обычно static const). */
+typedef struct {
+    const char           *name;
+    uint8_t               priority;
+    const display_anim_t *anim;
+    uint32_t              frame_ms;   // Период кадров ANIM_SHOW_DEFAULT() по умолчанию
+} display_overlay_def_t;
+
+/* Регистрация оверлея. def должна существовать все время работы. */
+bool display_overlay_register(const display_overlay_def_t *def, overlay_type_t *out_type);
+
+/*
+ * Запрос показа оверлея по типу (встроенного или зарегистрированного).
+ * duration_ms: общая длительность (0 = период кадра из описания).
+ * Возвращает true, если оверлей запущен или поставлен в очередь.
+ */
+bool display_overlay_start(overlay_type_t type, uint32_t duration_ms);
+
+/* Проигрывание анимации с заданным приоритетом. */
+bool display_overlay_play_prio(const display_anim_t *anim, uint32_t frame_ms, uint8_t priority);
+
+/*
+ * Отчет о последнем завершенном оверлее.
+ * Время вытеснения более приоритетным оверлеем в actual_ms не входит (suspended_ms).
+ * actual_ms заметно больше requested_ms, frames_dropped > 0 или большой max_late_us
+ * указывают на перегрузку главного цикла.
+ */
+bool display_overlay_get_last_stats(display_overlay_stats_t *stats);
+
+/* Число вытесненных и ожидающих оверлеев. */
+uint8_t display_overlay_pending(void);
+
+/* Варианты с явным экземпляром (см. display_api.h, "ЯВНЫЙ ЭКЗЕМПЛЯР"). */
+bool display_overlay_start_ex(display_t *disp, overlay_type_t type, uint32_t duration_ms);
+bool display_overlay_play_prio_ex(display_t *disp, const display_anim_t *anim, uint32_t frame_ms, uint8_t priority);
+bool display_overlay_get_last_stats_ex(const display_t *disp, display_overlay_stats_t *stats);
+uint8_t display_overlay_pending_ex(const display_t *disp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DISPLAY_OVERLAY_H
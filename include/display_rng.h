@@ -2,6 +2,7 @@
 #define DISPLAY_RNG_H
 
 #include <stdint.h>
+#include <stddef.h>
 #include "pico/types.h"
 
 #ifdef __cplusplus
@@ -12,22 +13,63 @@ extern "C" {
  * Модуль генерации псевдослучайных чисел.
  * Реализует алгоритм Xorshift32. Используется для визуальных эффектов
  * (Glitch, Dissolve, Matrix), не требуя использования стандартной библиотеки rand().
+ *
+ * Потоки (streams): независимые генераторы с собственным состоянием.
+ * Состояние потока выводится из общего seed и номера потока, поэтому
+ * при фиксированном seed последовательности воспроизводимы, а эффекты
+ * не сдвигают последовательности друг друга.
+ *
+ * Сборка с -DDISPLAY_RNG_FIXED_SEED=<value> заменяет аппаратную энтропию
+ * в display_rng_seed_from_hw() константой (детерминированные хост-тесты).
  */
 
+/* Независимый поток генератора. */
+typedef struct {
+    uint32_t state;
+} display_rng_stream_t;
+
 /* Инициализация генератора заданным значением (seed). */
 void display_rng_seed(uint32_t seed);
 
-/* Инициализация генератора случайным шумом с указанного вывода АЦП. */
+/*
+ * Инициализация генератора аппаратной энтропией без ожидания:
+ * случайный бит кольцевого генератора (ROSC) RP2040 + системное время.
+ */
+void display_rng_seed_from_hw(void);
+
+/*
+ * Инициализация генератора случайным шумом с указанного вывода АЦП.
+ * Устаревшее: блокирует ~2 мс на чтениях АЦП. Используйте display_rng_seed_from_hw().
+ */
 void display_rng_seed_from_adc(uint16_t adc_pin);
 
 /* Получение следующего 32-битного псевдослучайного числа. */
 uint32_t display_rng_next(void);
 
-/* Получение псевдослучайного числа в диапазоне [0 .. limit-1]. */
+/* Получение псевдослучайного числа в диапазоне [0 .. limit-1] (без смещения). */
 uint32_t display_rng_range(uint32_t limit);
 
+/* Инициализация потока stream_id от текущего общего seed. */
+void display_rng_stream_init(display_rng_stream_t *s, uint32_t stream_id);
+
+/* Следующее 32-битное число потока. */
+uint32_t display_rng_stream_next(display_rng_stream_t *s);
+
+/*
+ * Число в диапазоне [0 .. limit-1] без смещения.
+ * Умножение 32x32->64 со сдвигом вместо деления по модулю;
+ * деление выполняется только в редком случае отбраковки.
+ */
+uint32_t display_rng_stream_range(display_rng_stream_t *s, uint32_t limit);
+
+/* Заполнение массива out[count] случайными 32-битными числами. */
+void display_rng_stream_fill(display_rng_stream_t *s, uint32_t *out, size_t count);
+
+/* Перемешивание массива items[count] (Fisher-Yates). */
+void display_rng_stream_shuffle(display_rng_stream_t *s, uint8_t *items, size_t count);
+
 #ifdef __cplusplus
 }
 #endif
 
-#endif // DISPLAY_RNG_H
\ No newline at end of file
+#endif // DISPLAY_RNG_H
@@ -3,7 +3,12 @@
 
 #include "pico/types.h"
 #include "display_ll.h"
+#include "display_ease.h"
+#include "display_anim.h"
+#include "display_als.h"
+#include "display_rng.h"
 #include <stdbool.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -40,13 +45,17 @@ typedef enum {
     FX_GLITCH,
     FX_MORPH,
     FX_DISSOLVE,
+    FX_ASSEMBLE,  // Обратный Dissolve: сборка из пустоты
     FX_SLOT_MACHINE,
     FX_DECODE,
     FX_PINGPONG,
     
     // Текстовые (Text Effects)
     FX_MARQUEE,
-    FX_SLIDE_IN
+    FX_SLIDE_IN,
+
+    FX_BUILTIN_COUNT,
+    FX_USER_FIRST = FX_BUILTIN_COUNT  // Пользовательские эффекты (display_fx_register)
 } fx_type_t;
 
 /* ============================================================================
@@ -58,22 +67,75 @@ typedef enum {
     OV_BOOT,
     OV_WIFI,
     OV_NTP,
+    OV_ANIM,      // Пользовательская анимация (display_overlay_play)
+
+    OV_BUILTIN_COUNT,
+    OV_USER_FIRST = OV_BUILTIN_COUNT  // Зарегистрированные оверлеи (display_overlay_register)
 } overlay_type_t;
 
+#ifndef DISPLAY_OVERLAY_STACK_DEPTH
+#define DISPLAY_OVERLAY_STACK_DEPTH 2   // Глубина вытеснения
+#endif
+
+#ifndef DISPLAY_OVERLAY_QUEUE_LEN
+#define DISPLAY_OVERLAY_QUEUE_LEN   4   // Ожидающие запуска
+#endif
+
+/* Запрос на показ оверлея (ожидающий в очереди). */
+typedef struct {
+    overlay_type_t        type;
+    uint8_t               priority;
+    const display_anim_t *anim;
+    uint32_t              frame_ms;
+} overlay_request_t;
+
+/* Отчет о показе оверлея: запрошенная и фактическая длительность. */
+typedef struct {
+    overlay_type_t type;
+    uint32_t       requested_ms;    // Номинальная длительность (0 = бесконечная анимация)
+    uint32_t       actual_ms;       // От старта до завершения без времени вытеснения
+    uint32_t       suspended_ms;    // Сколько оверлей провел вытесненным
+    uint32_t       frames_shown;
+    uint32_t       frames_dropped;  // Кадры, время которых прошло до того, как их успели показать
+    uint32_t       max_late_us;     // Наибольшее опоздание показа кадра
+} display_overlay_stats_t;
+
+/* Вытесненный оверлей: запрос + положение проигрывателя. */
+typedef struct {
+    overlay_request_t       req;
+    absolute_time_t         start_time;
+    absolute_time_t         suspended_at;
+    uint32_t                until_next_us;   // Остаток текущего кадра на момент вытеснения
+    display_overlay_stats_t stats;
+    display_anim_player_t   player;
+} overlay_suspended_t;
+
 #define FX_TEXT_MAX_LEN 64
 
 /* ============================================================================
-   ГЛОБАЛЬНАЯ СТРУКТУРА СОСТОЯНИЯ
+   СТРУКТУРА СОСТОЯНИЯ ЭКЗЕМПЛЯРА
    ========================================================================== */
 
+/*
+ * Одна структура на дисплей. Память выделяет приложение (display_t в display_api.h),
+ * встроенный экземпляр по умолчанию используется без явного выбора.
+ */
 typedef struct display_state_s {
 
+    /* --- Драйвер (LL) этого дисплея --- */
+    display_ll_t ll;
+
     /* --- Статус --- */
     volatile bool initialized;
     uint8_t  digit_count;
     uint16_t refresh_rate_hz;
     volatile display_mode_t mode;
 
+    /* --- Старт (display_init_fast) --- */
+    uint8_t  boot_stage;        // Следующий отложенный шаг инициализации (0 = нет)
+    uint32_t boot_init_us;      // Вызов инициализации, мкс от сброса
+    uint32_t boot_ready_us;     // Инициализация завершена полностью (0 = еще нет)
+
     /* --- Буферы контента --- */
     vfd_segment_map_t content_buffer[VFD_MAX_DIGITS];
     uint8_t           content_brightness[VFD_MAX_DIGITS];
@@ -96,36 +158,66 @@ typedef struct display_state_s {
     uint32_t           fx_total_steps;
     uint32_t           fx_current_step;
     uint8_t            fx_base_brightness;
+    display_ease_t     fx_ease;            // Кривая текущего эффекта
+    display_ease_t     fx_ease_select;     // Кривая следующего запуска, сбрасывается при старте (DEFAULT = своя)
+    uint32_t           fx_inv_duration;    // 2^32 / fx_duration_ms: прогресс без деления в тике
+    uint32_t           fx_inv_frame;       // 2^32 / fx_frame_ms (0, если кадр не задан)
+    void              *fx_arena;           // Арена пользовательских эффектов (display_fx_set_arena)
+    size_t             fx_arena_size;
+
+    /* Фиксированный шаг движка FX */
+    uint32_t           fx_step_us;         // Период кадра движка (0 = DISPLAY_FX_DEFAULT_FPS)
+    uint32_t           fx_inv_step;        // 2^32 / fx_step_us: догон пропущенных кадров без деления
+    uint16_t           fx_step_ms;         // fx_step_us = fx_step_ms * 1000 + fx_step_rem_us
+    uint16_t           fx_step_rem_us;
+    uint16_t           fx_elapsed_rem_us;  // Остаток fx_elapsed_ms (< 1000 мкс)
+    uint32_t           fx_frame_no;        // Номер следующего кадра
+    uint64_t           fx_next_frame_us;   // Время следующего кадра от старта эффекта
+    uint32_t           fx_frames_rendered;
+    uint32_t           fx_frames_skipped;
+    uint32_t           fx_actual_ms;       // Фактическая длительность (после завершения)
+
+    /* Потоки RNG эффектов: у каждого экземпляра свои, посев при первом эффекте */
+    bool                 fx_rng_seeded;
+    display_rng_stream_t fx_rng_glitch;
+    display_rng_stream_t fx_rng_dissolve;
+    display_rng_stream_t fx_rng_morph;
+    display_rng_stream_t fx_rng_decode;
 
     /* Параметры эффектов (сокращено для примера, оставляем как было) */
     bool              fx_glitch_active;
-    uint32_t          fx_glitch_last_ms;
+    uint32_t          fx_glitch_start_ms;   // Начало текущего глюка (шаг узора считается от него)
     uint32_t          fx_glitch_next_ms;
     uint32_t          fx_glitch_step;
     uint8_t           fx_glitch_digit;
     uint8_t           fx_glitch_bit;
     vfd_segment_map_t fx_glitch_saved_digit;
 
-    uint32_t          fx_matrix_last_ms;
-    uint32_t          fx_matrix_step;
-    uint32_t          fx_matrix_total_steps;
-    uint8_t           fx_matrix_min_percent;
-    uint8_t           fx_matrix_brightness_percent[VFD_MAX_DIGITS];
-
     vfd_segment_map_t fx_morph_start[VFD_MAX_DIGITS];
     vfd_segment_map_t fx_morph_target[VFD_MAX_DIGITS];
+    vfd_segment_map_t fx_morph_segs[VFD_MAX_DIGITS];          // Текущее состояние
     uint32_t          fx_morph_step;
     uint32_t          fx_morph_steps;
+    uint8_t           fx_morph_order[VFD_MAX_DIGITS * 8];     // Позиции различающихся бит по порядку
+    uint16_t          fx_morph_flip_step[VFD_MAX_DIGITS * 8]; // Шаг, на котором бит переключается
+    uint8_t           fx_morph_flips;                         // Всего переключений
+    uint8_t           fx_morph_applied;                       // Уже применено
 
-    uint8_t           fx_dissolve_order[VFD_MAX_DIGITS * 8];
+    uint8_t           fx_dissolve_order[VFD_MAX_DIGITS * 8]; // Только горящие сегменты
     uint32_t          fx_dissolve_total_bits;
     uint32_t          fx_dissolve_step;
+    vfd_segment_map_t fx_dissolve_segs[VFD_MAX_DIGITS];       // Текущее состояние (применяется дельтой)
 
+    /* Поразрядные эффекты (Slot Machine, Decode, Ping-Pong) */
     vfd_segment_map_t fx_target_buffer[VFD_MAX_DIGITS];
-    uint32_t          fx_stage_step;
+    vfd_segment_map_t fx_stage_segs[VFD_MAX_DIGITS];    // Выведенное в LL состояние
+    uint32_t          fx_settle_at[VFD_MAX_DIGITS];     // Расписание фиксации разряда (мс или шаг маркера)
+    uint8_t           fx_roll_idx[VFD_MAX_DIGITS];      // Позиция барабана Slot Machine
+    uint32_t          fx_stage_step;                    // Последний обработанный кадр / шаг
+    uint32_t          fx_stage_steps;                   // Ping-Pong: всего шагов маркера
 
     int32_t           fx_pingpong_pos;
-    bool              fx_pingpong_dir;
+    bool              fx_pingpong_dir;                  // true = вправо
 
     char              fx_text_buffer[FX_TEXT_MAX_LEN];
     uint16_t          fx_text_len;
@@ -133,11 +225,22 @@ typedef struct display_state_s {
     /* --- Движок Оверлеев --- */
     volatile bool           ov_active;
     volatile overlay_type_t ov_type;
-    absolute_time_t         ov_start_time;
+    absolute_time_t         ov_start_time;     // Фактический старт оверлея
+    uint64_t                ov_next_us;        // Абсолютный срок следующего кадра (мкс с загрузки)
     uint32_t                ov_duration_ms;
     uint32_t                ov_frame_ms;
     uint32_t                ov_step;
     uint32_t                ov_loop;
+    uint8_t                 ov_priority;
+    display_anim_player_t   ov_player;         // Проигрыватель последовательности
+
+    overlay_suspended_t     ov_stack[DISPLAY_OVERLAY_STACK_DEPTH];
+    uint8_t                 ov_stack_len;
+    overlay_request_t       ov_queue[DISPLAY_OVERLAY_QUEUE_LEN];
+    uint8_t                 ov_queue_len;
+
+    display_overlay_stats_t ov_stats;          // Текущий оверлей
+    display_overlay_stats_t ov_last_stats;     // Последний завершенный
 
     /* --- Управление Яркостью --- */
     volatile bool auto_brightness_enabled;
@@ -147,8 +250,20 @@ typedef struct display_state_s {
     uint8_t  night_start_hour;
     uint8_t  night_end_hour;
     uint16_t adc_pin;
+    display_als_config_t als_config;    // Частота, фильтр и гистерезис датчика (пин — adc_pin)
     absolute_time_t brightness_last_update;
     uint32_t        brightness_update_period_ms;
+    uint8_t         brightness_level;   // Текущий базовый уровень (результат Ramp)
+
+    /* --- Плавное изменение яркости (Ramp) --- */
+    bool            ramp_active;
+    uint32_t        ramp_ms;            // Длительность перехода (0 = мгновенно)
+    uint32_t        ramp_left_us;       // Осталось до конца перехода
+    uint32_t        ramp_last_us;       // Время предыдущего шага (time_us_32)
+    uint32_t        ramp_carry_us;      // Накопленный остаток меньше 1 мс
+    uint8_t         ramp_to;            // Целевой уровень (PWM)
+    int32_t         ramp_p_q16;         // Текущая позиция в гамма-домене, Q16
+    int32_t         ramp_step_q16;      // Приращение за 1 мс, Q16
 
     /* =========================================================================
        ИНДИКАЦИЯ (DOTS) - FIX #23
@@ -168,7 +283,15 @@ typedef struct display_state_s {
 
 } display_state_t;
 
-extern display_state_t *const g_display;
+/* Текущий экземпляр (display_select). Все модули HL работают через этот указатель. */
+extern display_state_t *g_display;
+
+/*
+ * Вызовы display_*_ex (внутреннее, display_core.c): экземпляр становится текущим
+ * для HL и LL, display_core_leave() восстанавливает прежний выбор.
+ */
+display_state_t *display_core_enter(display_state_t *disp);
+void display_core_leave(display_state_t *prev);
 
 #ifdef __cplusplus
 }
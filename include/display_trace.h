@@ -0,0 +1,109 @@
+#ifndef DISPLAY_TRACE_H
+#define DISPLAY_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Трассировка событий (Event Trace).
+ *
+ * Сборка с VFD_TRACE=1 (опция CMake VFD_TRACE): переходы состояний HL и публикации
+ * кадров LL пишутся в кольцо фиксированного размера (свое на каждое ядро, старые
+ * записи перезаписываются). Запись — время, ядро, экземпляр, код события и два
+ * аргумента; безопасна в ISR развертки. Без VFD_TRACE макрос DISPLAY_TRACE()
+ * пустой, кольца нет, функции ниже ничего не делают.
+ *
+ * display_trace_dump() выводит кольцо текстом через printf; tools/vfd_trace.py
+ * переводит его в JSON для chrome://tracing и ui.perfetto.dev.
+ */
+
+#ifndef VFD_TRACE
+#define VFD_TRACE 0
+#endif
+
+#ifndef VFD_TRACE_RING_LEN
+#define VFD_TRACE_RING_LEN  128u   // Событий на ядро (степень двойки)
+#endif
+
+/* Коды событий. Номера входят в формат дампа — новые добавляются только в конец. */
+typedef enum {
+    DISPLAY_TRACE_NONE = 0,
+    DISPLAY_TRACE_FX_START,        // a = fx_type_t, b = длительность, мс
+    DISPLAY_TRACE_FX_FINISH,       // a = fx_type_t, b = фактическая длительность, мс
+    DISPLAY_TRACE_FX_PREEMPT,      // a = fx_type_t, b = overlay_type_t, который прервал эффект
+    DISPLAY_TRACE_OV_START,        // a = overlay_type_t, b = приоритет
+    DISPLAY_TRACE_OV_FINISH,       // a = overlay_type_t, b = фактическая длительность, мс
+    DISPLAY_TRACE_OV_SUSPEND,      // a = вытесненный, b = вытеснивший
+    DISPLAY_TRACE_OV_RESUME,       // a = overlay_type_t
+    DISPLAY_TRACE_OV_QUEUED,       // a = overlay_type_t, b = приоритет
+    DISPLAY_TRACE_OV_DROPPED,      // a = overlay_type_t (очередь полна)
+    DISPLAY_TRACE_MODE,            // a = прежний display_mode_t, b = новый
+    DISPLAY_TRACE_BRIGHTNESS,      // a = базовый уровень ядра (PWM)
+    DISPLAY_TRACE_CONTENT,         // a = сегменты разрядов 0..3, b = разрядов (API записал контент)
+    DISPLAY_TRACE_RESTORE,         // a = сегменты 0..3, b = 0 после эффекта / 1 после оверлея
+    DISPLAY_TRACE_LL_FRAME,        // a = сегменты 0..3, b = разрядов (буфер LL изменился любым сеттером)
+    DISPLAY_TRACE_LL_VISIBLE,      // a = мкс от публикации кадра, b = разряд первого слота
+    DISPLAY_TRACE_MARK,            // a, b — приложения (display_trace_mark)
+} display_trace_event_id_t;
+
+typedef struct {
+    uint32_t t_us;      // time_us_32()
+    uint32_t id;        // Экземпляр: адрес его display_ll_t (общий для HL и LL)
+    uint32_t a;
+    uint32_t b;
+    uint8_t  event;     // display_trace_event_id_t
+    uint8_t  core;
+} display_trace_event_t;
+
+typedef struct {
+    uint32_t recorded;     // Всего событий
+    uint32_t overwritten;  // Вытеснены более новыми до чтения
+} display_trace_stats_t;
+
+/* Запись события (вызывается через DISPLAY_TRACE). */
+void display_trace_record(uint8_t event, uint32_t id, uint32_t a, uint32_t b);
+
+/* Включение записи (после сборки с VFD_TRACE включена). */
+void display_trace_enable(bool enable);
+
+/* Очистка колец и счетчиков. */
+void display_trace_clear(void);
+
+/* Событие приложения (например, "нажата кнопка") на общей шкале времени. */
+void display_trace_mark(uint32_t a, uint32_t b);
+
+/*
+ * Копирование накопленных событий в порядке времени (кольца при этом очищаются).
+ * Запись на время копирования приостанавливается. Возвращает число событий.
+ */
+uint32_t display_trace_read(display_trace_event_t *out, uint32_t max);
+
+/* Дамп всех событий текстом (формат — tools/vfd_trace.py). Кольца очищаются. */
+void display_trace_dump(void);
+
+void display_trace_get_stats(display_trace_stats_t *out);
+
+/* Сегменты первых четырех разрядов в одном слове (разряд 0 — младший байт). */
+static inline uint32_t display_trace_pack(const uint8_t *segs, uint8_t count)
+{
+    uint32_t v = 0;
+    for (uint8_t i = 0; i < count && i < 4u; i++) v |= (uint32_t)segs[i] << (8u * i);
+    return v;
+}
+
+#if VFD_TRACE
+#define DISPLAY_TRACE(event, inst, a, b) \
+    display_trace_record((uint8_t)(event), (uint32_t)(uintptr_t)(inst), (uint32_t)(a), (uint32_t)(b))
+#else
+#define DISPLAY_TRACE(event, inst, a, b)  ((void)0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DISPLAY_TRACE_H
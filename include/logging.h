@@ -1,9 +1,45 @@
-
-
 #ifndef LOGGING_H
 #define LOGGING_H
 
 #include <stdio.h>
+#include <stdint.h>
+
+/*
+ * Журнал библиотеки.
+ *
+ * Уровень задается при сборке (VFD_LOG_LEVEL): вызовы выше уровня удаляются
+ * препроцессором целиком, аргументы не вычисляются.
+ *
+ * VFD_LOG_DEFERRED=1 (по умолчанию): вызов LOG_* только кладет в кольцо запись
+ * фиксированного размера (время, уровень, указатель формата, до 4 аргументов) —
+ * несколько десятков тактов, без printf и ожидания USB CDC. Текст формирует
+ * display_log_drain() из главного цикла: формат воспроизводится с четырьмя
+ * аргументами uintptr_t. Ограничения отложенного режима:
+ *  - аргументы — целые до 32 бит и указатели: %d %i %u %x %X %o %c %p %s,
+ *    модификаторы h, hh, l, z, t;
+ *  - %f %e %g %a (float/double), ll, j, L (64 бит) и %n не поддерживаются:
+ *    такая запись выводится как "unsupported log format: <формат>";
+ *  - строки для %s должны жить до вывода (литералы, static), буферы на стеке нельзя.
+ * Формат и типы аргументов проверяются при компиляции (-Wformat) в обоих режимах.
+ *
+ * VFD_LOG_DEFERRED=0: прежнее поведение, printf в месте вызова.
+ */
+
+#define VFD_LOG_LEVEL_NONE    0
+#define VFD_LOG_LEVEL_ERROR   1
+#define VFD_LOG_LEVEL_WARN    2
+#define VFD_LOG_LEVEL_INFO    3
+#define VFD_LOG_LEVEL_DEBUG   4
+
+#ifndef VFD_LOG_LEVEL
+#define VFD_LOG_LEVEL         VFD_LOG_LEVEL_INFO
+#endif
+
+#ifndef VFD_LOG_DEFERRED
+#define VFD_LOG_DEFERRED      1
+#endif
+
+#define VFD_LOG_MAX_ARGS      4
 
 #ifdef DEBUG_COLORS
 #define COLOR_RESET   "\033[0m"
@@ -12,9 +48,6 @@
 #define COLOR_YELLOW  "\033[33m"
 #define COLOR_BLUE    "\033[34m"
 #define COLOR_CYAN    "\033[36m"
-#define LOG_ERROR(fmt, ...)   printf(COLOR_RED "[ERROR] " fmt COLOR_RESET "\n", ##__VA_ARGS__)
-#define LOG_WARN(fmt, ...)    printf(COLOR_YELLOW "[WARNING] " fmt COLOR_RESET "\n", ##__VA_ARGS__)
-#define LOG_INFO(fmt, ...)    printf(COLOR_GREEN "[INFO] " fmt COLOR_RESET "\n", ##__VA_ARGS__)
 #else
 #define COLOR_RESET   ""
 #define COLOR_RED     ""
@@ -22,9 +55,83 @@
 #define COLOR_YELLOW  ""
 #define COLOR_BLUE    ""
 #define COLOR_CYAN    ""
-#define LOG_ERROR(fmt, ...)   printf("[ERROR] " fmt "\n", ##__VA_ARGS__)
-#define LOG_WARN(fmt, ...)    printf("[WARNING] " fmt "\n", ##__VA_ARGS__)
-#define LOG_INFO(fmt, ...)    printf("[INFO] " fmt "\n", ##__VA_ARGS__)
 #endif
 
-#endif // LOGGING_H
\ No newline at end of file
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Счетчики журнала. */
+typedef struct {
+    uint32_t written;   // Записей помещено в кольцо
+    uint32_t dropped;   // Потеряно из-за переполнения кольца
+    uint16_t pending;   // Ожидают вывода
+} display_log_stats_t;
+
+/* Запись в кольцо (вызывается макросами LOG_*). */
+void display_log_write(uint8_t level, const char *fmt, uint8_t argc,
+                       uintptr_t a0, uintptr_t a1, uintptr_t a2, uintptr_t a3);
+
+/*
+ * Вывод накопленных записей через printf (главный цикл или задача низкого приоритета).
+ * max_records: не больше стольких записей за вызов (0 = все). Возвращает число выведенных.
+ * В режиме VFD_LOG_DEFERRED=0 ничего не делает.
+ */
+uint32_t display_log_drain(uint32_t max_records);
+
+void display_log_get_stats(display_log_stats_t *out);
+
+/* Проверка формата LOG_* как у printf. Только для компилятора: вызов не вычисляется. */
+static inline __attribute__((format(printf, 1, 2))) void vfd_log_check_format_(const char *fmt, ...)
+{
+    (void)fmt;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+/* Упаковка: формат, число аргументов и 4 значения (недостающие — 0) */
+#define VFD_LOG_A0_(f)                f, 0u, 0u, 0u, 0u, 0u
+#define VFD_LOG_A1_(f, a)             f, 1u, (uintptr_t)(a), 0u, 0u, 0u
+#define VFD_LOG_A2_(f, a, b)          f, 2u, (uintptr_t)(a), (uintptr_t)(b), 0u, 0u
+#define VFD_LOG_A3_(f, a, b, c)       f, 3u, (uintptr_t)(a), (uintptr_t)(b), (uintptr_t)(c), 0u
+#define VFD_LOG_A4_(f, a, b, c, d)    f, 4u, (uintptr_t)(a), (uintptr_t)(b), (uintptr_t)(c), (uintptr_t)(d)
+#define VFD_LOG_SEL_(_1, _2, _3, _4, _5, name, ...) name
+#define VFD_LOG_PACK_(...) \
+    VFD_LOG_SEL_(__VA_ARGS__, VFD_LOG_A4_, VFD_LOG_A3_, VFD_LOG_A2_, VFD_LOG_A1_, VFD_LOG_A0_, _)(__VA_ARGS__)
+
+#if VFD_LOG_DEFERRED
+#define VFD_LOG_EMIT_(level, color, tag, ...) \
+    ((0 ? vfd_log_check_format_(__VA_ARGS__) : (void)0), \
+     display_log_write((level), VFD_LOG_PACK_(__VA_ARGS__)))
+#else
+#define VFD_LOG_EMIT_(level, color, tag, fmt, ...) \
+    printf(color tag fmt COLOR_RESET "\n", ##__VA_ARGS__)
+#endif
+
+#if VFD_LOG_LEVEL >= VFD_LOG_LEVEL_ERROR
+#define LOG_ERROR(...)   VFD_LOG_EMIT_(VFD_LOG_LEVEL_ERROR, COLOR_RED, "[ERROR] ", __VA_ARGS__)
+#else
+#define LOG_ERROR(...)   ((void)0)
+#endif
+
+#if VFD_LOG_LEVEL >= VFD_LOG_LEVEL_WARN
+#define LOG_WARN(...)    VFD_LOG_EMIT_(VFD_LOG_LEVEL_WARN, COLOR_YELLOW, "[WARNING] ", __VA_ARGS__)
+#else
+#define LOG_WARN(...)    ((void)0)
+#endif
+
+#if VFD_LOG_LEVEL >= VFD_LOG_LEVEL_INFO
+#define LOG_INFO(...)    VFD_LOG_EMIT_(VFD_LOG_LEVEL_INFO, COLOR_GREEN, "[INFO] ", __VA_ARGS__)
+#else
+#define LOG_INFO(...)    ((void)0)
+#endif
+
+#if VFD_LOG_LEVEL >= VFD_LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...)   VFD_LOG_EMIT_(VFD_LOG_LEVEL_DEBUG, COLOR_CYAN, "[DEBUG] ", __VA_ARGS__)
+#else
+#define LOG_DEBUG(...)   ((void)0)
+#endif
+
+#endif // LOGGING_H
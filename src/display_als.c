@@ -0,0 +1,186 @@
+#include "display_als.h"
+
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+
+#include <stdint.h>
+
+/*
+ * ALS Implementation.
+ * Фоновый сбор отсчетов датчика освещенности.
+ *
+ * Схема:
+ * - АЦП в режиме free-running (adc_run), делитель задает частоту отсчетов.
+ * - FIFO АЦП с DREQ, канал DMA пишет в кольцевой буфер (write ring).
+ * - display_als_poll() по счетчику DMA определяет число новых отсчетов,
+ *   прогоняет их через EMA-фильтр и публикует уровень с гистерезисом.
+ *
+ * Процессор не ждет АЦП ни в одной из функций модуля.
+ */
+
+// ============================================================================
+//  КОНФИГУРАЦИЯ
+// ============================================================================
+
+#define ALS_RING_BITS          7                       // 128 байт = 64 отсчета
+#define ALS_RING_LEN           ((1u << ALS_RING_BITS) / sizeof(uint16_t))
+#define ALS_ADC_CLOCK_HZ       48000000u
+#define ALS_ADC_MIN_DIV        96u                     // Одно преобразование = 96 тактов
+#define ALS_DMA_COUNT          0xFFFFFFFFu             // ~49 дней при 1 кГц, затем перезапуск
+
+#define ALS_DEFAULT_RATE_HZ    1000u
+#define ALS_DEFAULT_SHIFT      4u
+#define ALS_DEFAULT_HYSTERESIS 2u
+
+// ============================================================================
+//  ВНУТРЕННЕЕ СОСТОЯНИЕ
+// ============================================================================
+
+/* Кольцо DMA: адрес должен быть выровнен по размеру кольца. */
+static uint16_t s_ring[ALS_RING_LEN] __attribute__((aligned(1u << ALS_RING_BITS)));
+
+typedef struct
+{
+    bool running;
+    bool primed;            // Фильтр получил первый отсчет
+    bool level_valid;       // Уровень уже публиковался
+
+    int      dma_chan;
+    uint8_t  filter_shift;
+    uint8_t  hysteresis;
+
+    uint32_t last_count;    // transfer_count DMA на момент прошлого опроса
+    uint32_t ema_q4;        // EMA, 12 бит + 4 дробных
+    uint8_t  level;         // Опубликованный уровень 0..255
+
+} display_als_state_t;
+
+static display_als_state_t s_als = { .dma_chan = -1 };
+
+// ============================================================================
+//  ВНУТРЕННИЕ ФУНКЦИИ
+// ============================================================================
+
+/* Запуск канала DMA: FIFO АЦП -> кольцевой буфер. */
+static void als_dma_arm(void)
+{
+    uint ch = (uint)s_als.dma_chan;
+    dma_channel_config c = dma_channel_get_default_config(ch);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_ring(&c, true, ALS_RING_BITS);
+    channel_config_set_dreq(&c, DREQ_ADC);
+
+    dma_channel_configure(ch, &c, s_ring, &adc_hw->fifo, ALS_DMA_COUNT, true);
+    s_als.last_count = ALS_DMA_COUNT;
+}
+
+/* Экспоненциальный фильтр (EMA) на сдвигах. */
+static inline void als_filter(uint16_t sample)
+{
+    int32_t x = (int32_t)(sample & 0x0FFFu) << 4;
+    if (!s_als.primed) {
+        s_als.ema_q4 = (uint32_t)x;
+        s_als.primed = true;
+        return;
+    }
+    int32_t ema = (int32_t)s_als.ema_q4;
+    ema += (x - ema) >> s_als.filter_shift;
+    s_als.ema_q4 = (uint32_t)ema;
+}
+
+// ============================================================================
+//  ПУБЛИЧНЫЙ API
+// ============================================================================
+
+bool display_als_start(const display_als_config_t *cfg)
+{
+    if (!cfg) return false;
+    if (cfg->adc_pin < 26 || cfg->adc_pin > 29) return false;
+
+    if (s_als.running) display_als_stop();
+
+    int ch = dma_claim_unused_channel(false);
+    if (ch < 0) return false;
+
+    uint32_t rate = cfg->sample_rate_hz ? cfg->sample_rate_hz : ALS_DEFAULT_RATE_HZ;
+    uint32_t div  = ALS_ADC_CLOCK_HZ / rate;
+    if (div < ALS_ADC_MIN_DIV) div = ALS_ADC_MIN_DIV;
+
+    s_als.dma_chan     = ch;
+    s_als.filter_shift = cfg->filter_shift ? cfg->filter_shift : ALS_DEFAULT_SHIFT;
+    s_als.hysteresis   = cfg->hysteresis ? cfg->hysteresis : ALS_DEFAULT_HYSTERESIS;
+    s_als.primed       = false;
+    s_als.level_valid  = false;
+
+    adc_init();
+    adc_gpio_init(cfg->adc_pin);
+    adc_select_input(cfg->adc_pin - 26u);
+    adc_fifo_setup(true,    // FIFO включен
+                   true,    // DREQ для DMA
+                   1,       // DREQ на каждый отсчет
+                   false,   // Без флага ошибки в данных
+                   false);  // 12 бит без сдвига
+    adc_set_clkdiv((float)(div - 1u));
+
+    als_dma_arm();
+    adc_run(true);
+
+    s_als.running = true;
+    return true;
+}
+
+void display_als_stop(void)
+{
+    if (!s_als.running) return;
+
+    adc_run(false);
+    dma_channel_abort((uint)s_als.dma_chan);
+    dma_channel_unclaim((uint)s_als.dma_chan);
+    adc_fifo_setup(false, false, 0, false, false);
+    adc_fifo_drain();
+
+    s_als.dma_chan = -1;
+    s_als.running  = false;
+}
+
+bool display_als_is_running(void) { return s_als.running; }
+
+bool display_als_poll(uint8_t *level)
+{
+    if (!s_als.running) return false;
+
+    uint ch = (uint)s_als.dma_chan;
+    dma_channel_hw_t *hw = dma_channel_hw_addr(ch);
+    uint32_t count = hw->transfer_count;
+    uint32_t wr    = hw->write_addr;
+
+    uint32_t produced = s_als.last_count - count;
+    s_als.last_count = count;
+
+    // Счетчик DMA исчерпан: перезапуск канала (кольцо продолжает заполняться)
+    if (!dma_channel_is_busy(ch)) als_dma_arm();
+
+    if (produced == 0) return false;
+    if (produced > ALS_RING_LEN) produced = ALS_RING_LEN; // Старые отсчеты уже перезаписаны
+
+    uint32_t head = (uint32_t)((wr - (uint32_t)(uintptr_t)s_ring) / sizeof(uint16_t));
+    for (uint32_t i = produced; i > 0; i--) {
+        als_filter(s_ring[(head - i) & (ALS_RING_LEN - 1u)]);
+    }
+
+    uint8_t new_level = (uint8_t)((s_als.ema_q4 * 255u) / (4095u << 4));
+    uint8_t diff = (new_level > s_als.level) ? (new_level - s_als.level) : (s_als.level - new_level);
+    if (s_als.level_valid && diff < s_als.hysteresis) return false;
+
+    s_als.level = new_level;
+    s_als.level_valid = true;
+    if (level) *level = new_level;
+    return true;
+}
+
+uint8_t display_als_get_level(void) { return s_als.level; }
+
+uint16_t display_als_get_raw(void) { return (uint16_t)(s_als.ema_q4 >> 4); }
@@ -0,0 +1,133 @@
+#include "display_anim.h"
+
+#include <string.h>
+
+/*
+ * Animation Player.
+ * Потоковое декодирование команд анимации прямо из flash.
+ * За один вызов display_anim_next_frame() применяются команды до ближайшей
+ * SHOW; кадр накапливается в p->frame (delta к предыдущему кадру).
+ */
+
+// ============================================================================
+//  ВНУТРЕННИЕ ФУНКЦИИ
+// ============================================================================
+
+/* Запись маски в диапазон разрядов с отсечением по ширине кадра. */
+static inline void anim_fill(display_anim_player_t *p, uint8_t start, uint8_t count, vfd_segment_map_t seg)
+{
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t pos = (uint8_t)(start + i);
+        if (pos >= VFD_MAX_DIGITS) break;
+        p->frame[pos] = seg;
+    }
+}
+
+// ============================================================================
+//  ПУБЛИЧНЫЙ API
+// ============================================================================
+
+void display_anim_begin(display_anim_player_t *p, const display_anim_t *anim)
+{
+    if (!p) return;
+    memset(p, 0, sizeof(*p));
+    p->anim = anim;
+}
+
+bool display_anim_next_frame(display_anim_player_t *p, uint32_t *frame_ms)
+{
+    if (!p || !p->anim || !p->anim->data) return false;
+    const uint8_t *d = p->anim->data;
+    uint16_t len = p->anim->len;
+
+    for (;;) {
+        if (p->pc >= len || d[p->pc] == DISPLAY_ANIM_OP_END) {
+            // Конец прохода: пустая последовательность не зацикливается
+            if (!p->shown) return false;
+            p->loop++;
+            if (p->anim->loops != 0 && p->loop >= p->anim->loops) return false;
+            p->pc = 0;
+            p->shown = false;
+            continue;
+        }
+
+        uint8_t op = d[p->pc];
+        uint8_t arg_len = 0;
+        switch (op & 0xF0u) {
+            case DISPLAY_ANIM_OP_SET:  arg_len = 1; break;
+            case DISPLAY_ANIM_OP_RUN:  arg_len = 2; break;
+            case DISPLAY_ANIM_OP_FILL: // FILL / CLEAR
+                if (op == DISPLAY_ANIM_OP_FILL)       arg_len = 1;
+                else if (op != DISPLAY_ANIM_OP_CLEAR) return false;
+                break;
+            case DISPLAY_ANIM_OP_BRIGHT:
+            case DISPLAY_ANIM_OP_SHOW: arg_len = 1; break;
+            default:                   return false; // Неизвестная команда
+        }
+        if ((uint32_t)p->pc + 1u + arg_len > len) return false;
+        const uint8_t *a = &d[p->pc + 1u];
+        p->pc = (uint16_t)(p->pc + 1u + arg_len);
+
+        switch (op & 0xF0u) {
+            case DISPLAY_ANIM_OP_SET:
+                anim_fill(p, op & 0x0Fu, 1, a[0]);
+                break;
+            case DISPLAY_ANIM_OP_RUN:
+                anim_fill(p, a[0], (uint8_t)((op & 0x0Fu) + 1u), a[1]);
+                break;
+            case DISPLAY_ANIM_OP_FILL:
+                anim_fill(p, 0, VFD_MAX_DIGITS, (op == DISPLAY_ANIM_OP_FILL) ? a[0] : 0);
+                break;
+            case DISPLAY_ANIM_OP_BRIGHT:
+                p->brightness = a[0];
+                p->bright_set = true;
+                break;
+            case DISPLAY_ANIM_OP_SHOW:
+                p->shown = true;
+                if (frame_ms) *frame_ms = (uint32_t)a[0] * DISPLAY_ANIM_TICK_MS;
+                return true;
+        }
+    }
+}
+
+/* Проход по потоку без декодирования кадров: число кадров и сумма длительностей. */
+static uint16_t anim_scan(const display_anim_t *anim, uint32_t default_frame_ms, uint32_t *total_ms)
+{
+    uint16_t frames = 0;
+    uint32_t ms = 0;
+    uint16_t pc = 0;
+    while (pc < anim->len && anim->data[pc] != DISPLAY_ANIM_OP_END) {
+        uint8_t op = anim->data[pc];
+        switch (op & 0xF0u) {
+            case DISPLAY_ANIM_OP_SET:    pc += 2; break;
+            case DISPLAY_ANIM_OP_RUN:    pc += 3; break;
+            case DISPLAY_ANIM_OP_FILL:   pc += (op == DISPLAY_ANIM_OP_FILL) ? 2 : 1; break;
+            case DISPLAY_ANIM_OP_BRIGHT: pc += 2; break;
+            case DISPLAY_ANIM_OP_SHOW:
+                if (pc + 1u < anim->len) {
+                    uint32_t t = (uint32_t)anim->data[pc + 1u] * DISPLAY_ANIM_TICK_MS;
+                    ms += t ? t : default_frame_ms;
+                }
+                pc += 2;
+                frames++;
+                break;
+            default:                     pc = anim->len; break;
+        }
+    }
+    if (total_ms) *total_ms = ms;
+    return frames;
+}
+
+uint16_t display_anim_frame_count(const display_anim_t *anim)
+{
+    if (!anim || !anim->data) return 0;
+    return anim_scan(anim, 0, NULL);
+}
+
+uint32_t display_anim_duration_ms(const display_anim_t *anim, uint32_t default_frame_ms)
+{
+    if (!anim || !anim->data || anim->loops == 0) return 0;
+    uint32_t ms = 0;
+    anim_scan(anim, default_frame_ms, &ms);
+    return ms * anim->loops;
+}
@@ -11,11 +11,11 @@
  * FIX #25: Безопасная обработка INT32_MIN через uint32_t во избежание UB и OOB-чтения.
  */
 
-extern void display_core_set_buffer(const vfd_segment_map_t *buf, uint8_t size);
+extern void display_core_set_buffer_ex(display_t *disp, const vfd_segment_map_t *buf, uint8_t size);
 
-static uint8_t get_active_digits(void)
+static uint8_t get_active_digits(const display_t *disp)
 {
-    uint8_t n = display_ll_get_digit_count();
+    uint8_t n = display_ll_get_digit_count_ex(&disp->ll);
     if (n == 0 || n > VFD_MAX_DIGITS) n = VFD_MAX_DIGITS;
     return n;
 }
@@ -24,11 +24,11 @@ static uint8_t get_active_digits(void)
  *     ВЫВОД ЧИСЕЛ
  * ============================================================ */
 
-void display_show_number(int32_t value)
+void display_render_number_ex(const display_t *disp, int32_t value, vfd_segment_map_t *buf)
 {
-    uint8_t digits = get_active_digits();
-    vfd_segment_map_t buf[VFD_MAX_DIGITS];
-    memset(buf, 0, sizeof(buf));
+    if (!disp || !buf) return;
+    uint8_t digits = get_active_digits(disp);
+    memset(buf, 0, digits * sizeof(vfd_segment_map_t));
 
     bool negative = (value < 0);
     
@@ -57,24 +57,38 @@ void display_show_number(int32_t value)
     }
     
     if (negative && digits > 0) buf[0] = display_font_get_char('-');
+}
 
-    display_core_set_buffer(buf, digits);
+void display_render_number(int32_t value, vfd_segment_map_t *buf)
+{
+    display_render_number_ex(g_display, value, buf);
 }
 
+void display_show_number_ex(display_t *disp, int32_t value)
+{
+    if (!disp) return;
+    vfd_segment_map_t buf[VFD_MAX_DIGITS];
+    display_render_number_ex(disp, value, buf);
+    display_core_set_buffer_ex(disp, buf, get_active_digits(disp));
+}
+
+void display_show_number(int32_t value) { display_show_number_ex(g_display, value); }
+
 /* ============================================================
  *     ВЫВОД ВРЕМЕНИ
  * ============================================================ */
 
-void display_show_time(uint8_t hours, uint8_t minutes, bool show_colon)
+void display_show_time_ex(display_t *disp, uint8_t hours, uint8_t minutes, bool show_colon)
 {
     (void)show_colon; 
+    if (!disp) return;
 
-    uint8_t digits = get_active_digits();
+    uint8_t digits = get_active_digits(disp);
     vfd_segment_map_t buf[VFD_MAX_DIGITS];
     memset(buf, 0, sizeof(buf));
 
     if (digits < 4) {
-        display_show_number((int32_t)(hours * 100 + minutes));
+        display_show_number_ex(disp, (int32_t)(hours * 100 + minutes));
         return;
     }
 
@@ -83,21 +97,27 @@ void display_show_time(uint8_t hours, uint8_t minutes, bool show_colon)
     buf[2] = display_font_digit(minutes / 10);
     buf[3] = display_font_digit(minutes % 10);
 
-    display_core_set_buffer(buf, digits);
+    display_core_set_buffer_ex(disp, buf, digits);
+}
+
+void display_show_time(uint8_t hours, uint8_t minutes, bool show_colon)
+{
+    display_show_time_ex(g_display, hours, minutes, show_colon);
 }
 
 /* ============================================================
  *     ВЫВОД ДАТЫ
  * ============================================================ */
 
-void display_show_date(uint8_t day, uint8_t month)
+void display_show_date_ex(display_t *disp, uint8_t day, uint8_t month)
 {
-    uint8_t digits = get_active_digits();
+    if (!disp) return;
+    uint8_t digits = get_active_digits(disp);
     vfd_segment_map_t buf[VFD_MAX_DIGITS];
     memset(buf, 0, sizeof(buf));
 
     if (digits < 4) {
-        display_show_number((int32_t)(day * 100 + month));
+        display_show_number_ex(disp, (int32_t)(day * 100 + month));
         return;
     }
 
@@ -106,21 +126,24 @@ void display_show_date(uint8_t day, uint8_t month)
     buf[2] = display_font_digit(month / 10);
     buf[3] = display_font_digit(month % 10);
     
-    display_core_set_buffer(buf, digits);
+    display_core_set_buffer_ex(disp, buf, digits);
 }
 
+void display_show_date(uint8_t day, uint8_t month) { display_show_date_ex(g_display, day, month); }
+
 /* ============================================================
  *     ВЫВОД ТЕКСТА
  * ============================================================ */
 
-void display_show_text(const char *text)
+void display_show_text_ex(display_t *disp, const char *text)
 {
-    uint8_t digits = get_active_digits();
+    if (!disp) return;
+    uint8_t digits = get_active_digits(disp);
     vfd_segment_map_t buf[VFD_MAX_DIGITS];
     memset(buf, 0, sizeof(buf));
 
     if (!text) {
-        display_core_set_buffer(buf, digits);
+        display_core_set_buffer_ex(disp, buf, digits);
         return;
     }
     
@@ -141,5 +164,7 @@ void display_show_text(const char *text)
         buf_idx++;
     }
 
-    display_core_set_buffer(buf, digits);
-}
\ No newline at end of file
+    display_core_set_buffer_ex(disp, buf, digits);
+}
+
+void display_show_text(const char *text) { display_show_text_ex(g_display, text); }
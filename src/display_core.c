@@ -1,7 +1,10 @@
 #include "display_api.h"
 #include "display_ll.h"
 #include "display_state.h"
+#include "display_als.h"
+#include "display_fx.h"
 #include "logging.h"
+#include "display_trace.h"
 
 #include "pico/stdlib.h"
 #include "hardware/adc.h"
@@ -19,7 +22,11 @@
  */
 
 static display_state_t g_display_state;
-display_state_t *const g_display = &g_display_state;
+display_state_t *g_display = &g_display_state;
+
+/* Инициализированные экземпляры (для display_process_all) */
+static display_t *s_instances[DISPLAY_MAX_INSTANCES];
+static uint8_t    s_instance_count = 0;
 
 /* Конфигурация по умолчанию */
 #define DISPLAY_DEFAULT_DATA_PIN      15
@@ -32,6 +39,7 @@ display_state_t *const g_display = &g_display_state;
 #define DISPLAY_BRIGHTNESS_NIGHT      10   
 #define DISPLAY_BRIGHTNESS_UPDATE_MS  1000 
 #define DISPLAY_BRIGHTNESS_HYSTERESIS 2    
+#define DISPLAY_BRIGHTNESS_RAMP_MS    1500 // Длительность плавного перехода яркости
 
 #define DOT_DEFAULT_PERIOD_MS         1000 
 #define DOT_DEFAULT_BIT               7    
@@ -43,21 +51,12 @@ display_state_t *const g_display = &g_display_state;
 
 static bool core_is_fx_segment_blocking(void) {
     if (!g_display->fx_active) return false;
-    switch (g_display->fx_type) {
-        case FX_GLITCH: case FX_MORPH: case FX_DISSOLVE:
-        case FX_MARQUEE: case FX_SLIDE_IN: case FX_SLOT_MACHINE:
-        case FX_DECODE: case FX_PINGPONG: return true;
-        default: return false;
-    }
+    return (display_fx_get_flags() & DISPLAY_FX_FLAG_BLOCKING) != 0;
 }
 
 static bool core_does_fx_control_brightness(void) {
     if (!g_display->fx_active) return false;
-    switch (g_display->fx_type) {
-        case FX_FADE_IN: case FX_FADE_OUT: case FX_PULSE:
-        case FX_WAVE: case FX_MATRIX: case FX_HEARTBEAT: return true;
-        default: return false;
-    }
+    return (display_fx_get_flags() & DISPLAY_FX_FLAG_BRIGHTNESS) != 0;
 }
 
 /*
@@ -87,6 +86,7 @@ static inline vfd_segment_map_t core_apply_dots(uint8_t idx, vfd_segment_map_t s
 
 static void core_push_brightness_to_ll(uint8_t level) {
     if (!display_ll_is_initialized()) return;
+    DISPLAY_TRACE(DISPLAY_TRACE_BRIGHTNESS, &g_display->ll, level, 0);
     display_ll_set_brightness_all(level);
 }
 
@@ -98,33 +98,122 @@ static void core_push_content_to_ll(void)
     // Защита от выхода за пределы массива
     if (digits > VFD_MAX_DIGITS) digits = VFD_MAX_DIGITS;
 
+    vfd_segment_map_t frame[VFD_MAX_DIGITS];
     for (uint8_t i = 0; i < digits; i++) {
-        vfd_segment_map_t seg = g_display->content_buffer[i];
-        
         // Наложение точек вынесено в отдельную функцию (Refactor #8)
-        seg = core_apply_dots(i, seg);
-        
-        display_ll_set_digit_raw(i, seg);
+        frame[i] = core_apply_dots(i, g_display->content_buffer[i]);
+    }
+
+    // Публикация кадра одним вызовом: LL пересчитывает ограничитель мощности раз на кадр
+    display_ll_set_frame(frame, digits);
+}
+
+/*
+ * Публикация базового уровня яркости.
+ * Во время FX яркости уровень становится новой амплитудой эффекта (fx_base_brightness),
+ * иначе уходит в LL — и только если отличается от уже опубликованного.
+ */
+static void core_publish_level(uint8_t level) {
+    g_display->brightness_level = level;
+    if (g_display->fx_active) g_display->fx_base_brightness = level;
+    if (core_does_fx_control_brightness()) return;
+
+    bool changed = false;
+    for (uint8_t i = 0; i < g_display->digit_count; i++) {
+        if (g_display->final_brightness[i] != level) {
+            g_display->final_brightness[i] = level;
+            changed = true;
+        }
     }
+    if (changed) core_push_brightness_to_ll(level);
 }
 
-static uint16_t core_read_adc_filtered(uint16_t adc_pin) {
-    uint16_t input = 0;
-    if (adc_pin >= 26 && adc_pin <= 29) input = (uint16_t)(adc_pin - 26);
-    adc_select_input(input);
-    uint32_t acc = 0;
-    for (uint8_t i = 0; i < 8; i++) acc += adc_read();
-    return (uint16_t)(acc / 8);
+/*
+ * Запуск плавного перехода к уровню target за ramp_ms.
+ * Интерполяция идет в гамма-домене (воспринимаемая яркость), поэтому переход
+ * выглядит равномерным и на низких, и на высоких уровнях.
+ * Повторный вызов с той же целью не перезапускает переход.
+ */
+static void core_ramp_to(uint8_t target, uint32_t ramp_ms) {
+    uint8_t current = g_display->brightness_level;
+
+    if (ramp_ms == 0 || target == current) {
+        g_display->ramp_active = false;
+        core_publish_level(target);
+        return;
+    }
+    if (g_display->ramp_active && g_display->ramp_to == target) return;
+
+    int32_t from_p = display_ll_gamma_inverse(current);
+    int32_t to_p   = display_ll_gamma_inverse(target);
+
+    // Единственное деление перехода — при запуске
+    g_display->ramp_to       = target;
+    g_display->ramp_p_q16    = from_p << 16;
+    g_display->ramp_step_q16 = (to_p - from_p) * 65536 / (int32_t)ramp_ms;
+    g_display->ramp_left_us  = ramp_ms * 1000u;
+    g_display->ramp_last_us  = time_us_32();
+    g_display->ramp_carry_us = 0;
+    g_display->ramp_active   = true;
 }
 
-static void core_update_brightness_now(void) {
+/*
+ * Шаг перехода: позиция продвигается на ramp_step_q16 за каждую прошедшую мс.
+ * Время — беззнаковая 32-битная разность, миллисекунды отсчитываются вычитанием
+ * (в сумме не больше одного вычитания на мс перехода), делений нет.
+ * Публикуется только изменившийся уровень.
+ */
+static void core_ramp_tick(absolute_time_t now) {
+    if (!g_display->ramp_active) return;
+
+    uint32_t now_us = (uint32_t)to_us_since_boot(now);
+    g_display->ramp_carry_us += now_us - g_display->ramp_last_us;
+    g_display->ramp_last_us = now_us;
+
+    if (g_display->ramp_carry_us >= g_display->ramp_left_us) {
+        g_display->ramp_active = false;
+        core_publish_level(g_display->ramp_to);
+        return;
+    }
+
+    while (g_display->ramp_carry_us >= 1000u) {
+        g_display->ramp_carry_us -= 1000u;
+        g_display->ramp_left_us  -= 1000u;
+        g_display->ramp_p_q16    += g_display->ramp_step_q16;
+    }
+
+    int32_t p = (g_display->ramp_p_q16 + 0x8000) >> 16;
+    if (p < 0) p = 0;
+    if (p > VFD_MAX_BRIGHTNESS) p = VFD_MAX_BRIGHTNESS;
+
+    uint8_t level = display_ll_apply_gamma((uint8_t)p);
+    if (level != g_display->brightness_level) core_publish_level(level);
+}
+
+/* Включение/выключение фонового опроса датчика освещенности. */
+static void core_als_enable(bool enable) {
+    if (!enable) {
+        display_als_stop();
+        return;
+    }
+    if (display_als_is_running()) return;
+
+    display_als_config_t cfg = g_display->als_config;
+    cfg.adc_pin = g_display->adc_pin;
+    if (!display_als_start(&cfg)) {
+        LOG_ERROR("display: ALS start failed");
+    }
+}
+
+/*
+ * Расчет целевого уровня (пользовательский / ночной) и переход к нему.
+ * В режиме автояркости цель задает датчик (core_brightness_tick).
+ */
+static void core_update_brightness_now(uint32_t ramp_ms) {
+    if (g_display->auto_brightness_enabled) return;
+
     uint8_t new_level = g_display->user_brightness_level;
-    if (g_display->auto_brightness_enabled) {
-        uint16_t raw = core_read_adc_filtered((uint16_t)g_display->adc_pin); 
-        uint8_t level = (uint8_t)((uint32_t)raw * VFD_MAX_BRIGHTNESS / 4095u);
-        if (level < DISPLAY_BRIGHTNESS_MIN_AUTO) level = DISPLAY_BRIGHTNESS_MIN_AUTO;
-        new_level = level;
-    } else if (g_display->night_mode_enabled && rtc_running()) {
+    if (g_display->night_mode_enabled && rtc_running()) {
         datetime_t dt; rtc_get_datetime(&dt);
         uint8_t start = g_display->night_start_hour;
         uint8_t end = g_display->night_end_hour;
@@ -133,23 +222,26 @@ static void core_update_brightness_now(void) {
     }
     if (new_level > VFD_MAX_BRIGHTNESS) new_level = VFD_MAX_BRIGHTNESS;
 
-    if (g_display->fx_active) g_display->fx_base_brightness = new_level;
-    if (core_does_fx_control_brightness()) return;
-
-    uint8_t current = g_display->final_brightness[0];
-    uint8_t diff = (current > new_level) ? (current - new_level) : (new_level - current);
-    if (diff < DISPLAY_BRIGHTNESS_HYSTERESIS && !g_display->fx_active) return;
-
-    for (uint8_t i = 0; i < g_display->digit_count; i++) g_display->final_brightness[i] = new_level;
-    core_push_brightness_to_ll(new_level);
+    core_ramp_to(new_level, ramp_ms);
 }
 
 static void core_brightness_tick(absolute_time_t now) {
     if (g_display->ov_active) return;
-    if (!(g_display->auto_brightness_enabled || g_display->night_mode_enabled)) return;
+
+    // Автояркость: забираем накопленные отсчеты датчика (без ожидания АЦП)
+    if (g_display->auto_brightness_enabled) {
+        uint8_t level;
+        if (display_als_poll(&level)) {
+            if (level < DISPLAY_BRIGHTNESS_MIN_AUTO) level = DISPLAY_BRIGHTNESS_MIN_AUTO;
+            core_ramp_to(level, g_display->ramp_ms);
+        }
+        return;
+    }
+
+    if (!g_display->night_mode_enabled) return;
     if (to_ms_since_boot(now) - to_ms_since_boot(g_display->brightness_last_update) < g_display->brightness_update_period_ms) return;
     g_display->brightness_last_update = now;
-    core_update_brightness_now();
+    core_update_brightness_now(g_display->ramp_ms);
 }
 
 static void core_dot_blink_tick(absolute_time_t now)
@@ -167,19 +259,76 @@ static void core_dot_blink_tick(absolute_time_t now)
     core_push_content_to_ll();
 }
 
+/* Учет экземпляра для display_process_all(). false — заняты все DISPLAY_MAX_INSTANCES мест. */
+static bool core_register_instance(display_t *disp)
+{
+    for (uint8_t i = 0; i < s_instance_count; i++) {
+        if (s_instances[i] == disp) return true;
+    }
+    if (s_instance_count >= DISPLAY_MAX_INSTANCES) {
+        LOG_ERROR("display: instance limit (%d) reached", DISPLAY_MAX_INSTANCES);
+        return false;
+    }
+    s_instances[s_instance_count++] = disp;
+    return true;
+}
+
+/*
+ * Вызовы display_*_ex: модули HL работают через g_display, поэтому на время
+ * вызова экземпляр становится текущим, затем выбор восстанавливается.
+ * Выбор LL, как и в display_select(), следует за экземпляром HL.
+ * Обработчики on_*_finished внутри вызова видят текущим свой экземпляр.
+ */
+display_t *display_core_enter(display_t *disp)
+{
+    display_t *prev = g_display;
+    g_display = disp;
+    display_ll_select(&disp->ll);
+    return prev;
+}
+
+void display_core_leave(display_t *prev)
+{
+    g_display = prev;
+    display_ll_select(&prev->ll);
+}
+
 // ============================================================================
 //  Реализация API
 // ============================================================================
 
+display_t *display_select(display_t *disp)
+{
+    display_t *prev = g_display;
+    g_display = disp ? disp : &g_display_state;
+    display_ll_select(&g_display->ll);
+    return prev;
+}
+
+display_t *display_current(void) { return g_display; }
+
+/* Этапы отложенной инициализации (display_init_fast), по одному за display_process(). */
+enum {
+    CORE_BOOT_DONE = 0,
+    CORE_BOOT_ADC,          // Инициализация АЦП датчика освещенности
+    CORE_BOOT_FX,           // Посев генератора эффектов
+    CORE_BOOT_BRIGHTNESS,   // Переход от яркости загрузочного кадра к пользовательской
+    CORE_BOOT_LOG,          // Отчет в лог
+};
+
 /*
- * FIX #5: Основная логика инициализации перенесена сюда.
- * Принимает готовую структуру конфигурации.
+ * Сброс состояния экземпляра и параметры по умолчанию.
+ * Повторная инициализация: драйвер отключается от общего таймера до очистки состояния.
+ * Арена пользовательских эффектов задается приложением и переживает переинициализацию.
  */
-void display_init_ex(const display_ll_config_t *cfg)
+static void core_reset_state(const display_ll_config_t *cfg)
 {
-    if (!cfg) return;
-
-    memset(&g_display_state, 0, sizeof(g_display_state));
+    display_ll_deinit();
+    void  *fx_arena = g_display->fx_arena;
+    size_t fx_arena_size = g_display->fx_arena_size;
+    memset(g_display, 0, sizeof(*g_display));
+    g_display->fx_arena = fx_arena;
+    g_display->fx_arena_size = fx_arena_size;
 
     // Копируем параметры из конфига в состояние ядра
     g_display->digit_count = cfg->digit_count;
@@ -194,9 +343,12 @@ void display_init_ex(const display_ll_config_t *cfg)
     // ADC пин пока остается стандартным (так как его нет в ll_config),
     // но его можно будет изменить отдельным сеттером в будущем.
     g_display->adc_pin = DISPLAY_DEFAULT_ADC_PIN;
+    g_display->als_config.hysteresis = DISPLAY_BRIGHTNESS_HYSTERESIS;
     
     g_display->brightness_update_period_ms = DISPLAY_BRIGHTNESS_UPDATE_MS;
     g_display->brightness_last_update = get_absolute_time();
+    g_display->brightness_level = VFD_MAX_BRIGHTNESS;
+    g_display->ramp_ms = DISPLAY_BRIGHTNESS_RAMP_MS;
     g_display->dot_period_ms = DOT_DEFAULT_PERIOD_MS;
     g_display->dot_last_toggle = get_absolute_time();
     g_display->dot_map = DOT_DEFAULT_MASK; 
@@ -207,31 +359,167 @@ void display_init_ex(const display_ll_config_t *cfg)
         g_display->content_brightness[i] = VFD_MAX_BRIGHTNESS;
         g_display->final_brightness[i] = VFD_MAX_BRIGHTNESS;
     }
+}
+
+/* Инициализация периферии (ADC) */
+static void core_adc_init(void)
+{
+    adc_init();
+    adc_gpio_init((uint)g_display->adc_pin);
+    if (g_display->adc_pin >= 26 && g_display->adc_pin <= 29) {
+        adc_select_input(g_display->adc_pin - 26);
+    }
+}
+
+extern void display_fx_warmup(void);
+
+/* Очередной шаг отложенной инициализации. */
+static void core_boot_tick(void)
+{
+    switch (g_display->boot_stage) {
+        case CORE_BOOT_ADC:
+            core_adc_init();
+            break;
+        case CORE_BOOT_FX:
+            display_fx_warmup();
+            break;
+        case CORE_BOOT_BRIGHTNESS:
+            core_update_brightness_now(g_display->ramp_ms);
+            break;
+        case CORE_BOOT_LOG: {
+            display_ll_stats_t st;
+            display_ll_get_stats(&st);
+            LOG_INFO("display_init_fast: first frame at %lu us, init at %lu us",
+                     (unsigned long)st.first_frame_us, (unsigned long)g_display->boot_init_us);
+            uint32_t now = time_us_32();
+            g_display->boot_ready_us = now ? now : 1;
+            g_display->boot_stage = CORE_BOOT_DONE;
+            return;
+        }
+        default:
+            g_display->boot_stage = CORE_BOOT_DONE;
+            return;
+    }
+    g_display->boot_stage++;
+}
+
+/*
+ * FIX #5: Основная логика инициализации перенесена сюда.
+ * Принимает готовую структуру конфигурации.
+ */
+static bool core_init(const display_ll_config_t *cfg)
+{
+    if (!cfg) return false;
+    if (!core_register_instance(g_display)) return false;
+
+    uint32_t t0 = time_us_32();
+    core_reset_state(cfg);
+    g_display->boot_init_us = t0 ? t0 : 1;
 
     // Инициализация драйвера с переданным конфигом
     if (!display_ll_init(cfg)) {
         LOG_ERROR("display_init_ex: LL init failed");
-        return;
+        return false;
     }
     display_ll_start_refresh();
 
-    // Инициализация периферии (ADC)
-    adc_init();
-    adc_gpio_init((uint)g_display->adc_pin);
-    if (g_display->adc_pin >= 26 && g_display->adc_pin <= 29) {
-        adc_select_input(g_display->adc_pin - 26);
-    }
+    core_adc_init();
 
     // Первичное обновление
     // Принудительно вызываем update_now, чтобы применить яркость
     // Для этого временно разрешаем автояркость, если она нужна, или ставим максимум
-    core_update_brightness_now();
+    core_update_brightness_now(0);
     core_push_content_to_ll();
     
     g_display->initialized = true;
     LOG_INFO("display_init_ex: Success");
+
+    uint32_t t1 = time_us_32();
+    g_display->boot_ready_us = t1 ? t1 : 1;
+    return true;
+}
+
+bool display_init_instance(display_t *disp, const display_ll_config_t *cfg)
+{
+    if (!disp) return false;
+    display_t *prev = display_core_enter(disp);
+    bool ok = core_init(cfg);
+    display_core_leave(prev);
+    return ok;
 }
 
+void display_init_ex(const display_ll_config_t *cfg) { display_init_instance(g_display, cfg); }
+
+/*
+ * Быстрый старт.
+ * Кадр и яркость публикуются в LL до запуска развертки, поэтому первый же слот
+ * показывает загрузочный кадр. Все, что не нужно для вывода, выполняет display_process().
+ */
+static bool core_init_fast(const display_ll_config_t *cfg, const display_boot_config_t *boot)
+{
+    if (!cfg) return false;
+    if (!core_register_instance(g_display)) return false;
+
+    uint32_t t0 = time_us_32();
+    core_reset_state(cfg);
+    g_display->boot_init_us = t0 ? t0 : 1;
+
+    uint8_t level = VFD_MAX_BRIGHTNESS;
+    if (boot) {
+        if (boot->frame) {
+            uint8_t n = boot->frame_len;
+            if (n > g_display->digit_count) n = g_display->digit_count;
+            if (n > VFD_MAX_DIGITS) n = VFD_MAX_DIGITS;
+            memcpy(g_display->content_buffer, boot->frame, n);
+        }
+        if (boot->brightness) level = boot->brightness;
+    }
+    g_display->brightness_level = level;
+    for (uint8_t i = 0; i < VFD_MAX_DIGITS; i++) g_display->final_brightness[i] = level;
+
+    if (!display_ll_init(cfg)) {
+        LOG_ERROR("display_init_fast: LL init failed");
+        return false;
+    }
+
+    g_display->initialized = true;
+    core_push_brightness_to_ll(level);
+    core_push_content_to_ll();
+    display_ll_start_refresh();
+
+    g_display->boot_stage = CORE_BOOT_ADC;
+    return true;
+}
+
+bool display_init_fast_instance(display_t *disp, const display_ll_config_t *cfg,
+                                const display_boot_config_t *boot)
+{
+    if (!disp) return false;
+    display_t *prev = display_core_enter(disp);
+    bool ok = core_init_fast(cfg, boot);
+    display_core_leave(prev);
+    return ok;
+}
+
+void display_init_fast(const display_ll_config_t *cfg, const display_boot_config_t *boot)
+{
+    display_init_fast_instance(g_display, cfg, boot);
+}
+
+bool display_get_boot_stats_ex(const display_t *disp, display_boot_stats_t *out)
+{
+    if (!disp || !out || !disp->boot_init_us) return false;
+
+    display_ll_stats_t st;
+    display_ll_get_stats_ex(&disp->ll, &st);
+    out->init_us        = disp->boot_init_us;
+    out->first_frame_us = st.first_frame_us;
+    out->ready_us       = disp->boot_ready_us;
+    return true;
+}
+
+bool display_get_boot_stats(display_boot_stats_t *out) { return display_get_boot_stats_ex(g_display, out); }
+
 
 
 void display_init(uint8_t digit_count)
@@ -249,57 +537,135 @@ void display_init(uint8_t digit_count)
     display_init_ex(&cfg);
 }
 
-display_mode_t display_get_mode(void) {
-    if (g_display->ov_active) return DISPLAY_MODE_OVERLAY;
-    if (g_display->fx_active) return DISPLAY_MODE_EFFECT;
+display_mode_t display_get_mode_ex(const display_t *disp) {
+    if (!disp) return DISPLAY_MODE_CONTENT;
+    if (disp->ov_active) return DISPLAY_MODE_OVERLAY;
+    if (disp->fx_active) return DISPLAY_MODE_EFFECT;
     return DISPLAY_MODE_CONTENT;
 }
 
+display_mode_t display_get_mode(void) { return display_get_mode_ex(g_display); }
+
 extern bool display_fx_is_running(void);
 extern bool display_is_overlay_running(void);
-bool display_is_effect_running(void) { return display_fx_is_running(); }
+bool display_is_effect_running_ex(const display_t *disp) { return disp && disp->fx_active; }
+bool display_is_effect_running(void) { return display_is_effect_running_ex(g_display); }
 
-void display_set_brightness(uint8_t brightness) {
+static void core_set_brightness(uint8_t brightness) {
     if (brightness > VFD_MAX_BRIGHTNESS) brightness = VFD_MAX_BRIGHTNESS;
     g_display->user_brightness_level = brightness;
     
     if (!g_display->auto_brightness_enabled && !g_display->night_mode_enabled) {
-        if (!g_display->fx_active || !core_does_fx_control_brightness()) {
-             for (uint8_t i = 0; i < g_display->digit_count; i++) 
-                g_display->final_brightness[i] = brightness;
-            core_push_brightness_to_ll(brightness);
-        }
-        if (g_display->fx_active) g_display->fx_base_brightness = brightness;
+        // Явная установка пользователем применяется сразу
+        core_ramp_to(brightness, 0);
     } else {
-        core_update_brightness_now();
+        core_update_brightness_now(g_display->ramp_ms);
     }
 }
 
-void display_set_auto_brightness(bool enable) {
+void display_set_brightness_ex(display_t *disp, uint8_t brightness) {
+    if (!disp) return;
+    display_t *prev = display_core_enter(disp);
+    core_set_brightness(brightness);
+    display_core_leave(prev);
+}
+
+void display_set_brightness(uint8_t brightness) { display_set_brightness_ex(g_display, brightness); }
+
+void display_set_brightness_ramp_ex(display_t *disp, uint32_t ramp_ms) {
+    if (!disp) return;
+    // Шаг Q16 делится на ramp_ms как int32_t, бюджет перехода хранится в мкс (uint32_t)
+    if (ramp_ms > DISPLAY_BRIGHTNESS_RAMP_MAX_MS) ramp_ms = DISPLAY_BRIGHTNESS_RAMP_MAX_MS;
+    disp->ramp_ms = ramp_ms;
+}
+
+void display_set_brightness_ramp(uint32_t ramp_ms) { display_set_brightness_ramp_ex(g_display, ramp_ms); }
+
+static void core_set_auto_brightness(bool enable) {
     g_display->auto_brightness_enabled = enable;
     if (enable) g_display->night_mode_enabled = false;
-    core_update_brightness_now();
+    core_als_enable(enable);
+    core_update_brightness_now(g_display->ramp_ms);
+}
+
+void display_set_auto_brightness_ex(display_t *disp, bool enable) {
+    if (!disp) return;
+    display_t *prev = display_core_enter(disp);
+    core_set_auto_brightness(enable);
+    display_core_leave(prev);
+}
+
+void display_set_auto_brightness(bool enable) { display_set_auto_brightness_ex(g_display, enable); }
+
+static bool core_set_als_config(const display_als_config_t *cfg) {
+    if (cfg->adc_pin != 0 && (cfg->adc_pin < 26 || cfg->adc_pin > 29)) return false;
+
+    if (cfg->adc_pin) g_display->adc_pin = cfg->adc_pin;
+    g_display->als_config = *cfg;
+    if (!g_display->als_config.hysteresis) g_display->als_config.hysteresis = DISPLAY_BRIGHTNESS_HYSTERESIS;
+
+    // Работающий датчик перезапускается с новыми параметрами
+    if (!display_als_is_running()) return true;
+    display_als_stop();
+    core_als_enable(true);
+    return display_als_is_running();
+}
+
+bool display_set_als_config_ex(display_t *disp, const display_als_config_t *cfg) {
+    if (!disp || !cfg) return false;
+    display_t *prev = display_core_enter(disp);
+    bool ok = core_set_als_config(cfg);
+    display_core_leave(prev);
+    return ok;
 }
 
-void display_set_night_mode(bool enable) {
+bool display_set_als_config(const display_als_config_t *cfg) { return display_set_als_config_ex(g_display, cfg); }
+
+static void core_set_night_mode(bool enable) {
     g_display->night_mode_enabled = enable;
-    if (enable) g_display->auto_brightness_enabled = false;
-    core_update_brightness_now();
+    if (enable) {
+        g_display->auto_brightness_enabled = false;
+        core_als_enable(false);
+    }
+    core_update_brightness_now(g_display->ramp_ms);
 }
 
-void display_set_dot_blinking(bool enable) {
+void display_set_night_mode_ex(display_t *disp, bool enable) {
+    if (!disp) return;
+    display_t *prev = display_core_enter(disp);
+    core_set_night_mode(enable);
+    display_core_leave(prev);
+}
+
+void display_set_night_mode(bool enable) { display_set_night_mode_ex(g_display, enable); }
+
+static void core_set_dot_blinking(bool enable) {
     g_display->dot_blink_enabled = enable;
     g_display->dot_state = false; 
     g_display->dot_last_toggle = get_absolute_time();
     core_push_content_to_ll();
 }
 
-void display_set_dots_config(uint16_t mask, bool blink) {
+void display_set_dot_blinking_ex(display_t *disp, bool enable) {
+    if (!disp) return;
+    display_t *prev = display_core_enter(disp);
+    core_set_dot_blinking(enable);
+    display_core_leave(prev);
+}
+
+void display_set_dot_blinking(bool enable) { display_set_dot_blinking_ex(g_display, enable); }
+
+void display_set_dots_config_ex(display_t *disp, uint16_t mask, bool blink) {
+    if (!disp) return;
+    display_t *prev = display_core_enter(disp);
     g_display->dot_map = mask;
-    display_set_dot_blinking(blink);
+    core_set_dot_blinking(blink);
+    display_core_leave(prev);
 }
 
-void display_core_set_buffer(const vfd_segment_map_t *buf, uint8_t size) {
+void display_set_dots_config(uint16_t mask, bool blink) { display_set_dots_config_ex(g_display, mask, blink); }
+
+static void core_set_buffer(const vfd_segment_map_t *buf, uint8_t size) {
     if (!g_display->initialized || !buf) return;
     
     uint8_t max_digits = g_display->digit_count;
@@ -312,6 +678,8 @@ void display_core_set_buffer(const vfd_segment_map_t *buf, uint8_t size) {
     if (copy_len < max_digits) {
         memset(g_display->content_buffer + copy_len, 0, max_digits - copy_len);
     }
+    DISPLAY_TRACE(DISPLAY_TRACE_CONTENT, &g_display->ll,
+                  display_trace_pack(g_display->content_buffer, max_digits), max_digits);
 
     if (!display_is_overlay_running()) {
         if (!core_is_fx_segment_blocking()) {
@@ -320,18 +688,39 @@ void display_core_set_buffer(const vfd_segment_map_t *buf, uint8_t size) {
     }
 }
 
-vfd_segment_map_t *display_content_buffer(void) { return g_display->content_buffer; }
+void display_core_set_buffer_ex(display_t *disp, const vfd_segment_map_t *buf, uint8_t size) {
+    if (!disp) return;
+    display_t *prev = display_core_enter(disp);
+    core_set_buffer(buf, size);
+    display_core_leave(prev);
+}
+
+void display_core_set_buffer(const vfd_segment_map_t *buf, uint8_t size) { display_core_set_buffer_ex(g_display, buf, size); }
+
+vfd_segment_map_t *display_content_buffer_ex(display_t *disp) { return disp ? disp->content_buffer : NULL; }
+vfd_segment_map_t *display_content_buffer(void) { return display_content_buffer_ex(g_display); }
 
 extern void display_fx_tick(void);
 extern void display_overlay_tick(void);
 
-void display_process(void)
+static void core_set_mode(display_mode_t mode)
+{
+    if (g_display->mode == mode) return;
+    DISPLAY_TRACE(DISPLAY_TRACE_MODE, &g_display->ll, g_display->mode, mode);
+    g_display->mode = mode;
+}
+
+static void core_process(void)
 {
     if (!g_display->initialized) return;
     absolute_time_t now = get_absolute_time();
 
+    // 0. Отложенная инициализация (display_init_fast): один шаг за вызов
+    if (g_display->boot_stage) core_boot_tick();
+
     // 1. Обновление яркости (теперь работает поверх FX)
     core_brightness_tick(now);
+    core_ramp_tick(now);
 
     // 2. Обработка оверлеев (Высший приоритет)
     if (display_is_overlay_running()) {
@@ -345,8 +734,12 @@ void display_process(void)
         }
         
         display_overlay_tick();
-        g_display->mode = DISPLAY_MODE_OVERLAY;
-        return;
+        if (display_is_overlay_running()) {
+            core_set_mode(DISPLAY_MODE_OVERLAY);
+            return;
+        }
+        // Оверлей завершился в этом тике: снимок экрана мог устареть (контент или
+        // точки менялись под оверлеем) — контент выводится в этом же вызове
     } else {
         g_display->ov_active = false;
     }
@@ -357,15 +750,30 @@ void display_process(void)
         display_fx_tick();
         
         if (core_is_fx_segment_blocking()) {
-            g_display->mode = DISPLAY_MODE_EFFECT;
+            core_set_mode(DISPLAY_MODE_EFFECT);
             return; 
         } 
-        g_display->mode = DISPLAY_MODE_CONTENT;
+        core_set_mode(DISPLAY_MODE_CONTENT);
     } else {
         g_display->fx_active = false;
-        g_display->mode = DISPLAY_MODE_CONTENT;
+        core_set_mode(DISPLAY_MODE_CONTENT);
     }
 
     core_dot_blink_tick(now);
     core_push_content_to_ll(); 
-}
\ No newline at end of file
+}
+
+void display_process_ex(display_t *disp)
+{
+    if (!disp) return;
+    display_t *prev = display_core_enter(disp);
+    core_process();
+    display_core_leave(prev);
+}
+
+void display_process(void) { display_process_ex(g_display); }
+
+void display_process_all(void)
+{
+    for (uint8_t i = 0; i < s_instance_count; i++) display_process_ex(s_instances[i]);
+}
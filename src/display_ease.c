@@ -0,0 +1,175 @@
+#include "display_ease.h"
+
+#include <stddef.h>
+
+/*
+ * Easing LUT.
+ * Таблицы: 256 точек на отрезке [0, 1], value = f(i / 255) * 65535.
+ * Кривые OUT_* получаются отражением IN_*: out(t) = 1 - in(1 - t).
+ *
+ *   in_cubic      = t^3
+ *   in_out_cubic  = t < 0.5 ? 4t^3 : 1 - (2 - 2t)^3 / 2
+ *   in_out_sine   = (1 - cos(pi * t)) / 2
+ *   in_expo       = t == 0 ? 0 : 2^(10t - 10)
+ *   out_bounce    = кусочно-квадратичная (n1 = 7.5625, d1 = 2.75)
+ */
+
+// ============================================================================
+//  ТАБЛИЦЫ
+// ============================================================================
+
+static const uint16_t s_ease_in_cubic[DISPLAY_EASE_LUT_SIZE] = {
+        0,    0,    0,    0,    0,    0,    1,    1,    2,    3,    4,    5,    7,    9,   11,   13,
+       16,   19,   23,   27,   32,   37,   42,   48,   55,   62,   69,   78,   87,   96,  107,  118,
+      130,  142,  155,  169,  184,  200,  217,  234,  253,  272,  293,  314,  337,  360,  385,  410,
+      437,  465,  494,  524,  556,  588,  622,  658,  694,  732,  771,  812,  854,  897,  942,  988,
+     1036, 1085, 1136, 1189, 1243, 1298, 1356, 1415, 1475, 1538, 1602, 1667, 1735, 1804, 1876, 1949,
+     2024, 2100, 2179, 2260, 2343, 2427, 2514, 2603, 2693, 2786, 2881, 2978, 3078, 3179, 3283, 3389,
+     3497, 3607, 3720, 3835, 3952, 4072, 4194, 4319, 4446, 4575, 4707, 4842, 4979, 5118, 5261, 5405,
+     5553, 5703, 5856, 6011, 6169, 6330, 6494, 6660, 6830, 7002, 7177, 7355, 7536, 7719, 7906, 8096,
+     8289, 8484, 8683, 8885, 9090, 9298, 9510, 9724, 9942,10163,10387,10614,10845,11079,11317,11557,
+    11802,12049,12300,12555,12813,13074,13339,13608,13880,14156,14435,14718,15005,15295,15589,15887,
+    16189,16494,16803,17117,17433,17754,18079,18408,18740,19077,19418,19762,20111,20464,20821,21182,
+    21547,21917,22290,22668,23050,23436,23827,24222,24621,25025,25433,25845,26262,26683,27109,27539,
+    27974,28413,28857,29306,29759,30217,30680,31147,31619,32095,32577,33063,33554,34050,34551,35056,
+    35567,36082,36602,37128,37658,38194,38734,39280,39830,40386,40947,41513,42084,42661,43243,43830,
+    44422,45019,45622,46231,46844,47463,48088,48718,49353,49994,50641,51293,51950,52614,53282,53957,
+    54637,55323,56014,56712,57415,58123,58838,59558,60285,61017,61755,62499,63249,64005,64767,65535,
+};
+
+static const uint16_t s_ease_in_out_cubic[DISPLAY_EASE_LUT_SIZE] = {
+        0,    0,    0,    0,    1,    2,    3,    5,    8,   12,   16,   21,   27,   35,   43,   53,
+       65,   78,   92,  108,  126,  146,  168,  192,  219,  247,  278,  311,  347,  386,  427,  471,
+      518,  568,  621,  678,  738,  801,  867,  938, 1012, 1090, 1171, 1257, 1347, 1441, 1539, 1641,
+     1748, 1860, 1976, 2097, 2223, 2354, 2489, 2630, 2776, 2928, 3085, 3247, 3415, 3588, 3768, 3953,
+     4144, 4342, 4545, 4755, 4971, 5193, 5423, 5658, 5901, 6150, 6406, 6670, 6940, 7217, 7502, 7795,
+     8094, 8402, 8717, 9040, 9370, 9709,10056,10410,10774,11145,11525,11913,12311,12716,13131,13555,
+    13987,14429,14880,15340,15809,16288,16777,17275,17783,18301,18829,19367,19915,20474,21042,21621,
+    22211,22811,23422,24044,24677,25320,25975,26641,27318,28007,28707,29419,30142,30878,31625,32384,
+    33151,33910,34657,35393,36116,36828,37528,38217,38894,39560,40215,40858,41491,42113,42724,43324,
+    43914,44493,45061,45620,46168,46706,47234,47752,48260,48758,49247,49726,50195,50655,51106,51548,
+    51980,52404,52819,53224,53622,54010,54390,54761,55125,55479,55826,56165,56495,56818,57133,57441,
+    57740,58033,58318,58595,58865,59129,59385,59634,59877,60112,60342,60564,60780,60990,61193,61391,
+    61582,61767,61947,62120,62288,62450,62607,62759,62905,63046,63181,63312,63438,63559,63675,63787,
+    63894,63996,64094,64188,64278,64364,64445,64523,64597,64668,64734,64797,64857,64914,64967,65017,
+    65064,65108,65149,65188,65224,65257,65288,65316,65343,65367,65389,65409,65427,65443,65457,65470,
+    65482,65492,65500,65508,65514,65519,65523,65527,65530,65532,65533,65534,65535,65535,65535,65535,
+};
+
+static const uint16_t s_ease_in_out_sine[DISPLAY_EASE_LUT_SIZE] = {
+        0,    2,   10,   22,   40,   62,   89,  122,  159,  201,  248,  300,  357,  419,  486,  558,
+      635,  716,  802,  894,  990, 1091, 1196, 1307, 1422, 1542, 1667, 1796, 1930, 2069, 2213, 2361,
+     2514, 2671, 2833, 2999, 3170, 3346, 3526, 3710, 3899, 4092, 4290, 4491, 4698, 4908, 5123, 5341,
+     5564, 5792, 6023, 6258, 6497, 6741, 6988, 7239, 7494, 7753, 8015, 8282, 8552, 8826, 9103, 9384,
+     9669, 9957,10248,10543,10842,11143,11448,11757,12068,12382,12700,13021,13344,13671,14000,14333,
+    14668,15006,15346,15690,16035,16384,16735,17088,17444,17802,18162,18524,18889,19256,19624,19995,
+    20368,20743,21119,21497,21877,22259,22642,23026,23413,23800,24189,24579,24971,25364,25757,26152,
+    26548,26945,27343,27741,28141,28541,28941,29342,29744,30146,30549,30952,31355,31758,32162,32566,
+    32969,33373,33777,34180,34583,34986,35389,35791,36193,36594,36994,37394,37794,38192,38590,38987,
+    39383,39778,40171,40564,40956,41346,41735,42122,42509,42893,43276,43658,44038,44416,44792,45167,
+    45540,45911,46279,46646,47011,47373,47733,48091,48447,48800,49151,49500,49845,50189,50529,50867,
+    51202,51535,51864,52191,52514,52835,53153,53467,53778,54087,54392,54693,54992,55287,55578,55866,
+    56151,56432,56709,56983,57253,57520,57782,58041,58296,58547,58794,59038,59277,59512,59743,59971,
+    60194,60412,60627,60837,61044,61245,61443,61636,61825,62009,62189,62365,62536,62702,62864,63021,
+    63174,63322,63466,63605,63739,63868,63993,64113,64228,64339,64444,64545,64641,64733,64819,64900,
+    64977,65049,65116,65178,65235,65287,65334,65376,65413,65446,65473,65495,65513,65525,65533,65535,
+};
+
+static const uint16_t s_ease_in_expo[DISPLAY_EASE_LUT_SIZE] = {
+        0,   66,   68,   69,   71,   73,   75,   77,   80,   82,   84,   86,   89,   91,   94,   96,
+       99,  102,  104,  107,  110,  113,  116,  120,  123,  126,  130,  133,  137,  141,  145,  149,
+      153,  157,  161,  166,  170,  175,  180,  185,  190,  195,  200,  206,  212,  217,  223,  230,
+      236,  242,  249,  256,  263,  270,  278,  285,  293,  301,  310,  318,  327,  336,  345,  355,
+      365,  375,  385,  395,  406,  418,  429,  441,  453,  466,  478,  492,  505,  519,  533,  548,
+      563,  579,  595,  611,  628,  645,  663,  681,  700,  719,  739,  759,  780,  802,  824,  847,
+      870,  894,  918,  944,  970,  997, 1024, 1052, 1081, 1111, 1142, 1173, 1205, 1239, 1273, 1308,
+     1344, 1381, 1419, 1458, 1498, 1539, 1582, 1625, 1670, 1716, 1764, 1812, 1862, 1913, 1966, 2020,
+     2076, 2133, 2192, 2252, 2314, 2378, 2444, 2511, 2580, 2651, 2724, 2800, 2877, 2956, 3037, 3121,
+     3207, 3295, 3386, 3480, 3575, 3674, 3775, 3879, 3986, 4096, 4209, 4325, 4444, 4566, 4692, 4822,
+     4954, 5091, 5231, 5375, 5523, 5676, 5832, 5993, 6158, 6328, 6502, 6681, 6865, 7054, 7249, 7448,
+     7654, 7865, 8081, 8304, 8533, 8768, 9010, 9258, 9513, 9775,10044,10321,10606,10898,11198,11507,
+    11824,12149,12484,12828,13182,13545,13918,14302,14696,15101,15517,15944,16384,16835,17299,17776,
+    18266,18769,19286,19818,20364,20925,21501,22094,22703,23328,23971,24631,25310,26008,26724,27461,
+    28217,28995,29794,30615,31458,32325,33216,34131,35072,36038,37031,38051,39100,40177,41284,42422,
+    43591,44792,46026,47295,48598,49937,51313,52727,54180,55673,57207,58783,60403,62067,63778,65535,
+};
+
+static const uint16_t s_ease_out_bounce[DISPLAY_EASE_LUT_SIZE] = {
+        0,    8,   30,   69,  122,  191,  274,  373,  488,  617,  762,  922, 1098, 1288, 1494, 1715,
+     1951, 2203, 2469, 2751, 3049, 3361, 3689, 4032, 4390, 4764, 5152, 5556, 5976, 6410, 6860, 7325,
+     7805, 8300, 8811, 9337, 9878,10434,11006,11593,12195,12812,13445,14093,14756,15434,16128,16837,
+    17561,18300,19055,19824,20609,21410,22225,23056,23902,24763,25640,26532,27439,28361,29298,30251,
+    31219,32202,33201,34214,35243,36287,37347,38422,39511,40617,41737,42873,44024,45190,46371,47568,
+    48780,50007,51249,52507,53780,55068,56371,57690,59023,60372,61737,63116,64511,65343,64648,63968,
+    63304,62654,62020,61402,60798,60210,59637,59079,58537,58009,57497,57000,56519,56053,55601,55166,
+    54745,54340,53950,53575,53215,52871,52542,52228,51929,51646,51378,51125,50887,50665,50457,50265,
+    50089,49927,49781,49650,49534,49434,49349,49279,49224,49185,49160,49151,49158,49179,49216,49268,
+    49335,49417,49515,49628,49756,49900,50058,50232,50421,50626,50845,51080,51330,51596,51876,52172,
+    52483,52810,53151,53508,53880,54268,54670,55088,55521,55969,56433,56912,57406,57915,58440,58979,
+    59534,60105,60690,61291,61907,62538,63184,63846,64523,65215,65345,65007,64685,64378,64086,63810,
+    63549,63303,63072,62856,62656,62471,62301,62147,62008,61884,61775,61681,61603,61540,61492,61459,
+    61442,61440,61453,61482,61525,61584,61658,61748,61852,61972,62107,62258,62423,62604,62800,63012,
+    63238,63480,63737,64009,64297,64600,64918,65251,65503,65337,65186,65050,64929,64824,64734,64659,
+    64600,64555,64526,64512,64514,64530,64562,64609,64672,64749,64842,64950,65074,65212,65366,65535,
+};
+
+// ============================================================================
+//  ВНУТРЕННЕЕ СОСТОЯНИЕ
+// ============================================================================
+
+static const uint16_t *s_custom_lut = NULL;
+
+// ============================================================================
+//  ВНУТРЕННИЕ ФУНКЦИИ
+// ============================================================================
+
+/*
+ * Интерполяция по таблице.
+ * pos = t * 255 в Q16: старшая часть — индекс точки, следующие 8 бит — доля.
+ * Для t <= 65535 индекс не превышает 254, поэтому lut[i + 1] всегда в пределах.
+ * Интерполяция до t = 1 не доходит (f = 254/256), поэтому конец берется из таблицы:
+ * эффект заканчивается точно на последней точке кривой.
+ */
+static uint16_t ease_lut(const uint16_t *lut, uint16_t t)
+{
+    if (t == DISPLAY_EASE_ONE) return lut[DISPLAY_EASE_LUT_SIZE - 1u];
+    uint32_t pos = (uint32_t)t * (DISPLAY_EASE_LUT_SIZE - 1u);
+    uint32_t i = pos >> 16;
+    int32_t  f = (int32_t)((pos >> 8) & 0xFFu);
+    int32_t  a = lut[i];
+    int32_t  b = lut[i + 1u];
+    return (uint16_t)(a + (((b - a) * f) >> 8));
+}
+
+// ============================================================================
+//  ПУБЛИЧНЫЙ API
+// ============================================================================
+
+uint16_t display_ease_q16(display_ease_t curve, uint16_t t)
+{
+    switch (curve) {
+        case DISPLAY_EASE_IN_QUAD:      return (uint16_t)(((uint32_t)t * (t + 1u)) >> 16); // t = 1 -> 1
+        case DISPLAY_EASE_IN_CUBIC:     return ease_lut(s_ease_in_cubic, t);
+        case DISPLAY_EASE_OUT_CUBIC:    return (uint16_t)(DISPLAY_EASE_ONE - ease_lut(s_ease_in_cubic, (uint16_t)(DISPLAY_EASE_ONE - t)));
+        case DISPLAY_EASE_IN_OUT_CUBIC: return ease_lut(s_ease_in_out_cubic, t);
+        case DISPLAY_EASE_IN_OUT_SINE:  return ease_lut(s_ease_in_out_sine, t);
+        case DISPLAY_EASE_IN_EXPO:      return ease_lut(s_ease_in_expo, t);
+        case DISPLAY_EASE_OUT_EXPO:     return (uint16_t)(DISPLAY_EASE_ONE - ease_lut(s_ease_in_expo, (uint16_t)(DISPLAY_EASE_ONE - t)));
+        case DISPLAY_EASE_OUT_BOUNCE:   return ease_lut(s_ease_out_bounce, t);
+        case DISPLAY_EASE_CUSTOM:       return s_custom_lut ? ease_lut(s_custom_lut, t) : t;
+        case DISPLAY_EASE_DEFAULT:
+        case DISPLAY_EASE_LINEAR:
+        default:                        return t;
+    }
+}
+
+uint8_t display_ease_q8(display_ease_t curve, uint8_t t)
+{
+    // t * 257: 0 -> 0, 255 -> 65535
+    return (uint8_t)(display_ease_q16(curve, (uint16_t)(t * 257u)) >> 8);
+}
+
+void display_ease_set_custom(const uint16_t *lut)
+{
+    s_custom_lut = lut;
+}
@@ -1,10 +1,12 @@
 #include "display_api.h"
+#include "display_fx.h"
 #include "display_ll.h"
 #include "display_state.h"
 #include "display_rng.h"
-#include "display_lut.h" 
+#include "display_ease.h"
 #include "display_font.h"
 #include "logging.h"
+#include "display_trace.h"
 
 #include "pico/stdlib.h"
 #include <string.h>
@@ -15,41 +17,124 @@
  * Управляет изменением яркости и содержимого буферов во времени.
  */
 
-static bool s_rng_seeded = false;
+/*
+ * Независимые потоки RNG: эффекты не сдвигают последовательности друг друга.
+ * Состояние потоков хранится в экземпляре (fx_rng_*).
+ */
+enum {
+    FX_RNG_STREAM_GLITCH = 0,
+    FX_RNG_STREAM_DISSOLVE,
+    FX_RNG_STREAM_MORPH,
+    FX_RNG_STREAM_DECODE,
+};
+
+/* Пользовательские эффекты (арена состояния — у каждого экземпляра дисплея). */
+static const display_fx_vtable_t *s_fx_user[DISPLAY_FX_MAX_USER];
+static uint8_t s_fx_user_count = 0;
+
+static const display_fx_vtable_t *fx_ops(fx_type_t type);
 
 // ============================================================================
 //   ВСПОМОГАТЕЛЬНЫЕ ФУНКЦИИ
 // ============================================================================
 
-/* Расчет времени, прошедшего с момента start (в миллисекундах). */
-static inline uint32_t fx_elapsed_ms(absolute_time_t from, absolute_time_t to) {
+/* Расчет времени, прошедшего с момента start (в микросекундах). */
+static inline uint64_t fx_elapsed_us(absolute_time_t from, absolute_time_t to) {
     int64_t diff_us = absolute_time_diff_us(from, to);
     if (diff_us <= 0) return 0;
-    return (uint32_t)(diff_us / 1000u);
+    return (uint64_t)diff_us;
+}
+
+/* Доля процента в Q16 (вычисляется при компиляции). */
+#define FX_PCT_Q16(p) ((uint32_t)(p) * 65536u / 100u)
+
+/* Обратная величина 2^32 / x для умножения вместо деления в тике. */
+static uint32_t fx_reciprocal(uint32_t x) {
+    if (x <= 1u) return UINT32_MAX;
+    return (uint32_t)((1ull << 32) / x);
+}
+
+/* Период кадра движка и производные величины (деления — только здесь, не в тике). */
+static void fx_set_step(uint32_t step_us) {
+    g_display->fx_step_us     = step_us;
+    g_display->fx_inv_step    = fx_reciprocal(step_us);
+    g_display->fx_step_ms     = (uint16_t)(step_us / 1000u);
+    g_display->fx_step_rem_us = (uint16_t)(step_us % 1000u);
+}
+
+/* Продвижение fx_elapsed_ms на frames кадров: сложения, в сумме одно на кадр эффекта. */
+static inline void fx_advance_elapsed(uint32_t frames) {
+    while (frames--) {
+        g_display->fx_elapsed_ms     += g_display->fx_step_ms;
+        g_display->fx_elapsed_rem_us += g_display->fx_step_rem_us;
+        if (g_display->fx_elapsed_rem_us >= 1000u) {
+            g_display->fx_elapsed_rem_us -= 1000u;
+            g_display->fx_elapsed_ms++;
+        }
+    }
+}
+
+/* Прогресс эффекта 0..65535 (Q16) без деления: elapsed * (2^32 / duration) >> 16. */
+static inline uint16_t fx_progress_q16(uint32_t elapsed_ms) {
+    uint32_t t = (uint32_t)(((uint64_t)elapsed_ms * g_display->fx_inv_duration) >> 16);
+    return (t > DISPLAY_EASE_ONE) ? (uint16_t)DISPLAY_EASE_ONE : (uint16_t)t;
+}
+
+/* Прогресс эффекта после кривой сглаживания (Q16). */
+static inline uint16_t fx_eased_progress(uint32_t elapsed_ms) {
+    return display_ease_q16(g_display->fx_ease, fx_progress_q16(elapsed_ms));
 }
 
-/* Инициализация генератора случайных чисел (если еще не выполнена). */
+/* Яркость base, умноженная на долю в Q16, с гамма-коррекцией. */
+static inline uint8_t fx_scaled_gamma(uint8_t base, uint32_t level_q16) {
+    return display_ll_apply_gamma((uint8_t)(((uint32_t)base * level_q16) >> 16));
+}
+
+/* Кривая по умолчанию: воспроизводит исходную форму каждого эффекта. */
+static display_ease_t fx_default_ease(fx_type_t type) {
+    switch (type) {
+        case FX_PULSE: return DISPLAY_EASE_IN_OUT_SINE; // Бывшая cos LUT
+        case FX_WAVE:  return DISPLAY_EASE_IN_QUAD;     // Бывшая fx_ease_curve
+        default:       return DISPLAY_EASE_LINEAR;
+    }
+}
+
+/*
+ * Инициализация потоков RNG текущего экземпляра (если еще не выполнена).
+ * Источник энтропии — ROSC, без ожидания АЦП.
+ */
 static void fx_seed_rng_if_needed(void) {
-    if (s_rng_seeded) return;
-    display_rng_seed_from_adc((uint16_t)g_display->adc_pin);
-    s_rng_seeded = true;
+    if (g_display->fx_rng_seeded) return;
+    display_rng_seed_from_hw();
+    display_rng_stream_init(&g_display->fx_rng_glitch, FX_RNG_STREAM_GLITCH);
+    display_rng_stream_init(&g_display->fx_rng_dissolve, FX_RNG_STREAM_DISSOLVE);
+    display_rng_stream_init(&g_display->fx_rng_morph, FX_RNG_STREAM_MORPH);
+    display_rng_stream_init(&g_display->fx_rng_decode, FX_RNG_STREAM_DECODE);
+    g_display->fx_rng_seeded = true;
 }
 
+/* Посев генератора заранее, чтобы первый эффект не тратил на него время кадра (display_init_fast). */
+void display_fx_warmup(void) { fx_seed_rng_if_needed(); }
+
 /*
  * Определение типа эффекта.
  * Возвращает true, если эффект требует эксклюзивного контроля над сегментами.
  */
 static bool fx_is_blocking_type(fx_type_t type) {
-    switch (type) {
-        case FX_GLITCH:
-        case FX_MORPH:
-        case FX_DISSOLVE:
-        case FX_MARQUEE:
-        case FX_SLIDE_IN:
-            return true;
-        default: 
-            return false; // Прозрачные эффекты (яркость)
-    }
+    const display_fx_vtable_t *ops = fx_ops(type);
+    return ops && (ops->flags & DISPLAY_FX_FLAG_BLOCKING);
+}
+
+/* Заполнение контекста для обратных вызовов эффекта. */
+static void fx_make_ctx(display_fx_ctx_t *ctx, const display_fx_vtable_t *ops) {
+    ctx->state           = (ops->state_size && g_display->fx_arena) ? g_display->fx_arena : NULL;
+    ctx->content         = g_display->saved_content_buffer;
+    ctx->elapsed_ms      = g_display->fx_elapsed_ms;
+    ctx->duration_ms     = g_display->fx_duration_ms;
+    ctx->frame_ms        = g_display->fx_frame_ms;
+    ctx->progress_q16    = fx_eased_progress(g_display->fx_elapsed_ms);
+    ctx->digit_count     = g_display->digit_count;
+    ctx->base_brightness = g_display->fx_base_brightness;
 }
 
 /*
@@ -62,31 +147,33 @@ static void fx_finish_internal(void)
 {
     if (!g_display->fx_active) return;
     fx_type_t finished_type = g_display->fx_type;
+    g_display->fx_actual_ms = (uint32_t)(fx_elapsed_us(g_display->fx_start_time, get_absolute_time()) / 1000u);
+    DISPLAY_TRACE(DISPLAY_TRACE_FX_FINISH, &g_display->ll, finished_type, g_display->fx_actual_ms);
     bool was_blocking = fx_is_blocking_type(finished_type);
 
-    // Специальная обработка для Morph
-    if (finished_type == FX_MORPH && g_display->saved_valid) {
-        uint8_t digits = g_display->digit_count;
-        // 1. Обновляем основной буфер контента (чтобы логика Core знала о новом состоянии)
-        memcpy(g_display->content_buffer, g_display->fx_morph_target, digits);
-        
-        // 2. Обновляем Snapshot (чтобы блок восстановления ниже записал target в LL)
-        memcpy(g_display->saved_content_buffer, g_display->fx_morph_target, digits);
+    // Собственное завершение эффекта (например, Morph фиксирует результат в snapshot)
+    const display_fx_vtable_t *ops = fx_ops(finished_type);
+    if (ops && ops->finish) {
+        display_fx_ctx_t ctx;
+        fx_make_ctx(&ctx, ops);
+        ops->finish(&ctx);
     }
 
     if (was_blocking && g_display->saved_valid) {
         // Для блокирующих эффектов восстанавливаем состояние из snapshot.
         // В случае Morph snapshot уже содержит новые данные (target).
+        // Яркость берется текущая: ядро могло плавно изменить ее во время эффекта.
         uint8_t digits = g_display->digit_count;
         for (uint8_t i = 0; i < digits; i++) {
             display_ll_set_digit_raw(i, g_display->saved_content_buffer[i]);
-            display_ll_set_brightness(i, g_display->saved_brightness[i]);
-            g_display->final_brightness[i] = g_display->saved_brightness[i];
+            display_ll_set_brightness(i, g_display->final_brightness[i]);
         }
+        DISPLAY_TRACE(DISPLAY_TRACE_RESTORE, &g_display->ll,
+                      display_trace_pack(g_display->saved_content_buffer, digits), 0);
     } else {
-        // Для прозрачных эффектов: восстановление только базовой яркости
-        uint8_t restore_level = g_display->fx_base_brightness;
-        if (g_display->saved_valid) restore_level = g_display->saved_brightness[0];
+        // Для прозрачных эффектов: восстановление базовой яркости ядра.
+        // Это текущий уровень (с учетом Ramp), а не снимок на момент старта эффекта.
+        uint8_t restore_level = g_display->brightness_level;
         
         display_ll_set_brightness_all(restore_level);
         for (uint8_t i = 0; i < g_display->digit_count; i++) 
@@ -107,6 +194,7 @@ static void fx_finish_internal(void)
 static bool fx_start_basic(fx_type_t type, uint32_t duration_ms, uint32_t frame_ms)
 {
     if (!g_display->initialized) return false;
+    if (!fx_ops(type)) return false;
     if (g_display->ov_active) return false;
     if (g_display->fx_active) return false;
     if (duration_ms == 0) return false;
@@ -126,6 +214,11 @@ static bool fx_start_basic(fx_type_t type, uint32_t duration_ms, uint32_t frame_
     g_display->fx_duration_ms = duration_ms;
     g_display->fx_frame_ms = frame_ms;
     g_display->fx_elapsed_ms = 0;
+    g_display->fx_inv_duration = fx_reciprocal(duration_ms);
+    g_display->fx_inv_frame = frame_ms ? fx_reciprocal(frame_ms) : 0;
+    g_display->fx_ease = (g_display->fx_ease_select != DISPLAY_EASE_DEFAULT)
+                         ? g_display->fx_ease_select : fx_default_ease(type);
+    g_display->fx_ease_select = DISPLAY_EASE_DEFAULT; // Кривая действует на один запуск
     
     uint8_t base = g_display->final_brightness[0];
     if (base == 0) base = VFD_MAX_BRIGHTNESS;
@@ -138,9 +231,16 @@ static bool fx_start_basic(fx_type_t type, uint32_t duration_ms, uint32_t frame_
     // а не ждал тайминга от предыдущего запуска.
     g_display->fx_glitch_next_ms = 0; 
     
-    g_display->fx_matrix_last_ms = 0;
+    g_display->fx_frame_no = 0;
+    g_display->fx_next_frame_us = 0;
+    g_display->fx_frames_rendered = 0;
+    g_display->fx_frames_skipped = 0;
+    g_display->fx_actual_ms = 0;
+    g_display->fx_elapsed_rem_us = 0;
+    if (g_display->fx_step_us == 0) fx_set_step(1000000u / DISPLAY_FX_DEFAULT_FPS);
     g_display->fx_morph_step = 0;
     g_display->fx_dissolve_step = 0;
+    DISPLAY_TRACE(DISPLAY_TRACE_FX_START, &g_display->ll, type, duration_ms);
     return true;
 }
 
@@ -160,224 +260,300 @@ static void fx_prepare_text(const char *text) {
 //   РЕАЛИЗАЦИЯ ЭФФЕКТОВ
 // ============================================================================
 
-/* Fade In / Fade Out: Линейное изменение яркости с гамма-коррекцией. */
-static void fx_apply_fade(uint32_t t_ms, uint32_t duration_ms, bool reverse) {
-    if (duration_ms == 0) return;
-    if (t_ms > duration_ms) t_ms = duration_ms;
-    uint8_t base = g_display->fx_base_brightness;
-    uint32_t num;
-    if (!reverse) num = (uint32_t)t_ms * base;
-    else          num = (uint32_t)(duration_ms - t_ms) * base;
-    uint8_t linear = (uint8_t)(num / duration_ms);
-    display_ll_set_brightness_all(display_ll_apply_gamma(linear));
+/* Fade In / Fade Out: изменение яркости по кривой (по умолчанию линейной) с гамма-коррекцией. */
+static void fx_apply_fade(uint32_t t_ms, bool reverse) {
+    uint32_t e = fx_eased_progress(t_ms);
+    if (reverse) e = DISPLAY_EASE_ONE - e;
+    display_ll_set_brightness_all(fx_scaled_gamma(g_display->fx_base_brightness, e));
 }
 
-/* Pulse: Синусоидальная модуляция яркости (дыхание). */
-static void fx_apply_pulse(uint32_t t_ms, uint32_t duration_ms) {
-    if (duration_ms == 0) return;
-    uint8_t base = g_display->fx_base_brightness;
-    const uint8_t min_percent = 8;
-    const uint8_t span_percent = 100u - min_percent;
+/*
+ * Pulse: модуляция яркости (дыхание).
+ * Треугольная фаза, пропущенная через IN_OUT_SINE, дает прежнюю форму (cos(x) + 1) / 2.
+ */
+static void fx_apply_pulse(uint32_t t_ms) {
+    const uint32_t min_q16  = FX_PCT_Q16(8);
+    const uint32_t span_q16 = FX_PCT_Q16(100 - 8);
     const uint32_t cycles = 2;
-    if (t_ms > duration_ms) t_ms = duration_ms;
-    
-    uint32_t phase_full = (uint32_t)((uint64_t)t_ms * 256u * cycles / duration_ms);
-    uint8_t phase_idx = (uint8_t)(phase_full & 0xFFu);
-    uint8_t cos_q = display_cos_lut[phase_idx];
-    uint8_t dyn_percent = (uint8_t)((uint32_t)cos_q * span_percent / 255u);
-    uint8_t brightness_percent = min_percent + dyn_percent;
-    uint8_t linear = (uint8_t)((uint32_t)base * brightness_percent / 100u);
-    display_ll_set_brightness_all(display_ll_apply_gamma(linear));
-}
 
-/* Вспомогательная кривая затухания для эффекта Wave. */
-static uint8_t fx_ease_curve(uint32_t dist_ratio) {
-    if (dist_ratio >= 255) return 0;
-    uint32_t x = 255 - dist_ratio;
-    return (uint8_t)((x * x) >> 8);
+    uint16_t phase = (uint16_t)((uint32_t)fx_progress_q16(t_ms) * cycles);
+    uint16_t tri = (phase < 0x8000u) ? (uint16_t)(DISPLAY_EASE_ONE - 2u * phase)
+                                     : (uint16_t)(2u * phase - 0x10000u);
+    uint32_t e = display_ease_q16(g_display->fx_ease, tri);
+    uint32_t level_q16 = min_q16 + ((span_q16 * e) >> 16);
+    display_ll_set_brightness_all(fx_scaled_gamma(g_display->fx_base_brightness, level_q16));
 }
 
 /* Wave: Волна яркости, бегущая по разрядам. */
-static void fx_apply_wave(uint32_t t_ms, uint32_t duration_ms) {
-    if (duration_ms == 0) return;
+static void fx_apply_wave(uint32_t t_ms) {
     uint8_t digits = g_display->digit_count;
     uint8_t base = g_display->fx_base_brightness;
-    const uint8_t min_percent = 20;
-    const uint8_t span_percent = 80;
+    const uint32_t min_q16  = FX_PCT_Q16(20);
+    const uint32_t span_q16 = FX_PCT_Q16(80);
     const uint32_t cycles = 2;
-    if (t_ms > duration_ms) t_ms = duration_ms;
+    const uint32_t wave_radius = 384u;
+    const uint32_t inv_radius_q16 = 65536u / wave_radius;
 
     uint32_t total_length = (uint32_t)digits * 256u;
-    uint32_t wave_center = (uint32_t)((uint64_t)t_ms * cycles * total_length / duration_ms) % total_length;
-    const uint32_t wave_radius = 384u;
+    uint32_t wave_center = (uint32_t)(((uint64_t)fx_progress_q16(t_ms) * cycles * total_length) >> 16);
+    while (wave_center >= total_length) wave_center -= total_length;
 
     for (uint8_t i = 0; i < digits; i++) {
         uint32_t digit_center = (uint32_t)i * 256u + 128u;
         uint32_t dist = (digit_center > wave_center) ? (digit_center - wave_center) : (wave_center - digit_center);
         if (dist > (total_length / 2u)) dist = total_length - dist;
 
-        uint8_t brightness_percent = min_percent;
+        uint32_t level_q16 = min_q16;
         if (dist < wave_radius) {
-            uint32_t ratio = (dist * 255u) / wave_radius;
-            uint32_t add_val = (fx_ease_curve(ratio) * span_percent) >> 8;
-            brightness_percent += (uint8_t)add_val;
+            uint32_t ratio = dist * inv_radius_q16;
+            if (ratio > DISPLAY_EASE_ONE) ratio = DISPLAY_EASE_ONE;
+            uint32_t e = display_ease_q16(g_display->fx_ease, (uint16_t)(DISPLAY_EASE_ONE - ratio));
+            level_q16 += (span_q16 * e) >> 16;
         }
-        uint8_t linear = (uint8_t)((uint32_t)base * brightness_percent / 100u);
-        display_ll_set_brightness(i, display_ll_apply_gamma(linear));
+        display_ll_set_brightness(i, fx_scaled_gamma(base, level_q16));
     }
 }
 
-/* Glitch: Случайная подмена битов в случайном разряде. */
+/*
+ * Glitch: Случайная подмена битов в случайном разряде.
+ * Шаг узора — функция времени от начала глюка (elapsed * 2^32 / frame_ms),
+ * поэтому пропуск кадров движка не растягивает и не сбивает узор.
+ */
 static void fx_apply_glitch(uint32_t elapsed_ms) {
+    static const uint8_t pattern[] = {1, 0, 1, 0, 1, 1, 0};
+    const uint32_t pattern_len = 7;
     uint8_t digits = g_display->digit_count;
+
     if (!g_display->fx_glitch_active) {
-        if (elapsed_ms >= g_display->fx_glitch_next_ms) {
-            uint8_t digit = (uint8_t)display_rng_range(digits);
-            uint8_t bit   = (uint8_t)display_rng_range(7);
-            g_display->fx_glitch_digit = digit;
-            g_display->fx_glitch_bit = bit;
-            g_display->fx_glitch_saved_digit = g_display->content_buffer[digit];
-            g_display->fx_glitch_step = 0;
-            g_display->fx_glitch_last_ms = elapsed_ms;
-            g_display->fx_glitch_active = true;
-        }
-        return;
+        if (elapsed_ms < g_display->fx_glitch_next_ms) return;
+        uint8_t digit = (uint8_t)display_rng_stream_range(&g_display->fx_rng_glitch, digits);
+        uint8_t bit   = (uint8_t)display_rng_stream_range(&g_display->fx_rng_glitch, 7);
+        g_display->fx_glitch_digit = digit;
+        g_display->fx_glitch_bit = bit;
+        g_display->fx_glitch_saved_digit = g_display->content_buffer[digit];
+        g_display->fx_glitch_step = UINT32_MAX;
+        g_display->fx_glitch_start_ms = elapsed_ms;
+        g_display->fx_glitch_active = true;
     }
-    uint32_t frame_ms = g_display->fx_frame_ms ? g_display->fx_frame_ms : 50u;
-    if (elapsed_ms - g_display->fx_glitch_last_ms < frame_ms) return;
-    g_display->fx_glitch_last_ms = elapsed_ms;
 
-    static const uint8_t pattern[] = {1, 0, 1, 0, 1, 1, 0};
-    uint32_t pattern_len = 7;
     uint8_t d = g_display->fx_glitch_digit;
     uint8_t b = g_display->fx_glitch_bit;
-
     if (d >= digits) { g_display->fx_glitch_active = false; return; }
 
-    vfd_segment_map_t seg = g_display->fx_glitch_saved_digit;
-    if (pattern[g_display->fx_glitch_step % pattern_len]) seg |= (1u << b);
-    else seg &= ~(1u << b);
-    
-    display_ll_set_digit_raw(d, seg);
-    g_display->fx_glitch_step++;
+    uint32_t t = elapsed_ms - g_display->fx_glitch_start_ms;
+    uint32_t step = (uint32_t)(((uint64_t)t * g_display->fx_inv_frame) >> 32);
+    if (step == g_display->fx_glitch_step) return;
+    g_display->fx_glitch_step = step;
 
-    if (g_display->fx_glitch_step >= pattern_len) {
+    if (step >= pattern_len) {
         display_ll_set_digit_raw(d, g_display->fx_glitch_saved_digit);
         g_display->fx_glitch_active = false;
-        uint32_t interval = 200u + (uint32_t)display_rng_range(601u);
+        uint32_t interval = 200u + (uint32_t)display_rng_stream_range(&g_display->fx_rng_glitch, 601u);
         g_display->fx_glitch_next_ms = elapsed_ms + interval;
+        return;
     }
+
+    vfd_segment_map_t seg = g_display->fx_glitch_saved_digit;
+    if (pattern[step]) seg |= (1u << b);
+    else seg &= ~(1u << b);
+    display_ll_set_digit_raw(d, seg);
 }
 
 /* Scanner (Matrix): Эффект бегущего огня (KITT) с затуханием. */
 /* 
  * FIX #17: Использование fx_frame_ms как периода эффекта. 
+ * Фаза внутри периода — дробная часть elapsed * (2^32 / period), без деления.
  */
 static void fx_apply_matrix(uint32_t elapsed_ms) 
 {
-    uint32_t duration_ms = g_display->fx_duration_ms;
-    if (duration_ms == 0) return;
-
     uint8_t digits = g_display->digit_count;
     uint8_t base = g_display->fx_base_brightness;
+    const int32_t width_x100 = 120; 
+    const uint32_t inv_width_q16 = 65536u / (uint32_t)width_x100;
+    const uint32_t min_q16 = FX_PCT_Q16(5);
 
-    // Period теперь берется из настроек, а не хардкодится.
-    uint32_t period = g_display->fx_frame_ms;
-    if (period == 0) period = 1200; 
-
-    uint32_t phase = elapsed_ms % period;
-    
-    int32_t head_pos_x100;
-    
-    if (phase < (period / 2)) {
-        head_pos_x100 = (int32_t)(phase * (digits - 1) * 100) / (period / 2);
-    } else {
-        uint32_t phase_back = phase - (period / 2);
-        head_pos_x100 = (int32_t)((digits - 1) * 100) - 
-                        (int32_t)(phase_back * (digits - 1) * 100) / (period / 2);
-    }
+    uint32_t inv_period = g_display->fx_inv_frame;
+    if (inv_period == 0) inv_period = fx_reciprocal(1200);
 
-    const int32_t width_x100 = 120; 
+    uint16_t phase = (uint16_t)(((uint64_t)elapsed_ms * inv_period) >> 16);
+    uint32_t tri = (phase < 0x8000u) ? 2u * phase : 2u * (DISPLAY_EASE_ONE - phase);
+    int32_t head_pos_x100 = (int32_t)((tri * (uint32_t)(digits - 1) * 100u) >> 16);
 
     for (uint8_t i = 0; i < digits; i++) {
         int32_t my_pos_x100 = i * 100;
         int32_t dist = my_pos_x100 - head_pos_x100;
         if (dist < 0) dist = -dist;
 
-        uint8_t target_brightness = 5; 
+        uint32_t level_q16 = min_q16;
 
         if (dist < width_x100) {
-            int32_t intensity = ((width_x100 - dist) * 100) / width_x100;
-            int32_t level = 5 + intensity; 
-            if (level > 100) level = 100;
-            target_brightness = (uint8_t)level;
+            uint32_t intensity = (uint32_t)(width_x100 - dist) * inv_width_q16;
+            if (intensity > DISPLAY_EASE_ONE) intensity = DISPLAY_EASE_ONE;
+            level_q16 += display_ease_q16(g_display->fx_ease, (uint16_t)intensity);
+            if (level_q16 > 65536u) level_q16 = 65536u;
         }
 
-        uint32_t final_val = (uint32_t)base * target_brightness / 100u;
-        display_ll_set_brightness(i, display_ll_apply_gamma((uint8_t)final_val));
+        display_ll_set_brightness(i, fx_scaled_gamma(base, level_q16));
     }
 }
 
-/* Morph: Побитовое превращение одного буфера в другой. */
-static void fx_apply_morph(uint32_t elapsed_ms, uint32_t duration_ms) {
+/*
+ * Morph: Побитовое превращение одного буфера в другой.
+ * Расписание переключений построено при старте (fx_morph_build_schedule),
+ * тик только применяет переключения, ставшие актуальными с прошлого шага.
+ */
+static void fx_apply_morph(uint32_t elapsed_ms) {
     uint32_t steps = g_display->fx_morph_steps;
     if (steps == 0) return;
-    uint32_t step = (uint32_t)((uint64_t)elapsed_ms * steps / duration_ms);
+    uint32_t step = ((uint32_t)fx_eased_progress(elapsed_ms) * steps) >> 16;
     if (step > steps) step = steps;
     if (step == g_display->fx_morph_step) return;
     g_display->fx_morph_step = step;
 
-    uint8_t digits = g_display->digit_count;
-    uint32_t total_pos = (uint32_t)digits * 8u;
-    uint32_t threshold = (uint32_t)((uint64_t)step * 255u / steps);
-
-    for (uint8_t d = 0; d < digits; d++) {
-        vfd_segment_map_t from = g_display->fx_morph_start[d];
-        vfd_segment_map_t to = g_display->fx_morph_target[d];
-        vfd_segment_map_t result = from & to; 
+    uint16_t touched = 0;
+    uint8_t i = g_display->fx_morph_applied;
+    while (i < g_display->fx_morph_flips && g_display->fx_morph_flip_step[i] <= step) {
+        uint8_t pos = g_display->fx_morph_order[i++];
+        uint8_t d = pos >> 3;
+        g_display->fx_morph_segs[d] ^= (vfd_segment_map_t)(1u << (pos & 7u));
+        touched |= (uint16_t)(1u << d);
+    }
+    g_display->fx_morph_applied = i;
 
-        for (uint8_t b = 0; b < 8u; b++) {
-            vfd_segment_map_t mask = (1u << b);
-            if ((from & mask) == (to & mask)) continue;
-            uint32_t weight = ((uint32_t)d * 8u + b) * 255u / total_pos;
-            if (threshold >= weight) { if (to & mask) result |= mask; else result &= ~mask; }
-            else { if (from & mask) result |= mask; else result &= ~mask; }
-        }
-        display_ll_set_digit_raw(d, result);
+    for (uint8_t d = 0; touched; d++, touched >>= 1) {
+        if (touched & 1u) display_ll_set_digit_raw(d, g_display->fx_morph_segs[d]);
     }
 }
 
-/* Dissolve: Случайное выключение сегментов до полного гашения. */
-static void fx_apply_dissolve(uint32_t elapsed_ms, uint32_t duration_ms) {
+/*
+ * Dissolve / Assemble: сегменты гаснут (или загораются) в случайном порядке.
+ * Применяются только биты, ставшие актуальными с прошлого шага,
+ * и в LL пишутся только затронутые разряды: полный проход O(n) вместо O(n²).
+ */
+static void fx_apply_dissolve(uint32_t elapsed_ms, bool assemble) {
     uint32_t total = g_display->fx_dissolve_total_bits;
     if (total == 0) return;
-    uint32_t step = (uint32_t)((uint64_t)elapsed_ms * total / duration_ms);
+    uint32_t step = ((uint32_t)fx_eased_progress(elapsed_ms) * total) >> 16;
     if (step > total) step = total;
-    if (step == g_display->fx_dissolve_step) return;
+    uint32_t prev = g_display->fx_dissolve_step;
+    if (step <= prev) return;
     g_display->fx_dissolve_step = step;
 
-    vfd_segment_map_t segs[VFD_MAX_DIGITS];
+    uint16_t touched = 0;
+    for (uint32_t i = prev; i < step; i++) {
+        uint8_t idx = g_display->fx_dissolve_order[i];
+        uint8_t d = idx >> 3;
+        vfd_segment_map_t mask = (vfd_segment_map_t)(1u << (idx & 7u));
+        if (assemble) g_display->fx_dissolve_segs[d] |= mask;
+        else          g_display->fx_dissolve_segs[d] &= (vfd_segment_map_t)~mask;
+        touched |= (uint16_t)(1u << d);
+    }
+
+    for (uint8_t d = 0; touched; d++, touched >>= 1) {
+        if (touched & 1u) display_ll_set_digit_raw(d, g_display->fx_dissolve_segs[d]);
+    }
+}
+
+// ----------------------------------------------------------------------------
+//   Поразрядные эффекты (Slot Machine, Decode, Ping-Pong)
+//   Момент фиксации каждого разряда (fx_settle_at) вычисляется при старте,
+//   тик — один проход по разрядам, в LL пишутся только изменившиеся.
+// ----------------------------------------------------------------------------
+
+#define FX_PINGPONG_BALL  ((vfd_segment_map_t)0x1D) // Нижний квадрат: C, G, D, E
+
+/* Вывод разряда поразрядного эффекта. */
+static inline void fx_stage_put(uint8_t d, vfd_segment_map_t seg) {
+    if (g_display->fx_stage_segs[d] == seg) return;
+    g_display->fx_stage_segs[d] = seg;
+    display_ll_set_digit_raw(d, seg);
+}
+
+/* Номер кадра без деления: elapsed * (2^32 / frame_ms) >> 32. */
+static inline uint32_t fx_frame_index(uint32_t elapsed_ms) {
+    return (uint32_t)(((uint64_t)elapsed_ms * g_display->fx_inv_frame) >> 32);
+}
+
+/* Slot Machine: барабаны крутятся до своего момента остановки. */
+static void fx_apply_slot_machine(uint32_t elapsed_ms) {
+    uint8_t digits = g_display->digit_count;
+    uint32_t frame = fx_frame_index(elapsed_ms);
+    // Барабан поворачивается на число прошедших кадров: пропуски не замедляют вращение
+    uint32_t advance = (g_display->fx_stage_step == UINT32_MAX) ? 1u : frame - g_display->fx_stage_step;
+    g_display->fx_stage_step = frame;
+    while (advance >= 10u) advance -= 10u;
+
+    for (uint8_t d = 0; d < digits; d++) {
+        if (elapsed_ms >= g_display->fx_settle_at[d]) {
+            fx_stage_put(d, g_display->fx_target_buffer[d]);
+            continue;
+        }
+        uint32_t idx = g_display->fx_roll_idx[d] + advance;
+        if (idx >= 10u) idx -= 10u;
+        g_display->fx_roll_idx[d] = (uint8_t)idx;
+        fx_stage_put(d, display_font_digit((uint8_t)idx));
+    }
+}
+
+/* Decode: случайные сегменты на каждом кадре до момента фиксации разряда. */
+static void fx_apply_decode(uint32_t elapsed_ms) {
     uint8_t digits = g_display->digit_count;
-    for(int i=0; i<digits; i++) segs[i] = g_display->content_buffer[i];
+    uint32_t frame = fx_frame_index(elapsed_ms);
+    bool advance = (frame != g_display->fx_stage_step);
+    g_display->fx_stage_step = frame;
 
-    for(uint32_t i=0; i<step; i++) {
-        uint32_t idx = g_display->fx_dissolve_order[i];
-        segs[idx/8] &= ~(1u << (idx%8));
+    for (uint8_t d = 0; d < digits; d++) {
+        if (elapsed_ms >= g_display->fx_settle_at[d]) {
+            fx_stage_put(d, g_display->fx_target_buffer[d]);
+        } else if (advance) {
+            fx_stage_put(d, (vfd_segment_map_t)(display_rng_stream_next(&g_display->fx_rng_decode) & 0x7Fu));
+        }
     }
-    for(int i=0; i<digits; i++) display_ll_set_digit_raw(i, segs[i]);
 }
 
-/* Marquee: Бегущая строка (справа налево). */
-static void fx_apply_marquee(uint32_t elapsed_ms) {
+/* Ping-Pong: маркер двигается по шагам, разряды за ним на последнем проходе фиксируются. */
+static void fx_apply_pingpong(uint32_t elapsed_ms) {
     uint8_t digits = g_display->digit_count;
-    uint32_t speed = g_display->fx_frame_ms;
-    if (speed == 0) speed = 200;
+    uint32_t steps = g_display->fx_stage_steps;
+    uint32_t step = ((uint32_t)fx_eased_progress(elapsed_ms) * (steps + 1u)) >> 16;
+    if (step > steps) step = steps;
+
+    // Догоняем маркер шаг за шагом: в сумме O(steps) за весь эффект
+    while (g_display->fx_stage_step < step && digits > 1) {
+        if (g_display->fx_pingpong_dir) {
+            if (++g_display->fx_pingpong_pos >= digits - 1) g_display->fx_pingpong_dir = false;
+        } else {
+            if (--g_display->fx_pingpong_pos <= 0) g_display->fx_pingpong_dir = true;
+        }
+        g_display->fx_stage_step++;
+    }
+
+    for (uint8_t d = 0; d < digits; d++) {
+        vfd_segment_map_t seg;
+        if (d == g_display->fx_pingpong_pos)         seg = FX_PINGPONG_BALL;
+        else if (step >= g_display->fx_settle_at[d]) seg = g_display->fx_target_buffer[d];
+        else                                         seg = g_display->saved_content_buffer[d];
+        fx_stage_put(d, seg);
+    }
+}
 
-    uint32_t step = elapsed_ms / speed;
-    int total_len = g_display->fx_text_len + digits;
+/*
+ * Время эффекта после кривой сглаживания (мс) для пошаговых эффектов:
+ * номер шага берется от этого времени, и шаги ускоряются/замедляются по кривой.
+ */
+static inline uint32_t fx_eased_ms(uint32_t elapsed_ms) {
+    if (g_display->fx_ease == DISPLAY_EASE_LINEAR) return elapsed_ms;
+    return (uint32_t)(((uint64_t)fx_eased_progress(elapsed_ms) * g_display->fx_duration_ms) >> 16);
+}
+
+/* Marquee: Бегущая строка (справа налево), шаг — кадр длиной speed_ms. */
+static void fx_apply_marquee(uint32_t elapsed_ms) {
+    uint8_t digits = g_display->digit_count;
+    uint32_t step = fx_frame_index(fx_eased_ms(elapsed_ms));
+    uint32_t total_len = (uint32_t)g_display->fx_text_len + digits;
     
     if (step >= total_len) {
-        for(int i=0; i<digits; i++) display_ll_set_digit_raw(i, 0);
+        for (uint8_t i = 0; i < digits; i++) display_ll_set_digit_raw(i, 0);
         return;
     }
 
@@ -391,13 +567,10 @@ static void fx_apply_marquee(uint32_t elapsed_ms) {
     }
 }
 
-/* Slide In: Выезд текста справа с фиксацией. */
+/* Slide In: Выезд текста справа с фиксацией, шаг — кадр длиной speed_ms. */
 static void fx_apply_slide_in(uint32_t elapsed_ms) {
     uint8_t digits = g_display->digit_count;
-    uint32_t speed = g_display->fx_frame_ms;
-    if (speed == 0) speed = 150;
-
-    uint32_t step = elapsed_ms / speed;
+    uint32_t step = fx_frame_index(fx_eased_ms(elapsed_ms));
     if (step > digits) step = digits;
 
     for (uint8_t i = 0; i < digits; i++) {
@@ -410,58 +583,364 @@ static void fx_apply_slide_in(uint32_t elapsed_ms) {
     }
 }
 
+/*
+ * Фиксация результата эффекта.
+ * FIX #15: Подменяем snapshot на target, чтобы "зафиксировать" результат.
+ */
+static void fx_commit_target(const vfd_segment_map_t *target, uint8_t digits) {
+    if (!g_display->saved_valid) return;
+    // 1. Обновляем основной буфер контента (чтобы логика Core знала о новом состоянии)
+    memcpy(g_display->content_buffer, target, digits);
+    // 2. Обновляем Snapshot (чтобы блок восстановления записал target в LL)
+    memcpy(g_display->saved_content_buffer, target, digits);
+}
+
+static void fx_finish_morph(display_fx_ctx_t *ctx) { fx_commit_target(g_display->fx_morph_target, ctx->digit_count); }
+static void fx_finish_stage(display_fx_ctx_t *ctx) { fx_commit_target(g_display->fx_target_buffer, ctx->digit_count); }
+
+// ============================================================================
+//   ТАБЛИЦА ВСТРОЕННЫХ ЭФФЕКТОВ
+// ============================================================================
+
+static bool fx_tick_fade_in(display_fx_ctx_t *ctx)  { fx_apply_fade(ctx->elapsed_ms, false); return true; }
+static bool fx_tick_fade_out(display_fx_ctx_t *ctx) { fx_apply_fade(ctx->elapsed_ms, true); return true; }
+static bool fx_tick_pulse(display_fx_ctx_t *ctx)    { fx_apply_pulse(ctx->elapsed_ms); return true; }
+static bool fx_tick_wave(display_fx_ctx_t *ctx)     { fx_apply_wave(ctx->elapsed_ms); return true; }
+static bool fx_tick_matrix(display_fx_ctx_t *ctx)   { fx_apply_matrix(ctx->elapsed_ms); return true; }
+static bool fx_tick_glitch(display_fx_ctx_t *ctx)   { fx_apply_glitch(ctx->elapsed_ms); return true; }
+static bool fx_tick_morph(display_fx_ctx_t *ctx)    { fx_apply_morph(ctx->elapsed_ms); return true; }
+static bool fx_tick_dissolve(display_fx_ctx_t *ctx) { fx_apply_dissolve(ctx->elapsed_ms, false); return true; }
+static bool fx_tick_assemble(display_fx_ctx_t *ctx) { fx_apply_dissolve(ctx->elapsed_ms, true); return true; }
+static bool fx_tick_slot(display_fx_ctx_t *ctx)     { fx_apply_slot_machine(ctx->elapsed_ms); return true; }
+static bool fx_tick_decode(display_fx_ctx_t *ctx)   { fx_apply_decode(ctx->elapsed_ms); return true; }
+static bool fx_tick_pingpong(display_fx_ctx_t *ctx) { fx_apply_pingpong(ctx->elapsed_ms); return true; }
+static bool fx_tick_marquee(display_fx_ctx_t *ctx)  { fx_apply_marquee(ctx->elapsed_ms); return true; }
+static bool fx_tick_slide_in(display_fx_ctx_t *ctx) { fx_apply_slide_in(ctx->elapsed_ms); return true; }
+
+#define FX_BRIGHT DISPLAY_FX_FLAG_BRIGHTNESS
+#define FX_BLOCK  DISPLAY_FX_FLAG_BLOCKING
+
+/* Встроенные эффекты используют поля display_state_t, поэтому state_size = 0. */
+static const display_fx_vtable_t s_fx_builtin[FX_BUILTIN_COUNT] = {
+    [FX_FADE_IN]  = { "fade_in",  FX_BRIGHT, 0, NULL, fx_tick_fade_in,  NULL },
+    [FX_FADE_OUT] = { "fade_out", FX_BRIGHT, 0, NULL, fx_tick_fade_out, NULL },
+    [FX_PULSE]    = { "pulse",    FX_BRIGHT, 0, NULL, fx_tick_pulse,    NULL },
+    [FX_WAVE]     = { "wave",     FX_BRIGHT, 0, NULL, fx_tick_wave,     NULL },
+    [FX_MATRIX]   = { "matrix",   FX_BRIGHT, 0, NULL, fx_tick_matrix,   NULL },
+    [FX_GLITCH]   = { "glitch",   FX_BLOCK,  0, NULL, fx_tick_glitch,   NULL },
+    [FX_MORPH]    = { "morph",    FX_BLOCK,  0, NULL, fx_tick_morph,    fx_finish_morph },
+    [FX_DISSOLVE] = { "dissolve", FX_BLOCK,  0, NULL, fx_tick_dissolve, NULL },
+    [FX_ASSEMBLE] = { "assemble", FX_BLOCK,  0, NULL, fx_tick_assemble, NULL },
+    [FX_SLOT_MACHINE] = { "slot_machine", FX_BLOCK, 0, NULL, fx_tick_slot,     fx_finish_stage },
+    [FX_DECODE]       = { "decode",       FX_BLOCK, 0, NULL, fx_tick_decode,   fx_finish_stage },
+    [FX_PINGPONG]     = { "pingpong",     FX_BLOCK, 0, NULL, fx_tick_pingpong, fx_finish_stage },
+    [FX_MARQUEE]  = { "marquee",  FX_BLOCK,  0, NULL, fx_tick_marquee,  NULL },
+    [FX_SLIDE_IN] = { "slide_in", FX_BLOCK,  0, NULL, fx_tick_slide_in, NULL },
+};
+
+#undef FX_BRIGHT
+#undef FX_BLOCK
+
+/* Таблица эффекта по типу: O(1), NULL для нереализованных и незарегистрированных. */
+static const display_fx_vtable_t *fx_ops(fx_type_t type) {
+    if ((unsigned)type < FX_BUILTIN_COUNT) {
+        const display_fx_vtable_t *ops = &s_fx_builtin[type];
+        return ops->tick ? ops : NULL;
+    }
+    unsigned user = (unsigned)type - FX_USER_FIRST;
+    return (user < s_fx_user_count) ? s_fx_user[user] : NULL;
+}
+
 // ============================================================================
 //   PUBLIC API
 // ============================================================================
 
-bool display_fx_fade_in(uint32_t duration_ms) { return fx_start_basic(FX_FADE_IN, duration_ms, 0); }
-bool display_fx_fade_out(uint32_t duration_ms) { return fx_start_basic(FX_FADE_OUT, duration_ms, 0); }
-bool display_fx_pulse(uint32_t duration_ms) { return fx_start_basic(FX_PULSE, duration_ms, 0); }
-bool display_fx_wave(uint32_t duration_ms) { return fx_start_basic(FX_WAVE, duration_ms, 0); }
-bool display_fx_glitch(uint32_t duration_ms) { return fx_start_basic(FX_GLITCH, duration_ms, 30); }
+/*
+ * Вызовы display_fx_*_ex выполняются на экземпляре disp (display_core_enter),
+ * функции без суффикса — на текущем.
+ */
+#define FX_CALL_ON(disp, call)                        \
+    do {                                              \
+        if (!(disp)) return false;                    \
+        display_t *prev_ = display_core_enter(disp);  \
+        bool ok_ = (call);                            \
+        display_core_leave(prev_);                    \
+        return ok_;                                   \
+    } while (0)
+
+bool display_fx_fade_in_ex(display_t *disp, uint32_t duration_ms) { FX_CALL_ON(disp, fx_start_basic(FX_FADE_IN, duration_ms, 0)); }
+bool display_fx_fade_out_ex(display_t *disp, uint32_t duration_ms) { FX_CALL_ON(disp, fx_start_basic(FX_FADE_OUT, duration_ms, 0)); }
+bool display_fx_pulse_ex(display_t *disp, uint32_t duration_ms) { FX_CALL_ON(disp, fx_start_basic(FX_PULSE, duration_ms, 0)); }
+bool display_fx_wave_ex(display_t *disp, uint32_t duration_ms) { FX_CALL_ON(disp, fx_start_basic(FX_WAVE, duration_ms, 0)); }
+bool display_fx_glitch_ex(display_t *disp, uint32_t duration_ms) { FX_CALL_ON(disp, fx_start_basic(FX_GLITCH, duration_ms, 30)); }
+
+bool display_fx_fade_in(uint32_t duration_ms) { return display_fx_fade_in_ex(g_display, duration_ms); }
+bool display_fx_fade_out(uint32_t duration_ms) { return display_fx_fade_out_ex(g_display, duration_ms); }
+bool display_fx_pulse(uint32_t duration_ms) { return display_fx_pulse_ex(g_display, duration_ms); }
+bool display_fx_wave(uint32_t duration_ms) { return display_fx_wave_ex(g_display, duration_ms); }
+bool display_fx_glitch(uint32_t duration_ms) { return display_fx_glitch_ex(g_display, duration_ms); }
 
 /* Эффект Matrix заменен на Scanner (KITT), но имя API сохранено для совместимости. 
  *
  * FIX #17: Поменяли дефолтное значение frame_ms с 80 на 1200.
  * Теперь frame_ms трактуется как ПЕРИОД эффекта.
  */
-bool display_fx_matrix(uint32_t duration_ms, uint32_t frame_ms) {
-    if (!fx_start_basic(FX_MATRIX, duration_ms, frame_ms ? frame_ms : 1200)) return false;
-    return true;
+bool display_fx_matrix_ex(display_t *disp, uint32_t duration_ms, uint32_t frame_ms) {
+    FX_CALL_ON(disp, fx_start_basic(FX_MATRIX, duration_ms, frame_ms ? frame_ms : 1200));
 }
 
-bool display_fx_morph(uint32_t duration_ms, const vfd_segment_map_t *target, uint32_t steps) {
+bool display_fx_matrix(uint32_t duration_ms, uint32_t frame_ms) { return display_fx_matrix_ex(g_display, duration_ms, frame_ms); }
+
+/* Позиция бита сегмента на контуре знака: A, B, C, D, E, F, G, DP. */
+static const uint8_t s_morph_path_rank[8] = {
+    2, // bit 0: C
+    1, // bit 1: B
+    6, // bit 2: G
+    3, // bit 3: D
+    4, // bit 4: E
+    5, // bit 5: F
+    0, // bit 6: A
+    7, // bit 7: DP
+};
+
+/*
+ * Построение расписания Morph.
+ * Каждое переключение получает ключ порядка; переключения с одинаковым ключом
+ * образуют группу и выполняются на одном шаге. Группы равномерно распределяются
+ * по шагам 1..steps. Вся арифметика — однократно при старте.
+ */
+static void fx_morph_build_schedule(display_morph_order_t order) {
+    uint8_t digits = g_display->digit_count;
+    uint8_t *pos = g_display->fx_morph_order;
+    uint16_t key[VFD_MAX_DIGITS * 8];
+    uint8_t n = 0;
+
+    for (uint8_t d = 0; d < digits; d++) {
+        vfd_segment_map_t diff = g_display->fx_morph_start[d] ^ g_display->fx_morph_target[d];
+        uint8_t rank = 0;
+        for (uint8_t b = 0; b < 8u; b++) {
+            if (!(diff & (1u << b))) continue;
+            uint16_t k;
+            switch (order) {
+                case DISPLAY_MORPH_CENTER_OUT: {
+                    int dist = 2 * (int)d - (int)(digits - 1);
+                    if (dist < 0) dist = -dist;
+                    k = (uint16_t)(dist * 8 + b);
+                    break;
+                }
+                case DISPLAY_MORPH_PARALLEL:     k = rank; break;
+                case DISPLAY_MORPH_SEGMENT_PATH: k = s_morph_path_rank[b]; break;
+                case DISPLAY_MORPH_RANDOM:       // Ключ уникален, порядок задаст перемешивание
+                case DISPLAY_MORPH_SWEEP:
+                default:                         k = (uint16_t)(d * 8u + b); break;
+            }
+            pos[n] = (uint8_t)(d * 8u + b);
+            key[n] = k;
+            n++;
+            rank++;
+        }
+    }
+
+    if (order == DISPLAY_MORPH_RANDOM) {
+        display_rng_stream_shuffle(&g_display->fx_rng_morph, pos, n);
+        for (uint8_t i = 0; i < n; i++) key[i] = i;
+    }
+
+    // Устойчивая сортировка вставками по ключу (n <= 80)
+    for (uint8_t i = 1; i < n; i++) {
+        uint16_t k = key[i];
+        uint8_t p = pos[i];
+        int j = i - 1;
+        while (j >= 0 && key[j] > k) {
+            key[j + 1] = key[j];
+            pos[j + 1] = pos[j];
+            j--;
+        }
+        key[j + 1] = k;
+        pos[j + 1] = p;
+    }
+
+    uint32_t groups = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        if (i == 0 || key[i] != key[i - 1]) groups++;
+    }
+
+    uint32_t steps = g_display->fx_morph_steps;
+    uint32_t group = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        if (i > 0 && key[i] != key[i - 1]) group++;
+        g_display->fx_morph_flip_step[i] = (uint16_t)(1u + group * steps / groups);
+    }
+
+    g_display->fx_morph_flips = n;
+    g_display->fx_morph_applied = 0;
+}
+
+static bool fx_start_morph(uint32_t duration_ms, const vfd_segment_map_t *target, uint32_t steps,
+                           display_morph_order_t order) {
     if (!target || steps==0) return false;
+    if (steps > UINT16_MAX) steps = UINT16_MAX;
     if (!fx_start_basic(FX_MORPH, duration_ms, duration_ms/steps)) return false;
     g_display->fx_morph_steps = steps;
     for(int i=0; i<g_display->digit_count; i++) {
         g_display->fx_morph_start[i] = g_display->content_buffer[i];
         g_display->fx_morph_target[i] = target[i];
+        g_display->fx_morph_segs[i] = g_display->content_buffer[i];
     }
+    fx_morph_build_schedule(order);
     return true;
 }
 
-bool display_fx_dissolve(uint32_t duration_ms) {
+bool display_fx_morph_ordered_ex(display_t *disp, uint32_t duration_ms, const vfd_segment_map_t *target,
+                                 uint32_t steps, display_morph_order_t order) {
+    FX_CALL_ON(disp, fx_start_morph(duration_ms, target, steps, order));
+}
+
+bool display_fx_morph_ordered(uint32_t duration_ms, const vfd_segment_map_t *target, uint32_t steps,
+                              display_morph_order_t order) {
+    return display_fx_morph_ordered_ex(g_display, duration_ms, target, steps, order);
+}
+
+bool display_fx_morph_ex(display_t *disp, uint32_t duration_ms, const vfd_segment_map_t *target, uint32_t steps) {
+    return display_fx_morph_ordered_ex(disp, duration_ms, target, steps, DISPLAY_MORPH_SWEEP);
+}
+
+bool display_fx_morph(uint32_t duration_ms, const vfd_segment_map_t *target, uint32_t steps) {
+    return display_fx_morph_ex(g_display, duration_ms, target, steps);
+}
+
+/*
+ * Общий старт Dissolve/Assemble.
+ * В порядок попадают только горящие сегменты контента, поэтому вся длительность
+ * эффекта тратится на видимые изменения.
+ */
+static bool fx_start_dissolve(fx_type_t type, uint32_t duration_ms) {
     uint8_t digits = g_display->digit_count;
-    uint32_t total = digits * 8;
-    if (!fx_start_basic(FX_DISSOLVE, duration_ms, duration_ms/total)) return false;
+    uint8_t order[VFD_MAX_DIGITS * 8];
+    uint32_t total = 0;
+    for (uint8_t d = 0; d < digits; d++) {
+        vfd_segment_map_t seg = g_display->content_buffer[d];
+        for (uint8_t b = 0; b < 8u; b++) {
+            if (seg & (1u << b)) order[total++] = (uint8_t)(d * 8u + b);
+        }
+    }
+
+    if (!fx_start_basic(type, duration_ms, total ? duration_ms / total : duration_ms)) return false;
+    memcpy(g_display->fx_dissolve_order, order, total);
     g_display->fx_dissolve_total_bits = total;
-    for(uint32_t i=0; i<total; i++) g_display->fx_dissolve_order[i] = i;
-    
+
     // Перемешивание порядка сегментов
-    for(uint32_t i=total-1; i>0; i--) {
-        uint32_t j = display_rng_range(i+1);
-        uint8_t t = g_display->fx_dissolve_order[i];
-        g_display->fx_dissolve_order[i] = g_display->fx_dissolve_order[j];
-        g_display->fx_dissolve_order[j] = t;
+    display_rng_stream_shuffle(&g_display->fx_rng_dissolve, g_display->fx_dissolve_order, total);
+
+    bool assemble = (type == FX_ASSEMBLE);
+    for (uint8_t d = 0; d < digits; d++) {
+        g_display->fx_dissolve_segs[d] = assemble ? 0 : g_display->content_buffer[d];
+        if (assemble) display_ll_set_digit_raw(d, 0);
+    }
+    return true;
+}
+
+bool display_fx_dissolve_ex(display_t *disp, uint32_t duration_ms) { FX_CALL_ON(disp, fx_start_dissolve(FX_DISSOLVE, duration_ms)); }
+bool display_fx_assemble_ex(display_t *disp, uint32_t duration_ms) { FX_CALL_ON(disp, fx_start_dissolve(FX_ASSEMBLE, duration_ms)); }
+
+bool display_fx_dissolve(uint32_t duration_ms) { return display_fx_dissolve_ex(g_display, duration_ms); }
+bool display_fx_assemble(uint32_t duration_ms) { return display_fx_assemble_ex(g_display, duration_ms); }
+
+/* Общая подготовка поразрядных эффектов (после успешного fx_start_basic). */
+static void fx_stage_prepare(const vfd_segment_map_t *target) {
+    uint8_t digits = g_display->digit_count;
+    for (uint8_t d = 0; d < digits; d++) {
+        g_display->fx_target_buffer[d] = target ? target[d] : g_display->content_buffer[d];
+        g_display->fx_stage_segs[d] = g_display->content_buffer[d];
+        g_display->fx_settle_at[d] = 0;
+    }
+    g_display->fx_stage_step = UINT32_MAX; // Первый тик сразу начинает кадр
+}
+
+static bool fx_start_slot_machine(uint32_t duration_ms, const vfd_segment_map_t *target, uint32_t frame_ms) {
+    if (!target) return false;
+    if (!fx_start_basic(FX_SLOT_MACHINE, duration_ms, frame_ms ? frame_ms : 60u)) return false;
+    fx_stage_prepare(target);
+
+    // Крутятся только изменившиеся разряды
+    uint8_t digits = g_display->digit_count;
+    uint32_t rolling = 0;
+    for (uint8_t d = 0; d < digits; d++) {
+        if (target[d] != g_display->content_buffer[d]) rolling++;
+    }
+
+    // Барабаны останавливаются слева направо во второй половине эффекта
+    uint32_t half = duration_ms / 2u;
+    uint32_t k = 0;
+    for (uint8_t d = 0; d < digits; d++) {
+        if (target[d] == g_display->content_buffer[d]) continue;
+        k++;
+        g_display->fx_settle_at[d] = half + (uint32_t)((uint64_t)(duration_ms - half) * k / (rolling + 1u));
+        g_display->fx_roll_idx[d] = (uint8_t)((d * 3u) % 10u); // Барабаны не синхронны
+    }
+    return true;
+}
+
+bool display_fx_slot_machine_ex(display_t *disp, uint32_t duration_ms, const vfd_segment_map_t *target,
+                                uint32_t frame_ms) {
+    FX_CALL_ON(disp, fx_start_slot_machine(duration_ms, target, frame_ms));
+}
+
+bool display_fx_slot_machine(uint32_t duration_ms, const vfd_segment_map_t *target, uint32_t frame_ms) { return display_fx_slot_machine_ex(g_display, duration_ms, target, frame_ms); }
+
+static bool fx_start_decode(uint32_t duration_ms, const vfd_segment_map_t *target) {
+    if (!fx_start_basic(FX_DECODE, duration_ms, 50u)) return false;
+    fx_stage_prepare(target);
+
+    // Первая четверть — только шум, затем разряды фиксируются слева направо
+    uint8_t digits = g_display->digit_count;
+    uint32_t quarter = duration_ms / 4u;
+    for (uint8_t d = 0; d < digits; d++) {
+        g_display->fx_settle_at[d] = quarter + (uint32_t)((uint64_t)(duration_ms - quarter) * (d + 1u) / (digits + 1u));
+    }
+    return true;
+}
+
+bool display_fx_decode_ex(display_t *disp, uint32_t duration_ms, const vfd_segment_map_t *target) {
+    FX_CALL_ON(disp, fx_start_decode(duration_ms, target));
+}
+
+bool display_fx_decode(uint32_t duration_ms, const vfd_segment_map_t *target) { return display_fx_decode_ex(g_display, duration_ms, target); }
+
+static bool fx_start_pingpong(uint32_t duration_ms, const vfd_segment_map_t *target, uint8_t passes) {
+    if (!target) return false;
+    if (passes == 0) passes = 3;
+    uint8_t digits = g_display->digit_count;
+    uint32_t span = (digits > 1) ? (uint32_t)(digits - 1) : 1u;
+    uint32_t steps = (uint32_t)passes * span;
+
+    if (!fx_start_basic(FX_PINGPONG, duration_ms, duration_ms / steps)) return false;
+    fx_stage_prepare(target);
+    g_display->fx_stage_steps = steps;
+    g_display->fx_stage_step = 0;
+    g_display->fx_pingpong_pos = 0;
+    g_display->fx_pingpong_dir = true;
+
+    // Разряд фиксируется, когда маркер покидает его на последнем проходе
+    uint32_t last_pass = steps - span;
+    bool last_forward = (passes & 1u) != 0;
+    for (uint8_t d = 0; d < digits; d++) {
+        uint32_t reach = last_forward ? d : (span - d);
+        g_display->fx_settle_at[d] = last_pass + reach + 1u;
     }
     return true;
 }
 
+bool display_fx_pingpong_ex(display_t *disp, uint32_t duration_ms, const vfd_segment_map_t *target, uint8_t passes) {
+    FX_CALL_ON(disp, fx_start_pingpong(duration_ms, target, passes));
+}
+
+bool display_fx_pingpong(uint32_t duration_ms, const vfd_segment_map_t *target, uint8_t passes) { return display_fx_pingpong_ex(g_display, duration_ms, target, passes); }
+
 /*
  * FIX #18: Корректировка длительности Marquee для обрезанного текста.
  */
-bool display_fx_marquee(const char *text, uint32_t speed_ms) {
+static bool fx_start_marquee(const char *text, uint32_t speed_ms) {
     if (!text) return false;
     uint16_t len = strlen(text);
     if (len == 0) return false;
@@ -481,7 +960,13 @@ bool display_fx_marquee(const char *text, uint32_t speed_ms) {
     return true;
 }
 
-bool display_fx_slide_in(const char *text, uint32_t speed_ms) {
+bool display_fx_marquee_ex(display_t *disp, const char *text, uint32_t speed_ms) {
+    FX_CALL_ON(disp, fx_start_marquee(text, speed_ms));
+}
+
+bool display_fx_marquee(const char *text, uint32_t speed_ms) { return display_fx_marquee_ex(g_display, text, speed_ms); }
+
+static bool fx_start_slide_in(const char *text, uint32_t speed_ms) {
     if (!text) return false;
     uint32_t duration = g_display->digit_count * speed_ms;
 
@@ -490,37 +975,164 @@ bool display_fx_slide_in(const char *text, uint32_t speed_ms) {
     return true;
 }
 
-void display_fx_stop(void) {
-    if (!g_display->fx_active) return;
+bool display_fx_slide_in_ex(display_t *disp, const char *text, uint32_t speed_ms) {
+    FX_CALL_ON(disp, fx_start_slide_in(text, speed_ms));
+}
+
+bool display_fx_slide_in(const char *text, uint32_t speed_ms) { return display_fx_slide_in_ex(g_display, text, speed_ms); }
+
+void display_fx_set_easing_ex(display_t *disp, display_ease_t curve) {
+    if (!disp) return;
+    if (curve >= DISPLAY_EASE_COUNT) curve = DISPLAY_EASE_DEFAULT;
+    disp->fx_ease_select = curve;
+}
+
+void display_fx_set_easing(display_ease_t curve) { display_fx_set_easing_ex(g_display, curve); }
+
+void display_fx_stop_ex(display_t *disp) {
+    if (!disp || !disp->fx_active) return;
+    display_t *prev = display_core_enter(disp);
     fx_finish_internal();
+    display_core_leave(prev);
 }
 
-/* Главный тик анимации. Вызывается из display_core. */
-void display_fx_tick(void) {
-    if (!g_display->fx_active) return;
+void display_fx_stop(void) { display_fx_stop_ex(g_display); }
+
+/*
+ * Главный тик анимации. Вызывается из display_core.
+ * Движок работает с фиксированным шагом: кадр n отрисовывается для времени
+ * n * fx_step_us от старта. Если кадр еще не наступил, тик ничего не считает.
+ * После задержки главного цикла пропущенные кадры не рисуются: движок сразу
+ * переходит к последнему наступившему кадру и учитывает пропуск в статистике.
+ */
+static void fx_tick(void) {
     
-    absolute_time_t now = get_absolute_time();
-    uint32_t elapsed_ms = fx_elapsed_ms(g_display->fx_start_time, now);
-    g_display->fx_elapsed_ms = elapsed_ms;
+    uint64_t elapsed_us = fx_elapsed_us(g_display->fx_start_time, get_absolute_time());
 
-    if (g_display->fx_duration_ms != 0 && elapsed_ms >= g_display->fx_duration_ms) {
+    if (g_display->fx_duration_ms != 0 && elapsed_us >= (uint64_t)g_display->fx_duration_ms * 1000u) {
+        g_display->fx_elapsed_ms = g_display->fx_duration_ms;
         fx_finish_internal();
         return;
     }
 
-    switch (g_display->fx_type) {
-        case FX_FADE_IN:  fx_apply_fade(elapsed_ms, g_display->fx_duration_ms, false); break;
-        case FX_FADE_OUT: fx_apply_fade(elapsed_ms, g_display->fx_duration_ms, true); break;
-        case FX_PULSE:    fx_apply_pulse(elapsed_ms, g_display->fx_duration_ms); break;
-        case FX_WAVE:     fx_apply_wave(elapsed_ms, g_display->fx_duration_ms); break;
-        case FX_GLITCH:   fx_apply_glitch(elapsed_ms); break;
-        case FX_MATRIX:   fx_apply_matrix(elapsed_ms); break;
-        case FX_MORPH:    fx_apply_morph(elapsed_ms, g_display->fx_duration_ms); break;
-        case FX_DISSOLVE: fx_apply_dissolve(elapsed_ms, g_display->fx_duration_ms); break;
-        case FX_MARQUEE:  fx_apply_marquee(elapsed_ms); break;
-        case FX_SLIDE_IN: fx_apply_slide_in(elapsed_ms); break;
-        default: fx_finish_internal(); break;
+    if (elapsed_us < g_display->fx_next_frame_us) return; // Новый кадр еще не наступил
+
+    uint32_t step_us = g_display->fx_step_us;
+    uint64_t behind_us = elapsed_us - g_display->fx_next_frame_us;
+    uint32_t late = 0;
+    if (behind_us >= step_us) {
+        // Только после задержки: behind / step через обратную величину (занижение не больше 1)
+        uint32_t behind = (behind_us > UINT32_MAX) ? UINT32_MAX : (uint32_t)behind_us;
+        late = (uint32_t)(((uint64_t)behind * g_display->fx_inv_step) >> 32);
+        if ((uint64_t)(late + 1u) * step_us <= behind) late++;
+    }
+
+    // Время кадра накапливается из периода (fx_elapsed_ms соответствует кадру fx_frame_no - 1)
+    uint32_t frame = g_display->fx_frame_no + late;
+    fx_advance_elapsed(g_display->fx_frame_no ? late + 1u : late);
+    g_display->fx_frames_skipped += late;
+    g_display->fx_frames_rendered++;
+    g_display->fx_frame_no = frame + 1u;
+    g_display->fx_next_frame_us = (uint64_t)(frame + 1u) * step_us;
+
+    const display_fx_vtable_t *ops = fx_ops(g_display->fx_type);
+    if (!ops) { fx_finish_internal(); return; }
+
+    display_fx_ctx_t ctx;
+    fx_make_ctx(&ctx, ops);
+    if (!ops->tick(&ctx)) fx_finish_internal();
+}
+
+void display_fx_tick_ex(display_t *disp) {
+    if (!disp || !disp->fx_active) return;
+    display_t *prev = display_core_enter(disp);
+    fx_tick();
+    display_core_leave(prev);
+}
+
+void display_fx_tick(void) { display_fx_tick_ex(g_display); }
+
+bool display_fx_is_running(void) { return g_display->fx_active; }
+
+void display_fx_set_frame_rate_ex(display_t *disp, uint16_t fps) {
+    if (!disp) return;
+    if (fps == 0) fps = DISPLAY_FX_DEFAULT_FPS;
+    display_t *prev = display_core_enter(disp);
+    fx_set_step(1000000u / fps);
+    display_core_leave(prev);
+}
+
+void display_fx_set_frame_rate(uint16_t fps) { display_fx_set_frame_rate_ex(g_display, fps); }
+
+bool display_fx_get_stats_ex(const display_t *disp, display_fx_stats_t *stats) {
+    if (!disp || !stats) return false;
+    stats->frames_rendered = disp->fx_frames_rendered;
+    stats->frames_skipped  = disp->fx_frames_skipped;
+    stats->frame_period_us = disp->fx_step_us;
+    stats->requested_ms    = disp->fx_duration_ms;
+    stats->actual_ms       = disp->fx_actual_ms;
+    return true;
+}
+
+bool display_fx_get_stats(display_fx_stats_t *stats) { return display_fx_get_stats_ex(g_display, stats); }
+
+uint32_t display_fx_get_flags(void) {
+    if (!g_display->fx_active) return 0;
+    const display_fx_vtable_t *ops = fx_ops(g_display->fx_type);
+    return ops ? ops->flags : 0;
+}
+
+bool display_fx_register(const display_fx_vtable_t *vt, fx_type_t *out_type) {
+    if (!vt || !vt->tick) return false;
+    if (s_fx_user_count >= DISPLAY_FX_MAX_USER) return false;
+
+    s_fx_user[s_fx_user_count] = vt;
+    if (out_type) *out_type = (fx_type_t)(FX_USER_FIRST + s_fx_user_count);
+    s_fx_user_count++;
+    LOG_INFO("FX: registered '%s'", vt->name ? vt->name : "?");
+    return true;
+}
+
+void display_fx_set_arena_ex(display_t *disp, void *mem, size_t size) {
+    if (!disp) return;
+    display_fx_stop_ex(disp);
+    disp->fx_arena = mem;
+    disp->fx_arena_size = mem ? size : 0;
+}
+
+void display_fx_set_arena(void *mem, size_t size) { display_fx_set_arena_ex(g_display, mem, size); }
+
+static bool fx_start_user(fx_type_t type, uint32_t duration_ms, uint32_t frame_ms, const void *args) {
+    if ((unsigned)type < FX_USER_FIRST) return false; // Встроенные запускаются своими функциями
+    const display_fx_vtable_t *ops = fx_ops(type);
+    if (!ops) return false;
+    if (ops->state_size > g_display->fx_arena_size) {
+        LOG_ERROR("FX: '%s' needs %u bytes of arena", ops->name ? ops->name : "?", (unsigned)ops->state_size);
+        return false;
+    }
+
+    if (!fx_start_basic(type, duration_ms, frame_ms)) return false;
+    if (ops->state_size) memset(g_display->fx_arena, 0, ops->state_size);
+
+    display_fx_ctx_t ctx;
+    fx_make_ctx(&ctx, ops);
+    if (ops->start && !ops->start(&ctx, args)) {
+        // Отмена: снимок не применялся, достаточно снять флаги без колбэков
+        DISPLAY_TRACE(DISPLAY_TRACE_FX_FINISH, &g_display->ll, type, 0);
+        g_display->saved_valid = false;
+        g_display->fx_active = false;
+        g_display->fx_type = FX_NONE;
+        return false;
     }
+    return true;
+}
+
+bool display_fx_start_ex(display_t *disp, fx_type_t type, uint32_t duration_ms, uint32_t frame_ms, const void *args) {
+    FX_CALL_ON(disp, fx_start_user(type, duration_ms, frame_ms, args));
+}
+
+bool display_fx_start(fx_type_t type, uint32_t duration_ms, uint32_t frame_ms, const void *args) {
+    return display_fx_start_ex(g_display, type, duration_ms, frame_ms, args);
 }
 
-bool display_fx_is_running(void) { return g_display->fx_active; }
\ No newline at end of file
+#undef FX_CALL_ON
@@ -1,9 +1,15 @@
 #include "display_ll.h"
+#include "display_trace.h"
 
 #include "pico/stdlib.h"
 #include "hardware/gpio.h"
 #include "hardware/timer.h"
 #include "hardware/sync.h"
+#include "hardware/irq.h"
+#include "hardware/clocks.h"
+#if !PICO_NO_HARDWARE
+#include "hardware/structs/timer.h"
+#endif
 
 #include <string.h>
 #include <assert.h> // FIX #4: Для отладочных проверок
@@ -13,9 +19,15 @@
  * Реализация драйвера управления аппаратным обеспечением.
  *
  * Основные механизмы:
- * - Мультиплексирование через повторяющийся таймер (repeating_timer).
- * - Регулировка яркости (PWM) через аппаратный будильник (alarm).
+ * - Мультиплексирование и гашение PWM через два аппаратных будильника
+ *   (слоты и гашения), общих для всех экземпляров (display_ll_t). Будильники
+ *   программируются напрямую, их ISR и весь путь вывода размещены в RAM
+ *   (__not_in_flash_func), поэтому развертка не зависит от alarm pool
+ *   приложения и от занятости flash.
  * - Программная эмуляция SPI (Bit-banging).
+ * - Опциональный регулятор частоты (Governor) по измеренной нагрузке ISR.
+ * - Опциональная остановка развертки на полностью темном кадре (dark_suspend).
+ * - Ограничитель мощности: PWM для ISR (pwm[]) считается при публикации кадра.
  *
  * Модель синхронизации (Issue #10):
  * - Спинлоки удалены как избыточные.
@@ -29,89 +41,226 @@
 //  КОНФИГУРАЦИЯ
 // ============================================================================
 
-#define LL_SHIFT_DELAY() __asm volatile ("nop\n nop\n nop\n");
+// Минимальная длительность импульсов CLOCK/LATCH 74HC595 (3 такта на 125 МГц).
+// Задержка в тактах пересчитывается от фактической clk_sys (display_ll_retime).
+#ifndef LL_SHIFT_PULSE_NS
+#define LL_SHIFT_PULSE_NS 24u
+#endif
 #define LL_MIN_PULSE_US   4
 
+// Регулятор частоты: окно измерения, целевая нагрузка по умолчанию, шаг (1/8 частоты).
+#define LL_GOV_WINDOW_US         100000u
+#define LL_GOV_DEFAULT_LOAD_PCT  25u
+#define LL_GOV_STEP_SHIFT        3
+
+// Уровень приоритета NVIC: Cortex-M0+ учитывает только 2 старших бита
+#define LL_NVIC_LEVEL(prio)      ((uint8_t)(prio) >> 6)
+
 // ============================================================================
 //  ВНУТРЕННЕЕ СОСТОЯНИЕ
 // ============================================================================
 
+/* Аппаратный будильник, запрограммированный напрямую (без alarm pool). */
 typedef struct
 {
-    // Флаги состояния
-    bool initialized;
-    bool refresh_running;
-
-    // Конфигурация GPIO
-    uint8_t data_pin;
-    uint8_t clock_pin;
-    uint8_t latch_pin;
-
-    // Параметры дисплея
-    uint8_t  digit_count;
-    uint16_t refresh_rate_hz;
-    uint32_t slot_period_us;
-
-    // Буферы данных
-    vfd_segment_map_t seg_buffer[VFD_MAX_DIGITS];
-    uint8_t           brightness[VFD_MAX_DIGITS];
-
-    // Контекст развертки
-    uint8_t current_digit;
-    bool extended_grid_mode; 
+    int8_t   cfg;        // Запрошенный будильник (-1 = любой свободный)
+    int8_t   num;        // Захваченный будильник (-1 = еще не захвачен)
+    uint8_t  priority;   // Приоритет NVIC
+    bool     armed;
+    uint32_t target_us;  // Цель взведенного будильника
+} ll_alarm_t;
 
-    struct repeating_timer fast_timer;
-    alarm_id_t clear_alarm;
-
-    bool gamma_enabled;
-
-} display_ll_state_t;
-
-static display_ll_state_t s_ll;
+/*
+ * Общий таймер развертки.
+ * Два будильника на все экземпляры: scan выполняет слоты, edge — гашения PWM.
+ * Прерывание edge имеет более высокий приоритет, поэтому вывод слотов других
+ * экземпляров не задерживает гашение. Каждый ISR выполняет наступившие события
+ * и взводит свой будильник на ближайшее.
+ * Список меняется только при отключенных прерываниях.
+ */
+typedef struct
+{
+    display_ll_t *list[DISPLAY_LL_MAX_INSTANCES];
+    uint8_t       count;
+
+    ll_alarm_t    scan;
+    ll_alarm_t    edge;
+
+    // Статистика ISR развертки
+    uint32_t      irq_count;
+    uint32_t      latency_max_us;
+    uint64_t      latency_sum_us;
+    uint32_t      isr_max_us;
+} ll_timer_t;
+
+static uint32_t      s_shift_cycles;   // Задержка импульса в тактах clk_sys (0 = еще не рассчитана)
+static ll_timer_t    s_timer = {
+    .scan = { .cfg = -1, .num = -1, .priority = PICO_DEFAULT_IRQ_PRIORITY },
+    .edge = { .cfg = -1, .num = -1, .priority = DISPLAY_LL_EDGE_IRQ_PRIORITY },
+};
+static display_ll_t  s_ll_default;
+static display_ll_t *s_ll = &s_ll_default;
 
 // ============================================================================
 //  BIT-BANGING (SPI EMULATION)
 // ============================================================================
 
+/* Удержание уровня CLOCK/LATCH не короче LL_SHIFT_PULSE_NS при текущей clk_sys. */
+static inline void __not_in_flash_func(ll_shift_delay)(void)
+{
+    busy_wait_at_least_cycles(s_shift_cycles);
+}
+
 /* Программная отправка байта (MSB first). */
-static inline void ll_shift_byte(uint8_t data)
+static inline void __not_in_flash_func(ll_shift_byte)(display_ll_t *ll, uint8_t data)
 {
     for (int i = 7; i >= 0; i--)
     {
-        gpio_put(s_ll.data_pin, (data >> i) & 1u);
-        gpio_put(s_ll.clock_pin, 1);
-        LL_SHIFT_DELAY();
-        gpio_put(s_ll.clock_pin, 0);
+        gpio_put(ll->data_pin, (data >> i) & 1u);
+        gpio_put(ll->clock_pin, 1);
+        ll_shift_delay();
+        gpio_put(ll->clock_pin, 0);
     }
 }
 
 /* Защелкивание данных (Latch pulse). */
-static inline void ll_latch(void)
+static inline void __not_in_flash_func(ll_latch)(display_ll_t *ll)
+{
+    gpio_put(ll->latch_pin, 1);
+    ll_shift_delay();
+    gpio_put(ll->latch_pin, 0);
+    ll_shift_delay();
+}
+
+/*
+ * Отправка кадра по раздельным линиям (SPLIT / SPLIT3).
+ * Все линии выставляются одной записью gpio_put_masked() на такт.
+ * SPLIT с двумя байтами сетки: 16 тактов, сегменты идут в последних 8
+ * (первые 8 бит вытесняются из регистра сегментов).
+ */
+static void __not_in_flash_func(ll_shift_split)(display_ll_t *ll, uint16_t grid_data, uint8_t segs)
 {
-    gpio_put(s_ll.latch_pin, 1);
-    LL_SHIFT_DELAY();
-    gpio_put(s_ll.latch_pin, 0);
-    LL_SHIFT_DELAY();
+    uint32_t grid_bit = 1u << ll->data_pin;
+    uint32_t seg_bit  = 1u << ll->seg_data_pin;
+    uint32_t hi_bit   = 1u << ll->grid_hi_data_pin;
+
+    uint8_t  lo = (uint8_t)(grid_data & 0xFFu);
+    uint8_t  hi = (uint8_t)((grid_data >> 8) & 0xFFu);
+    bool     three = (ll->bus == DISPLAY_LL_BUS_SPLIT3);
+
+    // Слово линии сетки в порядке ll_shift_frame(): младший байт первым
+    uint16_t grid_word = (ll->extended_grid_mode && !three) ? (uint16_t)((lo << 8) | hi) : lo;
+    int clocks = (ll->extended_grid_mode && !three) ? 16 : 8;
+
+    for (int k = clocks - 1; k >= 0; k--) {
+        uint32_t value = 0;
+        if ((grid_word >> k) & 1u) value |= grid_bit;
+        if (k < 8 && ((segs >> k) & 1u)) value |= seg_bit;
+        if (three && ((hi >> k) & 1u)) value |= hi_bit;
+        gpio_put_masked(ll->bus_mask, value);
+        gpio_put(ll->clock_pin, 1);
+        ll_shift_delay();
+        gpio_put(ll->clock_pin, 0);
+    }
+
+    ll_latch(ll);
 }
 
 /* 
  * Отправка кадра данных.
  * Порядок вывода: [Grid Low] -> (Grid High) -> [Segments]
  */
-static inline void ll_shift_frame(uint16_t grid_data, uint8_t segs)
+static inline void __not_in_flash_func(ll_shift_frame)(display_ll_t *ll, uint16_t grid_data, uint8_t segs)
 {
+    if (ll->bus != DISPLAY_LL_BUS_SERIAL) {
+        ll_shift_split(ll, grid_data, segs);
+        return;
+    }
+
     // 1. Младший байт сетки (Grids 0-7)
-    ll_shift_byte((uint8_t)(grid_data & 0xFFu));
+    ll_shift_byte(ll, (uint8_t)(grid_data & 0xFFu));
     
     // 2. Старший байт сетки (Grids 8-15)
-    if (s_ll.extended_grid_mode) {
-        ll_shift_byte((uint8_t)((grid_data >> 8) & 0xFFu));
+    if (ll->extended_grid_mode) {
+        ll_shift_byte(ll, (uint8_t)((grid_data >> 8) & 0xFFu));
     }
 
     // 3. Сегменты
-    ll_shift_byte(segs);
+    ll_shift_byte(ll, segs);
+
+    ll_latch(ll);
+}
+
+/* Такт CLOCK после выставления линий DATA. */
+static inline void __not_in_flash_func(ll_clock_pulse)(display_ll_t *ll)
+{
+    gpio_put(ll->clock_pin, 1);
+    ll_shift_delay();
+    gpio_put(ll->clock_pin, 0);
+}
+
+/*
+ * Параллельная отправка кадра во все цепочки.
+ * Бит всех линий DATA выставляется одной записью gpio_put_masked(), поэтому
+ * время слота не зависит от числа цепочек. Цепочки вне chain_lit получают
+ * пустой кадр (0 для сетки и сегментов). Порядок байтов — как в ll_shift_frame().
+ */
+static void __not_in_flash_func(ll_shift_chains)(display_ll_t *ll)
+{
+    uint32_t lit_pins = 0;
+    for (uint8_t c = 0; c < ll->chain_count; c++) {
+        if (ll->chain_lit & (1u << c)) lit_pins |= ll->chain_mask[c];
+    }
+
+    // Сетка одинакова у всех светящихся цепочек
+    uint16_t grid = ll->chain_grid;
+    int grid_bits = ll->extended_grid_mode ? 16 : 8;
+    for (int b = 0; b < grid_bits; b++) {
+        // Младший байт первым, внутри байта MSB first
+        int bit = (b < 8) ? (7 - b) : (15 - (b - 8));
+        gpio_put_masked(ll->data_mask, ((grid >> bit) & 1u) ? lit_pins : 0u);
+        ll_clock_pulse(ll);
+    }
+
+    for (int i = 7; i >= 0; i--) {
+        uint32_t value = 0;
+        for (uint8_t c = 0; c < ll->chain_count; c++) {
+            if ((ll->chain_segs[c] >> i) & 1u) value |= ll->chain_mask[c];
+        }
+        gpio_put_masked(ll->data_mask, value & lit_pins);
+        ll_clock_pulse(ll);
+    }
+
+    ll_latch(ll);
+}
+
+/* Пустой кадр во все цепочки. */
+static inline void __not_in_flash_func(ll_blank)(display_ll_t *ll)
+{
+    if (ll->chain_count > 1) {
+        ll->chain_lit = 0;
+        ll_shift_chains(ll);
+    } else {
+        ll_shift_frame(ll, 0x0000, 0x00);
+    }
+}
+
+/* Парковка линий сдвиговых регистров (все в 0) на время остановки развертки. */
+static inline void __not_in_flash_func(ll_park_lines)(display_ll_t *ll)
+{
+    if (ll->chain_count > 1) gpio_put_masked(ll->data_mask, 0u);
+    else if (ll->bus != DISPLAY_LL_BUS_SERIAL) gpio_put_masked(ll->bus_mask, 0u);
+    else gpio_put(ll->data_pin, 0);
+    gpio_put(ll->clock_pin, 0);
+    gpio_put(ll->latch_pin, 0);
+}
 
-    ll_latch();
+/* Обновление бита разряда в маске светящихся разрядов. */
+static inline void ll_update_lit(display_ll_t *ll, uint8_t idx)
+{
+    uint16_t bit = (uint16_t)(1u << idx);
+    if (ll->seg_buffer[idx] != 0 && ll->brightness[idx] != 0) ll->lit_mask |= bit;
+    else ll->lit_mask &= (uint16_t)~bit;
 }
 
 // ============================================================================
@@ -132,90 +281,753 @@ static inline uint8_t ll_gamma_calc(uint8_t x)
     return (uint8_t)v;
 }
 
+/*
+ * Обратная гамма: x = sqrt(y * 255), целочисленный корень.
+ */
+static uint8_t ll_gamma_inv_calc(uint8_t y)
+{
+    if (y == 0) return 0;
+    if (y == 255) return 255;
+
+    uint32_t v = (uint32_t)y * 255u;
+    uint32_t r = 0;
+    for (uint32_t bit = 1u << 14; bit; bit >>= 2) {
+        if (v >= r + bit) { v -= r + bit; r = (r >> 1) + bit; }
+        else r >>= 1;
+    }
+    return (uint8_t)r;
+}
+
+// ============================================================================
+//  ОГРАНИЧИТЕЛЬ МОЩНОСТИ
+// ============================================================================
+
+/* Оценка нагрузки разряда: число горящих сегментов × яркость (макс. 8 × 255). */
+static inline uint16_t ll_digit_load(display_ll_t *ll, uint8_t idx)
+{
+    return (uint16_t)((uint32_t)__builtin_popcount(ll->seg_buffer[idx]) * ll->brightness[idx]);
+}
+
+/* Итоговый PWM разряда с учетом текущего ограничения. */
+static inline uint8_t ll_limited_pwm(display_ll_t *ll, uint8_t idx)
+{
+    uint8_t lvl = ll->brightness[idx];
+    if (ll->power_budget == 0) return lvl;
+
+    if (ll->power_mode == DISPLAY_LL_POWER_GLOBAL) {
+        return (uint8_t)(((uint32_t)lvl * ll->power_scale) >> 8);
+    }
+
+    uint16_t load = ll->digit_load[idx];
+    if (load <= ll->power_digit_limit) return lvl;
+    return (uint8_t)((uint32_t)lvl * ll->power_digit_limit / load);
+}
+
+/* Пересчет глобального коэффициента. Возвращает true, если он изменился. */
+static inline bool ll_power_rescale(display_ll_t *ll)
+{
+    if (ll->power_budget == 0 || ll->power_mode != DISPLAY_LL_POWER_GLOBAL) return false;
+
+    uint16_t scale = 256;
+    if (ll->total_load > ll->power_limit) {
+        scale = (uint16_t)((ll->power_limit << 8) / ll->total_load);
+    }
+    if (scale == ll->power_scale) return false;
+    ll->power_scale = scale;
+    return true;
+}
+
+/* Инкрементальное обновление после изменения одного разряда. */
+static void ll_power_update(display_ll_t *ll, uint8_t idx)
+{
+    uint16_t load = ll_digit_load(ll, idx);
+    ll->total_load = ll->total_load - ll->digit_load[idx] + load;
+    ll->digit_load[idx] = load;
+
+    if (ll_power_rescale(ll)) {
+        for (uint8_t i = 0; i < ll->digit_count; i++) ll->pwm[i] = ll_limited_pwm(ll, i);
+    } else {
+        ll->pwm[idx] = ll_limited_pwm(ll, idx);
+    }
+}
+
+/* Полный пересчет (публикация кадра, смена бюджета, яркость для всех разрядов). */
+static void ll_power_update_all(display_ll_t *ll)
+{
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < ll->digit_count; i++) {
+        ll->digit_load[i] = ll_digit_load(ll, i);
+        total += ll->digit_load[i];
+    }
+    ll->total_load = total;
+    ll_power_rescale(ll);
+    for (uint8_t i = 0; i < ll->digit_count; i++) ll->pwm[i] = ll_limited_pwm(ll, i);
+}
+
 // ============================================================================
 //  ОБРАБОТЧИКИ ПРЕРЫВАНИЙ (IRQ)
 // ============================================================================
 
 /*
- * Callback аппаратного будильника (PWM OFF).
- * Гасит дисплей (отправляет нули), соблюдая разрядность шины.
+ * Гашение PWM (событие clear_at_us общего таймера).
+ * Одиночная цепочка получает пустой кадр. В режиме параллельных цепочек
+ * отсечки разные: гасятся цепочки с наступившей отсечкой, гашение
+ * переназначается на следующую.
+ */
+static void __not_in_flash_func(ll_clear_edge)(display_ll_t *ll)
+{
+    uint32_t t0 = time_us_32();
+    ll->clear_pending = false;
+
+    // Опоздание фронта относительно расчетного времени гашения
+    uint32_t late = t0 - ll->clear_at_us;
+    if ((int32_t)late < 0) late = 0;
+    if (late > ll->edge_late_max_us) ll->edge_late_max_us = late;
+    ll->edge_late_sum_us += late;
+    ll->edge_count++;
+
+    if (ll->chain_count > 1) {
+        uint32_t cut  = ll->chain_cut_at;
+        uint32_t next = UINT32_MAX;
+        for (uint8_t c = 0; c < ll->chain_count; c++) {
+            if (!(ll->chain_lit & (1u << c))) continue;
+            if (ll->chain_cut_us[c] <= cut) ll->chain_lit &= (uint8_t)~(1u << c);
+            else if (ll->chain_cut_us[c] < next) next = ll->chain_cut_us[c];
+        }
+        ll_shift_chains(ll);
+
+        if (next != UINT32_MAX) {
+            // Отсчет от времени предыдущей отсечки, без накопления задержки
+            ll->chain_cut_at   = next;
+            ll->clear_at_us   += next - cut;
+            ll->clear_pending  = true;
+        }
+    } else {
+        // Отправляем пустой кадр (0 для сеток, 0 для сегментов)
+        ll_shift_frame(ll, 0x0000, 0x00);
+    }
+
+    ll->win_busy_us += time_us_32() - t0;
+}
+
+/*
+ * Взвод будильника на абсолютное время target.
+ * Возвращает false, если время уже наступило (будильник не взведен).
+ */
+static bool __not_in_flash_func(ll_hw_arm)(ll_alarm_t *a, uint32_t target)
+{
+    uint alarm = (uint)a->num;
+    a->target_us = target;
+
+#if !PICO_NO_HARDWARE
+    uint32_t bit = 1u << alarm;
+    timer_hw->alarm[alarm] = target;
+    // Будильник срабатывает на точном совпадении: прошедшая цель ждала бы переполнения счетчика
+    if ((int32_t)(target - timer_hw->timerawl) <= 0) {
+        timer_hw->armed = bit;
+        timer_hw->intr  = bit;
+        a->armed = false;
+        return false;
+    }
+#else
+    int32_t dt = (int32_t)(target - time_us_32());
+    if (dt <= 0 || hardware_alarm_set_target(alarm, from_us_since_boot(time_us_64() + (uint32_t)dt))) {
+        a->armed = false;
+        return false;
+    }
+#endif
+
+    a->armed = true;
+    return true;
+}
+
+static void ll_hw_disarm(ll_alarm_t *a)
+{
+    if (a->num < 0) return;
+#if !PICO_NO_HARDWARE
+    timer_hw->armed = 1u << a->num;
+#else
+    hardware_alarm_cancel((uint)a->num);
+#endif
+    a->armed = false;
+}
+
+/* Ближайшее гашение среди активных экземпляров. false — гашений нет. */
+static bool __not_in_flash_func(ll_next_edge)(uint32_t now, uint32_t *at)
+{
+    bool    any  = false;
+    int32_t best = 0;
+
+    for (uint8_t i = 0; i < s_timer.count; i++) {
+        const display_ll_t *ll = s_timer.list[i];
+        if (ll->suspended || !ll->clear_pending) continue;
+        int32_t d = (int32_t)(ll->clear_at_us - now);
+        if (!any || d < best) best = d;
+        any = true;
+    }
+
+    *at = now + (uint32_t)best;
+    return any;
+}
+
+/* Проход будильника гашения: наступившие гашения всех экземпляров и перевзвод. */
+static void __not_in_flash_func(ll_edge_service)(void)
+{
+    for (;;) {
+        uint32_t now = time_us_32();
+
+        for (uint8_t i = 0; i < s_timer.count; i++) {
+            display_ll_t *ll = s_timer.list[i];
+            if (ll->suspended || !ll->clear_pending) continue;
+            if ((int32_t)(now - ll->clear_at_us) >= 0) ll_clear_edge(ll);
+        }
+
+        uint32_t at;
+        if (!ll_next_edge(time_us_32(), &at)) break;
+        if (ll_hw_arm(&s_timer.edge, at)) break;
+    }
+}
+
+/*
+ * Назначение гашения из слота.
+ * Прерывание гашения приоритетнее, поэтому запись и перевзвод — при отключенных
+ * прерываниях. Если фронт уже наступил, гашение выполняется сразу.
  */
-static int64_t ll_clear_cb(alarm_id_t id, void *user_data)
+static void __not_in_flash_func(ll_edge_schedule)(display_ll_t *ll, uint32_t at)
+{
+    uint32_t irq = save_and_disable_interrupts();
+    ll->clear_at_us   = at;
+    ll->clear_pending = true;
+
+    // Взведенный раньше будильник сам пересчитает ближайшее гашение
+    bool earlier = s_timer.edge.armed && (int32_t)(at - s_timer.edge.target_us) >= 0;
+    if (!earlier && !ll_hw_arm(&s_timer.edge, at)) ll_edge_service();
+    restore_interrupts(irq);
+}
+
+/* Снятие гашения, не выполненного до начала следующего слота (фронт вытеснен слотом). */
+static inline void __not_in_flash_func(ll_edge_drop)(display_ll_t *ll)
+{
+    uint32_t irq = save_and_disable_interrupts();
+    if (ll->clear_pending) {
+        ll->clear_pending = false;
+        ll->edges_dropped++;
+    }
+    restore_interrupts(irq);
+}
+
+/* Длительность свечения для PWM 1..254 в слоте текущего периода. */
+static inline uint32_t __not_in_flash_func(ll_pwm_on_us)(display_ll_t *ll, uint8_t pwm)
+{
+    uint32_t on_us = ((uint32_t)pwm * ll->slot_period_us) >> 8;
+    uint32_t max_safe_us = ll->slot_period_us > 10 ? ll->slot_period_us - 10 : ll->slot_period_us;
+
+    if (on_us > max_safe_us) on_us = max_safe_us;
+    if (on_us < LL_MIN_PULSE_US) on_us = LL_MIN_PULSE_US;
+    return on_us;
+}
+
+/* Пересчет периода слота для заданной частоты обновления. */
+static inline uint32_t __not_in_flash_func(ll_slot_period_for)(display_ll_t *ll, uint16_t rate_hz)
+{
+    uint32_t slots_per_sec = (uint32_t)rate_hz * ll->scan_digits;
+    if (slots_per_sec == 0) return 100;
+    uint32_t period = 1000000u / slots_per_sec;
+    return period ? period : 100;
+}
+
+/* Применение периода, выбранного регулятором (граница цикла развертки или старт). */
+static inline void __not_in_flash_func(ll_apply_pending_period)(display_ll_t *ll)
 {
-    (void)id;
-    (void)user_data;
-    // Отправляем пустой кадр (0 для сеток, 0 для сегментов)
-    ll_shift_frame(0x0000, 0x00);
-    return 0;
+    if (!ll->gov_pending_period_us) return;
+    ll->slot_period_us = ll->gov_pending_period_us;
+    ll->refresh_rate_hz = ll->gov_pending_rate_hz;
+    ll->gov_pending_period_us = 0;
 }
 
 /*
- * Callback повторяющегося таймера (Multiplexing Step).
+ * Регулятор частоты.
+ * Вызывается раз в окно LL_GOV_WINDOW_US: оценивает долю времени в ISR и
+ * пропуски слотов, при необходимости планирует новый период.
+ * Сам период меняется только в начале цикла развертки (см. ll_slot).
  */
-static bool ll_fast_timer_cb(struct repeating_timer *t)
+static void __not_in_flash_func(ll_governor_window)(display_ll_t *ll, uint32_t now)
 {
-    (void)t;
+    uint32_t span = now - ll->win_start_us;
+    if (span == 0) return;
+
+    // Окно ~100 мс: произведение помещается в 32 бита, 64-битное деление (во flash) не нужно
+    uint32_t busy = ll->win_busy_us < span ? ll->win_busy_us : span;
+    uint32_t load = busy * 100u / span;
+    ll->isr_load_pct = (uint8_t)load;
+
+    if (ll->gov_enabled) {
+        // Шаг от последнего решения, даже если оно еще ждет границы цикла
+        uint16_t target = ll->gov_pending_period_us ? ll->gov_pending_rate_hz : ll->refresh_rate_hz;
+        uint16_t rate = target;
+        uint16_t step = (uint16_t)(rate >> LL_GOV_STEP_SHIFT);
+        if (step == 0) step = 1;
+
+        if (ll->win_missed > 0 || load > ll->gov_load_pct) {
+            // Перегрузка: снижаем частоту
+            rate = (rate > ll->gov_min_hz + step) ? (uint16_t)(rate - step) : ll->gov_min_hz;
+        } else if (load < ll->gov_load_pct / 2u) {
+            // Запас по времени: повышаем частоту
+            rate = (rate + step < ll->gov_max_hz) ? (uint16_t)(rate + step) : ll->gov_max_hz;
+        }
 
-    if (!s_ll.initialized) return true;
+        if (rate != target) {
+            ll->gov_pending_rate_hz   = rate;
+            ll->gov_pending_period_us = ll_slot_period_for(ll, rate);
+        }
+    }
 
-    uint8_t digit = s_ll.current_digit;
-    if (digit >= s_ll.digit_count) digit = 0;
+    ll->win_start_us = now;
+    ll->win_busy_us  = 0;
+    ll->win_missed   = 0;
+}
 
+/* Вывод разряда в одиночную цепочку и назначение гашения по PWM. */
+static void __not_in_flash_func(ll_slot_single)(display_ll_t *ll, uint8_t digit)
+{
     // Атомарное чтение данных для текущего разряда
     uint32_t irq = save_and_disable_interrupts();
-    vfd_segment_map_t segs = s_ll.seg_buffer[digit];
-    uint8_t           pwm  = s_ll.brightness[digit];
+    vfd_segment_map_t segs = ll->seg_buffer[digit];
+    uint8_t           pwm  = ll->pwm[digit];
     restore_interrupts(irq);
 
     uint16_t grid_pattern = (uint16_t)(1u << digit);
 
     // Вывод данных
-    ll_shift_frame(grid_pattern, segs);
+    ll_shift_frame(ll, grid_pattern, segs);
 
     // Логика PWM
     if (pwm == 0)
     {
-        ll_shift_frame(0x0000, 0x00);
+        ll_shift_frame(ll, 0x0000, 0x00);
     }
     else if (pwm < 255)
     {
-        if (s_ll.clear_alarm >= 0) {
-            cancel_alarm(s_ll.clear_alarm);
-            s_ll.clear_alarm = -1;
-        }
+        ll_edge_schedule(ll, time_us_32() + ll_pwm_on_us(ll, pwm));
+    }
+}
+
+/*
+ * Вывод сетки grid во все цепочки одним проходом.
+ * Цепочка c показывает разряд c * scan_digits + grid; PWM у каждой цепочки свой.
+ * Цепочки с нулевым PWM сразу получают пустой кадр (как одиночная цепочка после гашения).
+ */
+static void __not_in_flash_func(ll_slot_chains)(display_ll_t *ll, uint8_t grid)
+{
+    uint8_t  lit   = 0;
+    uint32_t first = UINT32_MAX;
 
-        uint32_t on_us = ((uint32_t)pwm * s_ll.slot_period_us) >> 8;
-        uint32_t max_safe_us = s_ll.slot_period_us > 10 ? s_ll.slot_period_us - 10 : s_ll.slot_period_us;
-        
-        if (on_us > max_safe_us) on_us = max_safe_us;
-        if (on_us < LL_MIN_PULSE_US) on_us = LL_MIN_PULSE_US;
-
-        alarm_id_t new_id = add_alarm_in_us((int64_t)on_us, ll_clear_cb, NULL, true);
-        if (new_id >= 0) s_ll.clear_alarm = new_id;
-        else {
-            ll_shift_frame(0x0000, 0x00);
-            s_ll.clear_alarm = -1;
+    uint32_t irq = save_and_disable_interrupts();
+    for (uint8_t c = 0; c < ll->chain_count; c++) {
+        uint8_t idx = (uint8_t)(c * ll->scan_digits + grid);
+        uint8_t pwm = ll->pwm[idx];
+        ll->chain_segs[c] = ll->seg_buffer[idx];
+        ll->chain_cut_us[c] = UINT32_MAX;
+        if (pwm == 0) continue;
+        lit |= (uint8_t)(1u << c);
+        if (pwm < 255) {
+            ll->chain_cut_us[c] = ll_pwm_on_us(ll, pwm);
+            if (ll->chain_cut_us[c] < first) first = ll->chain_cut_us[c];
         }
     }
+    restore_interrupts(irq);
+
+    ll->chain_grid = (uint16_t)(1u << grid);
+    ll->chain_lit  = lit;
+    ll_shift_chains(ll);
+
+    if (first == UINT32_MAX) return;
+
+    ll->chain_cut_at = first;
+    ll_edge_schedule(ll, time_us_32() + first);
+}
+
+/*
+ * Слот развертки экземпляра (Multiplexing Step).
+ * Вызывается из общего таймера, когда наступило время next_slot_us.
+ */
+static void __not_in_flash_func(ll_slot)(display_ll_t *ll)
+{
+    if (!ll->initialized) return;
+
+    uint32_t t0 = time_us_32();
+
+    // Учет пропущенных слотов: вызов опоздал больше чем на период
+    int32_t late = (int32_t)(t0 - ll->next_slot_us);
+    if (late > (int32_t)ll->slot_period_us) {
+        uint32_t lost = (uint32_t)late / ll->slot_period_us;
+        ll->win_missed   += lost;
+        ll->missed_slots += lost;
+        ll->next_slot_us  = t0;
+    }
+
+    // Гашение предыдущего слота назначено раньше конца слота; если оно не успело — вытесняется
+    if (ll->clear_pending) ll_edge_drop(ll);
+
+    uint8_t digit = ll->current_digit;
+    if (digit >= ll->scan_digits) digit = 0;
+
+#if VFD_TRACE
+    // Первый слот после смены кадра: время от публикации до вывода
+    if (ll->trace_commit_us) {
+        DISPLAY_TRACE(DISPLAY_TRACE_LL_VISIBLE, ll, t0 - ll->trace_commit_us, digit);
+        ll->trace_commit_us = 0;
+    }
+#endif
+
+    // Темный кадр: гасим, паркуем линии и исключаем экземпляр из развертки до появления контента
+    if (digit == 0 && ll->dark_suspend && ll->lit_mask == 0) {
+        ll_edge_drop(ll);
+        ll_blank(ll);
+        ll_park_lines(ll);
+        ll->current_digit = 0;
+        ll->suspended = true;
+        return;
+    }
+
+    // Граница цикла развертки: безопасная точка смены периода.
+    // Период и PWM текущего слота считаются от одного значения, поэтому скачка яркости нет.
+    if (digit == 0) ll_apply_pending_period(ll);
+    ll->next_slot_us += ll->slot_period_us;
+
+    if (ll->chain_count > 1) ll_slot_chains(ll, digit);
+    else ll_slot_single(ll, digit);
 
     digit++;
-    if (digit >= s_ll.digit_count) digit = 0;
-    s_ll.current_digit = digit;
+    if (digit >= ll->scan_digits) digit = 0;
+    ll->current_digit = digit;
+
+    uint32_t t1 = time_us_32();
+    if (digit == 0 && ll->first_frame_us == 0) ll->first_frame_us = t1 ? t1 : 1;
+    ll->win_busy_us += t1 - t0;
+    if (t1 - ll->win_start_us >= LL_GOV_WINDOW_US) ll_governor_window(ll, t1);
+}
+
+/* Ближайший слот среди активных экземпляров. false — активных нет. */
+static bool __not_in_flash_func(ll_next_slot)(uint32_t now, uint32_t *at)
+{
+    bool    any  = false;
+    int32_t best = 0;
+
+    for (uint8_t i = 0; i < s_timer.count; i++) {
+        const display_ll_t *ll = s_timer.list[i];
+        if (ll->suspended) continue;
+        int32_t d = (int32_t)(ll->next_slot_us - now);
+        if (!any || d < best) best = d;
+        any = true;
+    }
+
+    *at = now + (uint32_t)best;
+    return any;
+}
+
+/*
+ * Проход будильника развертки.
+ * Выполняет наступившие слоты всех активных экземпляров и взводит будильник
+ * на ближайший. Если он наступил, пока шел проход, проход повторяется без выхода из ISR.
+ */
+static void __not_in_flash_func(ll_scan_service)(void)
+{
+    for (;;) {
+        uint32_t now = time_us_32();
+
+        for (uint8_t i = 0; i < s_timer.count; i++) {
+            display_ll_t *ll = s_timer.list[i];
+            if (ll->suspended) continue;
+            if ((int32_t)(now - ll->next_slot_us) >= 0) ll_slot(ll);
+        }
+
+        uint32_t at;
+        // Все экземпляры приостановлены (или отключены): будильник не взводится
+        if (!ll_next_slot(time_us_32(), &at)) break;
+        if (ll_hw_arm(&s_timer.scan, at)) break;
+    }
+}
+
+/* Вход в ISR развертки: статистика задержки и проход. */
+static void __not_in_flash_func(ll_scan_irq_body)(void)
+{
+    uint32_t t0 = time_us_32();
+
+    // Повторное срабатывание без взведенного будильника (перевзвод из API) не измеряется
+    if (s_timer.scan.armed) {
+        uint32_t latency = t0 - s_timer.scan.target_us;
+        if ((int32_t)latency < 0) latency = 0;
+        if (latency > s_timer.latency_max_us) s_timer.latency_max_us = latency;
+        s_timer.latency_sum_us += latency;
+        s_timer.irq_count++;
+        s_timer.scan.armed = false;
+    }
+
+    ll_scan_service();
+
+    uint32_t dt = time_us_32() - t0;
+    if (dt > s_timer.isr_max_us) s_timer.isr_max_us = dt;
+}
+
+#if !PICO_NO_HARDWARE
+static void __not_in_flash_func(ll_scan_irq)(void)
+{
+    timer_hw->intr = 1u << s_timer.scan.num;
+    ll_scan_irq_body();
+}
+
+static void __not_in_flash_func(ll_edge_irq)(void)
+{
+    timer_hw->intr = 1u << s_timer.edge.num;
+    s_timer.edge.armed = false;
+    ll_edge_service();
+}
+#else
+static void ll_scan_irq(uint alarm_num)
+{
+    (void)alarm_num;
+    ll_scan_irq_body();
+}
+
+static void ll_edge_irq(uint alarm_num)
+{
+    (void)alarm_num;
+    s_timer.edge.armed = false;
+    ll_edge_service();
+}
+#endif
+
+#if !PICO_NO_HARDWARE
+typedef irq_handler_t ll_alarm_handler_t;
+#else
+typedef hardware_alarm_callback_t ll_alarm_handler_t;
+#endif
+
+/* Захват будильника и установка обработчика. */
+static bool ll_alarm_claim(ll_alarm_t *a, ll_alarm_handler_t handler)
+{
+    if (a->num >= 0) return true;
+
+    int alarm = a->cfg;
+    if (alarm >= 0) {
+        if (hardware_alarm_is_claimed((uint)alarm)) return false;
+        hardware_alarm_claim((uint)alarm);
+    } else {
+        alarm = hardware_alarm_claim_unused(false);
+        if (alarm < 0) return false;
+    }
+    a->num   = (int8_t)alarm;
+    a->armed = false;
+
+#if !PICO_NO_HARDWARE
+    uint irq_num = TIMER_ALARM_IRQ_NUM(timer_hw, alarm);
+    timer_hw->armed = 1u << alarm;
+    timer_hw->intr  = 1u << alarm;
+    irq_set_exclusive_handler(irq_num, handler);
+    irq_set_priority(irq_num, a->priority);
+    hw_set_bits(&timer_hw->inte, 1u << alarm);
+    irq_set_enabled(irq_num, true);
+#else
+    hardware_alarm_set_callback((uint)alarm, handler);
+#endif
+    return true;
+}
+
+static void ll_alarm_release(ll_alarm_t *a, ll_alarm_handler_t handler)
+{
+    if (a->num < 0) return;
+    uint alarm = (uint)a->num;
+    ll_hw_disarm(a);
+
+#if !PICO_NO_HARDWARE
+    uint irq_num = TIMER_ALARM_IRQ_NUM(timer_hw, alarm);
+    irq_set_enabled(irq_num, false);
+    hw_clear_bits(&timer_hw->inte, 1u << alarm);
+    timer_hw->intr = 1u << alarm;
+    irq_remove_handler(irq_num, handler);
+#else
+    (void)handler;
+    hardware_alarm_set_callback(alarm, NULL);
+#endif
+
+    hardware_alarm_unclaim(alarm);
+    a->num = -1;
+}
+
+/*
+ * Захват будильников развертки и гашения.
+ * Выполняется один раз, при первом запуске развертки.
+ */
+static bool ll_timer_claim(void)
+{
+    if (!ll_alarm_claim(&s_timer.scan, ll_scan_irq)) return false;
+    if (!ll_alarm_claim(&s_timer.edge, ll_edge_irq)) {
+        ll_alarm_release(&s_timer.scan, ll_scan_irq);
+        return false;
+    }
+    return true;
+}
+
+/* Освобождение будильников (смена конфигурации таймера). */
+static void ll_timer_release(void)
+{
+    ll_alarm_release(&s_timer.edge, ll_edge_irq);
+    ll_alarm_release(&s_timer.scan, ll_scan_irq);
+}
+
+/*
+ * Перевзвод будильника развертки после изменения списка (прерывания отключены).
+ * Если ближайший слот уже наступил, проход выполняется сразу.
+ */
+static void ll_timer_kick(void)
+{
+    uint32_t at;
+    if (!ll_next_slot(time_us_32(), &at)) {
+        ll_hw_disarm(&s_timer.scan);
+        return;
+    }
+    // Взведенный раньше будильник сам пересчитает ближайший слот
+    if (s_timer.scan.armed && (int32_t)(at - s_timer.scan.target_us) >= 0) return;
+    if (!ll_hw_arm(&s_timer.scan, at)) ll_scan_service();
+}
 
+/* Подключение экземпляра к общему таймеру. */
+static bool ll_scan_attach(display_ll_t *ll)
+{
+    if (!ll_timer_claim()) return false;
+
+    uint32_t irq = save_and_disable_interrupts();
+    bool listed = false;
+    for (uint8_t i = 0; i < s_timer.count; i++) {
+        if (s_timer.list[i] == ll) listed = true;
+    }
+    if (!listed) {
+        if (s_timer.count >= DISPLAY_LL_MAX_INSTANCES) {
+            restore_interrupts(irq);
+            return false;
+        }
+        s_timer.list[s_timer.count++] = ll;
+    }
+    ll_timer_kick();
+    restore_interrupts(irq);
     return true;
 }
 
+/*
+ * Отключение экземпляра. Будильники останавливаются вместе с последним экземпляром;
+ * уже взведенные ради других экземпляров просто пересчитают ближайшее событие.
+ */
+static void ll_scan_detach(display_ll_t *ll)
+{
+    uint32_t irq = save_and_disable_interrupts();
+    for (uint8_t i = 0; i < s_timer.count; i++) {
+        if (s_timer.list[i] != ll) continue;
+        for (uint8_t j = i; j + 1u < s_timer.count; j++) s_timer.list[j] = s_timer.list[j + 1u];
+        s_timer.count--;
+        break;
+    }
+    ll->clear_pending = false;
+    if (s_timer.count == 0) {
+        ll_hw_disarm(&s_timer.scan);
+        ll_hw_disarm(&s_timer.edge);
+    }
+    restore_interrupts(irq);
+}
+
+// ============================================================================
+//  ЧАСТОТА ЯДРА
+// ============================================================================
+
+/* Задержка импульса в тактах для частоты hz (с округлением вверх, не меньше 1). */
+static uint32_t ll_shift_cycles_for(uint32_t hz)
+{
+    uint64_t cycles = ((uint64_t)hz * LL_SHIFT_PULSE_NS + 999999999u) / 1000000000u;
+    return cycles ? (uint32_t)cycles : 1u;
+}
+
+/*
+ * Перенастройка после смены clk_sys.
+ * Периоды слотов и PWM отсчитываются таймером от clk_ref и от clk_sys не зависят;
+ * от нее зависят задержка импульса и время вывода слота (нагрузка ISR).
+ */
+void display_ll_retime(void)
+{
+    uint32_t cycles = ll_shift_cycles_for(clock_get_hz(clk_sys));
+
+    uint32_t irq = save_and_disable_interrupts();
+    s_shift_cycles = cycles;
+
+    // Окно регулятора, начатое на старой частоте, не описывает новую нагрузку
+    uint32_t now = time_us_32();
+    for (uint8_t i = 0; i < s_timer.count; i++) {
+        display_ll_t *ll = s_timer.list[i];
+        ll->win_start_us = now;
+        ll->win_busy_us  = 0;
+        ll->win_missed   = 0;
+    }
+    restore_interrupts(irq);
+}
+
+bool display_ll_set_sys_clock_khz(uint32_t khz, bool required)
+{
+    uint32_t cur_khz = clock_get_hz(clk_sys) / 1000u;
+
+    // При повышении частоты импульс удлиняется заранее: на переходе он не короче нормы
+    if (khz > cur_khz) {
+        uint32_t cycles = ll_shift_cycles_for(khz * 1000u);
+        if (cycles > s_shift_cycles) s_shift_cycles = cycles;
+    }
+
+    bool ok = set_sys_clock_khz(khz, required);
+
+    // Фактическая частота (в том числе при отказе) определяет итоговую задержку
+    display_ll_retime();
+    return ok;
+}
+
 // ============================================================================
 //  ИНИЦИАЛИЗАЦИЯ И УПРАВЛЕНИЕ
 // ============================================================================
 
-bool display_ll_init(const display_ll_config_t *cfg)
+display_ll_t *display_ll_select(display_ll_t *ll)
+{
+    display_ll_t *prev = s_ll;
+    s_ll = ll ? ll : &s_ll_default;
+    return prev;
+}
+
+display_ll_t *display_ll_current(void) { return s_ll; }
+
+bool display_ll_init_ex(display_ll_t *ll, const display_ll_config_t *cfg)
 {
+    if (!ll) return false;
     if (!cfg) return false;
     if (cfg->digit_count == 0 || cfg->digit_count > VFD_MAX_DIGITS) return false;
     if (cfg->refresh_rate_hz < 50 || cfg->refresh_rate_hz > 2000) return false;
 
-    if (s_ll.initialized) display_ll_deinit();
+    // Границы регулятора: обе нулевые (выключен) или корректный диапазон вокруг базовой частоты
+    bool gov = (cfg->refresh_min_hz != 0 || cfg->refresh_max_hz != 0);
+    if (gov) {
+        if (cfg->refresh_min_hz < 50 || cfg->refresh_max_hz > 2000) return false;
+        if (cfg->refresh_min_hz > cfg->refresh_rate_hz) return false;
+        if (cfg->refresh_max_hz < cfg->refresh_rate_hz) return false;
+        if (cfg->governor_load_pct > 100) return false;
+    }
+
+    // Параллельные цепочки: разряды делятся между ними поровну
+    uint8_t chains = cfg->chain_count ? cfg->chain_count : 1;
+    if (chains > DISPLAY_LL_MAX_CHAINS) return false;
+    if (cfg->digit_count % chains != 0) return false;
+
+    // Раздельные линии: только одна цепочка, третья линия нужна лишь при > 8 разрядах
+    if (cfg->bus > DISPLAY_LL_BUS_SPLIT3) return false;
+    if (cfg->bus != DISPLAY_LL_BUS_SERIAL && chains > 1) return false;
+    if (cfg->bus == DISPLAY_LL_BUS_SPLIT3 && cfg->digit_count <= 8) return false;
+
+    if (ll->initialized) display_ll_deinit_ex(ll);
+
+    if (s_shift_cycles == 0) s_shift_cycles = ll_shift_cycles_for(clock_get_hz(clk_sys));
 
     gpio_init(cfg->data_pin);
     gpio_init(cfg->clock_pin);
@@ -233,131 +1045,433 @@ bool display_ll_init(const display_ll_config_t *cfg)
     gpio_put(cfg->clock_pin, 0);
     gpio_put(cfg->latch_pin, 0);
 
-    memset(&s_ll, 0, sizeof(s_ll));
+    uint8_t extra_pins[DISPLAY_LL_MAX_CHAINS];
+    uint8_t extra_count = 0;
+    for (uint8_t c = 1; c < chains; c++) extra_pins[extra_count++] = cfg->chain_data_pins[c - 1];
+    if (cfg->bus != DISPLAY_LL_BUS_SERIAL) extra_pins[extra_count++] = cfg->seg_data_pin;
+    if (cfg->bus == DISPLAY_LL_BUS_SPLIT3) extra_pins[extra_count++] = cfg->grid_hi_data_pin;
+
+    for (uint8_t i = 0; i < extra_count; i++) {
+        uint8_t pin = extra_pins[i];
+        gpio_init(pin);
+        gpio_set_dir(pin, GPIO_OUT);
+        gpio_set_slew_rate(pin, GPIO_SLEW_RATE_FAST);
+        gpio_put(pin, 0);
+    }
+
+    memset(ll, 0, sizeof(*ll));
 
     // SYNC: Удалена инициализация Spinlock (Issue #10)
 
-    s_ll.data_pin        = cfg->data_pin;
-    s_ll.clock_pin       = cfg->clock_pin;
-    s_ll.latch_pin       = cfg->latch_pin;
-    s_ll.digit_count     = cfg->digit_count;
-    s_ll.refresh_rate_hz = cfg->refresh_rate_hz;
-    s_ll.gamma_enabled   = true;
+    ll->data_pin        = cfg->data_pin;
+    ll->clock_pin       = cfg->clock_pin;
+    ll->latch_pin       = cfg->latch_pin;
+    ll->digit_count     = cfg->digit_count;
+    ll->scan_digits     = (uint8_t)(cfg->digit_count / chains);
+    ll->refresh_rate_hz = cfg->refresh_rate_hz;
+    ll->gamma_enabled   = true;
+
+    ll->gov_enabled  = gov;
+    ll->gov_min_hz   = cfg->refresh_min_hz;
+    ll->gov_max_hz   = cfg->refresh_max_hz;
+    ll->gov_load_pct = cfg->governor_load_pct ? cfg->governor_load_pct : LL_GOV_DEFAULT_LOAD_PCT;
+
+    ll->dark_suspend = cfg->dark_suspend;
+
+    // Линии DATA цепочек (цепочка 0 — data_pin)
+    ll->chain_count   = chains;
+    ll->chain_pins[0] = cfg->data_pin;
+    for (uint8_t c = 1; c < chains; c++) ll->chain_pins[c] = cfg->chain_data_pins[c - 1];
+    for (uint8_t c = 0; c < chains; c++) {
+        ll->chain_mask[c] = 1u << ll->chain_pins[c];
+        ll->data_mask |= ll->chain_mask[c];
+    }
+
+    ll->bus              = cfg->bus;
+    ll->seg_data_pin     = cfg->seg_data_pin;
+    ll->grid_hi_data_pin = cfg->grid_hi_data_pin;
+    if (ll->bus != DISPLAY_LL_BUS_SERIAL) {
+        ll->bus_mask = (1u << ll->data_pin) | (1u << ll->seg_data_pin);
+        if (ll->bus == DISPLAY_LL_BUS_SPLIT3) ll->bus_mask |= 1u << ll->grid_hi_data_pin;
+    }
 
-    // Определяем режим работы шины
-    s_ll.extended_grid_mode = (cfg->digit_count > 8);
+    // Определяем режим работы шины (по числу сеток в одной цепочке)
+    ll->extended_grid_mode = (ll->scan_digits > 8);
 
     for (int i = 0; i < VFD_MAX_DIGITS; i++) {
-        s_ll.seg_buffer[i] = 0;
-        s_ll.brightness[i] = 255;
+        ll->seg_buffer[i] = 0;
+        ll->brightness[i] = 255;
+        ll->pwm[i]        = 255;
     }
+    ll->power_scale = 256;
 
-    s_ll.clear_alarm = -1;
-    s_ll.initialized = true;
+    ll->initialized = true;
     return true;
 }
 
-bool display_ll_is_initialized(void) { return s_ll.initialized; }
+bool display_ll_init(const display_ll_config_t *cfg) { return display_ll_init_ex(s_ll, cfg); }
+
+bool display_ll_is_initialized_ex(const display_ll_t *ll) { return ll && ll->initialized; }
+bool display_ll_is_initialized(void) { return display_ll_is_initialized_ex(s_ll); }
+
+/* Подключение к общему таймеру с разряда 0 и сброс окна измерений. */
+static bool ll_timer_arm(display_ll_t *ll)
+{
+    ll_apply_pending_period(ll);
+
+    ll->current_digit = 0;
+
+    uint32_t now = time_us_32();
+    ll->win_start_us = now;
+    ll->win_busy_us  = 0;
+    ll->win_missed   = 0;
+    ll->next_slot_us = now + ll->slot_period_us;
 
-bool display_ll_start_refresh(void)
+    return ll_scan_attach(ll);
+}
+
+/*
+ * Выход из темной паузы. Вызывается из сеттеров буфера/яркости.
+ * Первый слот выполнится через один период, т.е. кадр появится в пределах слота.
+ */
+static void ll_resume_if_lit(display_ll_t *ll)
 {
-    if (!s_ll.initialized) return false;
-    if (s_ll.refresh_running) return true;
+    if (!ll->suspended || ll->lit_mask == 0) return;
+
+    uint32_t irq = save_and_disable_interrupts();
+    bool resume = ll->suspended && ll->refresh_running;
+    ll->suspended = false;
+    restore_interrupts(irq);
+
+    if (resume && !ll_timer_arm(ll)) ll->refresh_running = false;
+}
 
-    uint32_t slots_per_sec = (uint32_t)s_ll.refresh_rate_hz * s_ll.digit_count;
-    if (slots_per_sec == 0) return false;
+bool display_ll_start_refresh_ex(display_ll_t *ll)
+{
+    if (!ll || !ll->initialized) return false;
+    if (ll->refresh_running) return true;
 
-    int32_t period_us = -(int32_t)(1000000u / slots_per_sec);
-    if (period_us == 0) period_us = -100;
+    if (ll->scan_digits == 0) return false;
 
-    s_ll.slot_period_us = (uint32_t)(-period_us);
-    s_ll.current_digit  = 0;
-    s_ll.clear_alarm    = -1;
-    s_ll.refresh_running = true;
+    ll->slot_period_us = ll_slot_period_for(ll, ll->refresh_rate_hz);
+    ll->gov_pending_period_us = 0;
+    ll->clear_pending  = false;
+    ll->suspended      = false;
+    ll->refresh_running = true;
 
-    if (!add_repeating_timer_us(period_us, ll_fast_timer_cb, NULL, &s_ll.fast_timer)) {
-        s_ll.refresh_running = false;
+    if (!ll_timer_arm(ll)) {
+        ll->refresh_running = false;
         return false;
     }
     return true;
 }
 
-void display_ll_stop_refresh(void)
+bool display_ll_start_refresh(void) { return display_ll_start_refresh_ex(s_ll); }
+
+void display_ll_stop_refresh_ex(display_ll_t *ll)
 {
-    if (!s_ll.initialized || !s_ll.refresh_running) return;
-    
-    cancel_repeating_timer(&s_ll.fast_timer);
+    if (!ll || !ll->initialized || !ll->refresh_running) return;
     
-    if (s_ll.clear_alarm >= 0) {
-        cancel_alarm(s_ll.clear_alarm);
-        s_ll.clear_alarm = -1;
-    }
+    // После отключения ISR больше не обращается к экземпляру
+    ll_scan_detach(ll);
+    ll->suspended = false;
     
-    ll_shift_frame(0x0000, 0x00);
+    ll_blank(ll);
     
-    s_ll.refresh_running = false;
+    ll->refresh_running = false;
+}
+
+void display_ll_stop_refresh(void) { display_ll_stop_refresh_ex(s_ll); }
+
+uint16_t display_ll_get_refresh_rate_ex(const display_ll_t *ll) { return ll ? ll->refresh_rate_hz : 0; }
+uint16_t display_ll_get_refresh_rate(void) { return display_ll_get_refresh_rate_ex(s_ll); }
+
+bool display_ll_is_suspended_ex(const display_ll_t *ll) { return ll && ll->suspended; }
+bool display_ll_is_suspended(void) { return display_ll_is_suspended_ex(s_ll); }
+
+void display_ll_get_stats_ex(const display_ll_t *ll, display_ll_stats_t *out)
+{
+    if (!ll || !out) return;
+    out->refresh_rate_hz = ll->refresh_rate_hz;
+    out->isr_load_pct    = ll->isr_load_pct;
+    out->missed_slots    = ll->missed_slots;
+
+    uint32_t max_load = (uint32_t)ll->digit_count * 8u * 255u;
+    out->load_permille = max_load ? (uint16_t)(ll->total_load * 1000u / max_load) : 0;
+    out->throttle_permille = display_ll_get_power_throttle_ex(ll);
+
+    uint32_t irq = save_and_disable_interrupts();
+    out->edge_late_max_us = ll->edge_late_max_us;
+    out->edge_late_avg_us = ll->edge_count ? (uint32_t)(ll->edge_late_sum_us / ll->edge_count) : 0;
+    out->edges_dropped    = ll->edges_dropped;
+    out->first_frame_us   = ll->first_frame_us;
+    restore_interrupts(irq);
 }
 
-void display_ll_deinit(void)
+void display_ll_get_stats(display_ll_stats_t *out) { display_ll_get_stats_ex(s_ll, out); }
+
+void display_ll_deinit_ex(display_ll_t *ll)
 {
-    if (!s_ll.initialized) return;
-    display_ll_stop_refresh();
+    if (!ll || !ll->initialized) return;
+    display_ll_stop_refresh_ex(ll);
     
     // SYNC: Удалено освобождение spinlock
     
-    gpio_set_dir(s_ll.data_pin,  GPIO_IN);
-    gpio_set_dir(s_ll.clock_pin, GPIO_IN);
-    gpio_set_dir(s_ll.latch_pin, GPIO_IN);
+    gpio_set_dir(ll->data_pin,  GPIO_IN);
+    for (uint8_t c = 1; c < ll->chain_count; c++) gpio_set_dir(ll->chain_pins[c], GPIO_IN);
+    if (ll->bus != DISPLAY_LL_BUS_SERIAL) gpio_set_dir(ll->seg_data_pin, GPIO_IN);
+    if (ll->bus == DISPLAY_LL_BUS_SPLIT3) gpio_set_dir(ll->grid_hi_data_pin, GPIO_IN);
+    gpio_set_dir(ll->clock_pin, GPIO_IN);
+    gpio_set_dir(ll->latch_pin, GPIO_IN);
     
-    memset(&s_ll, 0, sizeof(s_ll));
-    s_ll.clear_alarm = -1;
+    memset(ll, 0, sizeof(*ll));
+}
+
+void display_ll_deinit(void) { display_ll_deinit_ex(s_ll); }
+
+// ============================================================================
+//  ТАЙМЕР РАЗВЕРТКИ
+// ============================================================================
+
+bool display_ll_set_timer_config(const display_ll_timer_config_t *cfg)
+{
+    if (!cfg) return false;
+    if (s_timer.count != 0) return false;
+
+    int8_t scan_cfg = (cfg->alarm_num < 0) ? DISPLAY_LL_ALARM_ANY : cfg->alarm_num;
+    int8_t edge_cfg = (cfg->edge_alarm_num < 0) ? DISPLAY_LL_ALARM_ANY : cfg->edge_alarm_num;
+    if (scan_cfg >= 4 || edge_cfg >= 4) return false;
+    if (scan_cfg >= 0 && scan_cfg == edge_cfg) return false;
+
+    uint8_t scan_prio = cfg->irq_priority;
+    if (scan_prio == DISPLAY_LL_IRQ_PRIORITY_DEFAULT) scan_prio = PICO_DEFAULT_IRQ_PRIORITY;
+    uint8_t edge_prio = cfg->edge_irq_priority;
+    if (edge_prio == DISPLAY_LL_IRQ_PRIORITY_DEFAULT) {
+        bool below = LL_NVIC_LEVEL(DISPLAY_LL_EDGE_IRQ_PRIORITY) < LL_NVIC_LEVEL(scan_prio);
+        edge_prio = below ? DISPLAY_LL_EDGE_IRQ_PRIORITY : 0;
+    }
+    // Гашение должно вытеснять проход слотов, иначе фронт PWM ждет чужих экземпляров
+    if (LL_NVIC_LEVEL(edge_prio) >= LL_NVIC_LEVEL(scan_prio)) return false;
+
+    // Новые будильники захватываются при следующем запуске развертки
+    if (scan_cfg != s_timer.scan.cfg || scan_prio != s_timer.scan.priority ||
+        edge_cfg != s_timer.edge.cfg || edge_prio != s_timer.edge.priority) {
+        ll_timer_release();
+    }
+    s_timer.scan.cfg      = scan_cfg;
+    s_timer.scan.priority = scan_prio;
+    s_timer.edge.cfg      = edge_cfg;
+    s_timer.edge.priority = edge_prio;
+    return true;
+}
+
+void display_ll_get_timer_stats(display_ll_timer_stats_t *out)
+{
+    if (!out) return;
+    uint32_t irq = save_and_disable_interrupts();
+    out->irq_count      = s_timer.irq_count;
+    out->latency_max_us = s_timer.latency_max_us;
+    out->latency_avg_us = s_timer.irq_count ? (uint32_t)(s_timer.latency_sum_us / s_timer.irq_count) : 0;
+    out->isr_max_us     = s_timer.isr_max_us;
+    restore_interrupts(irq);
+}
+
+void display_ll_reset_timer_stats(void)
+{
+    uint32_t irq = save_and_disable_interrupts();
+    s_timer.irq_count      = 0;
+    s_timer.latency_max_us = 0;
+    s_timer.latency_sum_us = 0;
+    s_timer.isr_max_us     = 0;
+    restore_interrupts(irq);
+}
+
+#if VFD_FLASH_SAFE && !PICO_NO_HARDWARE
+static bool     s_flash_safe;
+static uint32_t s_flash_irqs[(NUM_IRQS + 31u) / 32u];  // Прерывания, запрещенные на время режима
+#endif
+
+bool display_ll_flash_safe_enter(void)
+{
+#if VFD_FLASH_SAFE && !PICO_NO_HARDWARE
+    if (s_flash_safe) return false;
+
+    uint scan_irq = s_timer.scan.num >= 0 ? TIMER_ALARM_IRQ_NUM(timer_hw, s_timer.scan.num) : NUM_IRQS;
+    uint edge_irq = s_timer.edge.num >= 0 ? TIMER_ALARM_IRQ_NUM(timer_hw, s_timer.edge.num) : NUM_IRQS;
+
+    uint32_t irq = save_and_disable_interrupts();
+    memset(s_flash_irqs, 0, sizeof(s_flash_irqs));
+    for (uint n = 0; n < NUM_IRQS; n++) {
+        if (n == scan_irq || n == edge_irq || !irq_is_enabled(n)) continue;
+        irq_set_enabled(n, false);
+        s_flash_irqs[n / 32u] |= 1u << (n % 32u);
+    }
+    s_flash_safe = true;
+    restore_interrupts(irq);
+    return true;
+#else
+    // Без VFD_FLASH_SAFE деление в ISR может выполняться из flash
+    return false;
+#endif
+}
+
+void display_ll_flash_safe_exit(void)
+{
+#if VFD_FLASH_SAFE && !PICO_NO_HARDWARE
+    if (!s_flash_safe) return;
+
+    uint32_t irq = save_and_disable_interrupts();
+    for (uint n = 0; n < NUM_IRQS; n++) {
+        if (s_flash_irqs[n / 32u] & (1u << (n % 32u))) irq_set_enabled(n, true);
+    }
+    s_flash_safe = false;
+    restore_interrupts(irq);
+#endif
 }
 
 // ============================================================================
 //  API ДОСТУПА К БУФЕРАМ
 // ============================================================================
 
-uint8_t display_ll_get_digit_count(void) { return s_ll.digit_count; }
-vfd_segment_map_t *display_ll_get_buffer(void) { return s_ll.seg_buffer; }
+/*
+ * Общий путь записи сегментов (set_digit_raw, set_frame): буфер, маска светящихся
+ * разрядов и трассировка. Изменившийся кадр отмечается LL_FRAME, а момент публикации
+ * запоминается до первого слота, который его выведет (LL_VISIBLE).
+ */
+static void ll_store_segments(display_ll_t *ll, uint8_t first, const vfd_segment_map_t *segs, uint8_t count)
+{
+    bool changed = false;
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t idx = (uint8_t)(first + i);
+        changed |= ll->seg_buffer[idx] != segs[i];
+        ll->seg_buffer[idx] = segs[i];
+        ll_update_lit(ll, idx);
+    }
+    if (!changed) return;
+
+#if VFD_TRACE
+    if (!ll->trace_commit_us) {
+        uint32_t now = time_us_32();
+        ll->trace_commit_us = now ? now : 1;
+    }
+#endif
+    DISPLAY_TRACE(DISPLAY_TRACE_LL_FRAME, ll, display_trace_pack(ll->seg_buffer, ll->digit_count), ll->digit_count);
+}
+
+uint8_t display_ll_get_digit_count_ex(const display_ll_t *ll) { return ll ? ll->digit_count : 0; }
+uint8_t display_ll_get_digit_count(void) { return display_ll_get_digit_count_ex(s_ll); }
+
+const vfd_segment_map_t *display_ll_get_buffer_ex(const display_ll_t *ll) { return ll ? ll->seg_buffer : NULL; }
+const vfd_segment_map_t *display_ll_get_buffer(void) { return display_ll_get_buffer_ex(s_ll); }
 
-void display_ll_set_digit_raw(uint8_t idx, vfd_segment_map_t segments)
+void display_ll_set_digit_raw_ex(display_ll_t *ll, uint8_t idx, vfd_segment_map_t segments)
 {
-    if (!s_ll.initialized) return;
+    if (!ll || !ll->initialized) return;
 
     // FIX #4: Assert срабатывает только в Debug-сборке, помогая найти ошибку.
     // В Release-сборке assert вырезается компилятором.
-    assert(idx < s_ll.digit_count);
+    assert(idx < ll->digit_count);
 
     // Защита времени выполнения (Runtime Safety) для Release-сборки.
     // Если индекс неверен, мы просто игнорируем запись, чтобы не повредить память.
-    if (idx >= s_ll.digit_count) return;
+    if (idx >= ll->digit_count) return;
     
-    s_ll.seg_buffer[idx] = segments;
+    ll_store_segments(ll, idx, &segments, 1);
+    ll_power_update(ll, idx);
+    ll_resume_if_lit(ll);
+}
+
+void display_ll_set_digit_raw(uint8_t idx, vfd_segment_map_t segments) { display_ll_set_digit_raw_ex(s_ll, idx, segments); }
+
+void display_ll_set_frame_ex(display_ll_t *ll, const vfd_segment_map_t *segments, uint8_t count)
+{
+    if (!ll || !ll->initialized || !segments) return;
+    if (count > ll->digit_count) count = ll->digit_count;
+
+    ll_store_segments(ll, 0, segments, count);
+    ll_power_update_all(ll);
+    ll_resume_if_lit(ll);
 }
 
-void display_ll_set_brightness(uint8_t idx, uint8_t lvl)
+void display_ll_set_frame(const vfd_segment_map_t *segments, uint8_t count) { display_ll_set_frame_ex(s_ll, segments, count); }
+
+void display_ll_set_brightness_ex(display_ll_t *ll, uint8_t idx, uint8_t lvl)
 {
-    if (!s_ll.initialized) return;
+    if (!ll || !ll->initialized) return;
 
     // FIX #4: Отладочная проверка диапазона
-    assert(idx < s_ll.digit_count);
+    assert(idx < ll->digit_count);
 
     // Runtime защита
-    if (idx >= s_ll.digit_count) return;
+    if (idx >= ll->digit_count) return;
     
-    s_ll.brightness[idx] = lvl;
+    ll->brightness[idx] = lvl;
+    ll_update_lit(ll, idx);
+    ll_power_update(ll, idx);
+    ll_resume_if_lit(ll);
 }
 
-void display_ll_set_brightness_all(uint8_t lvl)
+void display_ll_set_brightness(uint8_t idx, uint8_t lvl) { display_ll_set_brightness_ex(s_ll, idx, lvl); }
+
+void display_ll_set_brightness_all_ex(display_ll_t *ll, uint8_t lvl)
 {
-    if (!s_ll.initialized) return;
+    if (!ll || !ll->initialized) return;
     
     // Здесь assert не нужен, так как мы итерируемся по внутреннему limit
     uint32_t irq = save_and_disable_interrupts();
-    for (int i = 0; i < s_ll.digit_count; i++)
-        s_ll.brightness[i] = lvl;
+    for (int i = 0; i < ll->digit_count; i++) {
+        ll->brightness[i] = lvl;
+        ll_update_lit(ll, (uint8_t)i);
+    }
+    ll_power_update_all(ll);
+    restore_interrupts(irq);
+    ll_resume_if_lit(ll);
+}
+
+void display_ll_set_brightness_all(uint8_t lvl) { display_ll_set_brightness_all_ex(s_ll, lvl); }
+
+void display_ll_set_power_budget_ex(display_ll_t *ll, uint16_t budget_permille, display_ll_power_mode_t mode)
+{
+    if (!ll || !ll->initialized) return;
+    if (budget_permille > 1000) budget_permille = 1000;
+
+    uint32_t max_load = (uint32_t)ll->digit_count * 8u * 255u;
+
+    uint32_t irq = save_and_disable_interrupts();
+    ll->power_budget      = budget_permille;
+    ll->power_mode        = mode;
+    ll->power_limit       = max_load * budget_permille / 1000u;
+    ll->power_digit_limit = ll->power_limit / ll->digit_count;
+    ll->power_scale       = 256;
+    ll_power_update_all(ll);
     restore_interrupts(irq);
 }
 
-void display_ll_enable_gamma(bool en) { s_ll.gamma_enabled = en; }
-uint8_t display_ll_apply_gamma(uint8_t x) { return s_ll.gamma_enabled ? ll_gamma_calc(x) : x; }
\ No newline at end of file
+void display_ll_set_power_budget(uint16_t budget_permille, display_ll_power_mode_t mode)
+{
+    display_ll_set_power_budget_ex(s_ll, budget_permille, mode);
+}
+
+uint16_t display_ll_get_power_throttle_ex(const display_ll_t *ll)
+{
+    if (!ll || ll->power_budget == 0 || ll->total_load == 0) return 0;
+
+    // Фактическая нагрузка по итоговому PWM против запрошенной
+    uint32_t effective = 0;
+    for (uint8_t i = 0; i < ll->digit_count; i++) {
+        effective += (uint32_t)__builtin_popcount(ll->seg_buffer[i]) * ll->pwm[i];
+    }
+    if (effective >= ll->total_load) return 0;
+    return (uint16_t)(1000u - effective * 1000u / ll->total_load);
+}
+
+uint16_t display_ll_get_power_throttle(void) { return display_ll_get_power_throttle_ex(s_ll); }
+
+void display_ll_enable_gamma_ex(display_ll_t *ll, bool en) { if (ll) ll->gamma_enabled = en; }
+void display_ll_enable_gamma(bool en) { display_ll_enable_gamma_ex(s_ll, en); }
+
+uint8_t display_ll_apply_gamma_ex(const display_ll_t *ll, uint8_t x) { return (ll && ll->gamma_enabled) ? ll_gamma_calc(x) : x; }
+uint8_t display_ll_apply_gamma(uint8_t x) { return display_ll_apply_gamma_ex(s_ll, x); }
+
+uint8_t display_ll_gamma_inverse_ex(const display_ll_t *ll, uint8_t y) { return (ll && ll->gamma_enabled) ? ll_gamma_inv_calc(y) : y; }
+uint8_t display_ll_gamma_inverse(uint8_t y) { return display_ll_gamma_inverse_ex(s_ll, y); }
\ No newline at end of file
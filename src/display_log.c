@@ -0,0 +1,188 @@
+#include "logging.h"
+
+#include "pico/stdlib.h"
+#include "pico/platform.h"
+#include "hardware/sync.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Отложенный журнал (VFD_LOG_DEFERRED).
+ *
+ * У каждого ядра свое кольцо: пишет только оно, читает только display_log_drain().
+ * Запись резервирует слот с запретом прерываний на несколько инструкций (вложенные
+ * ISR того же ядра), межъядерных блокировок нет. Заполненный слот помечается ready,
+ * поэтому вывод не читает запись, которую прерванный код еще не дописал.
+ */
+
+#ifndef VFD_LOG_RING_LEN
+#define VFD_LOG_RING_LEN   32u     // Записей на ядро (степень двойки)
+#endif
+
+#define LOG_CORES          2u
+
+#if (VFD_LOG_RING_LEN & (VFD_LOG_RING_LEN - 1u)) != 0
+#error "VFD_LOG_RING_LEN must be a power of two"
+#endif
+
+typedef struct {
+    uint32_t          t_us;
+    const char       *fmt;                    // Строка формата во flash — она же идентификатор записи
+    uint8_t           level;
+    uint8_t           argc;
+    volatile uint8_t  ready;
+    uintptr_t         args[VFD_LOG_MAX_ARGS];
+} log_record_t;
+
+typedef struct {
+    log_record_t      rec[VFD_LOG_RING_LEN];
+    volatile uint32_t head;                   // Следующий свободный (ядро-владелец)
+    volatile uint32_t tail;                   // Следующий к выводу (drain)
+    uint32_t          written;
+    uint32_t          dropped;
+    uint32_t          dropped_reported;       // Уже выведено сообщением о потере
+} log_ring_t;
+
+static log_ring_t s_rings[LOG_CORES];
+
+static const char *const s_level_tag[] = {
+    [VFD_LOG_LEVEL_NONE]  = "",
+    [VFD_LOG_LEVEL_ERROR] = COLOR_RED    "[ERROR] ",
+    [VFD_LOG_LEVEL_WARN]  = COLOR_YELLOW "[WARNING] ",
+    [VFD_LOG_LEVEL_INFO]  = COLOR_GREEN  "[INFO] ",
+    [VFD_LOG_LEVEL_DEBUG] = COLOR_CYAN   "[DEBUG] ",
+};
+
+// ============================================================================
+//  Запись
+// ============================================================================
+
+void display_log_write(uint8_t level, const char *fmt, uint8_t argc,
+                       uintptr_t a0, uintptr_t a1, uintptr_t a2, uintptr_t a3)
+{
+    log_ring_t *r = &s_rings[get_core_num() & (LOG_CORES - 1u)];
+
+    uint32_t irq = save_and_disable_interrupts();
+    uint32_t head = r->head;
+    if (head - r->tail >= VFD_LOG_RING_LEN) {
+        r->dropped++;
+        restore_interrupts(irq);
+        return;
+    }
+    // Время берется внутри резервирования: записи одного ядра идут в порядке времени
+    log_record_t *rec = &r->rec[head & (VFD_LOG_RING_LEN - 1u)];
+    rec->t_us = time_us_32();
+    r->head = head + 1u;
+    r->written++;
+    restore_interrupts(irq);
+
+    rec->fmt     = fmt;
+    rec->level   = level;
+    rec->argc    = argc;
+    rec->args[0] = a0;
+    rec->args[1] = a1;
+    rec->args[2] = a2;
+    rec->args[3] = a3;
+    __dmb();
+    rec->ready = 1;
+}
+
+// ============================================================================
+//  Вывод
+// ============================================================================
+
+/*
+ * Формат воспроизводится с аргументами uintptr_t: подходят только целые до размера
+ * указателя, указатели и строки. Плавающая точка и 64-битные целые прочитали бы
+ * из va_list не то, что было записано, поэтому такие форматы не выводятся.
+ */
+static bool log_fmt_supported(const char *fmt)
+{
+    for (const char *p = fmt; *p; p++) {
+        if (*p != '%') continue;
+        p++;
+        if (*p == '%') continue;
+        while (*p && strchr("-+ #0123456789.*", *p)) p++;   // Флаги, ширина, точность
+        if (*p == 'j' || *p == 'L' || *p == 'q') return false;
+        if (*p == 'l' && p[1] == 'l') return false;
+        while (*p && strchr("hlzt", *p)) p++;
+        if (!*p || strchr("fFeEgGaAn", *p)) return false;
+    }
+    return true;
+}
+
+static void log_print(const log_record_t *rec)
+{
+    uint8_t level = rec->level <= VFD_LOG_LEVEL_DEBUG ? rec->level : VFD_LOG_LEVEL_NONE;
+    printf("%s[%lu.%06lu] ", s_level_tag[level],
+           (unsigned long)(rec->t_us / 1000000u), (unsigned long)(rec->t_us % 1000000u));
+    if (log_fmt_supported(rec->fmt)) {
+        printf(rec->fmt, rec->args[0], rec->args[1], rec->args[2], rec->args[3]);
+    } else {
+        printf("unsupported log format: %s", rec->fmt);
+    }
+    printf(COLOR_RESET "\n");
+}
+
+/* Сообщение о потерянных записях (один раз на каждую новую порцию потерь). */
+static void log_report_dropped(log_ring_t *r, uint8_t core)
+{
+    uint32_t dropped = r->dropped;
+    if (dropped == r->dropped_reported) return;
+    printf("%score %u: %lu log records dropped" COLOR_RESET "\n", s_level_tag[VFD_LOG_LEVEL_WARN],
+           (unsigned)core, (unsigned long)(dropped - r->dropped_reported));
+    r->dropped_reported = dropped;
+}
+
+uint32_t display_log_drain(uint32_t max_records)
+{
+#if VFD_LOG_DEFERRED
+    uint32_t printed = 0;
+
+    for (uint8_t c = 0; c < LOG_CORES; c++) log_report_dropped(&s_rings[c], c);
+
+    while (max_records == 0 || printed < max_records) {
+        // Записи двух ядер выводятся в порядке времени
+        log_ring_t   *best = NULL;
+        log_record_t *best_rec = NULL;
+        for (uint8_t c = 0; c < LOG_CORES; c++) {
+            log_ring_t *r = &s_rings[c];
+            if (r->tail == r->head) continue;
+            log_record_t *rec = &r->rec[r->tail & (VFD_LOG_RING_LEN - 1u)];
+            if (!rec->ready) continue;
+            if (!best_rec || (int32_t)(rec->t_us - best_rec->t_us) < 0) {
+                best = r;
+                best_rec = rec;
+            }
+        }
+        if (!best) break;
+
+        __dmb();
+        log_print(best_rec);
+        best_rec->ready = 0;
+        __dmb();
+        best->tail = best->tail + 1u;
+        printed++;
+    }
+    return printed;
+#else
+    (void)max_records;
+    return 0;
+#endif
+}
+
+void display_log_get_stats(display_log_stats_t *out)
+{
+    if (!out) return;
+    out->written = 0;
+    out->dropped = 0;
+    out->pending = 0;
+    for (uint8_t c = 0; c < LOG_CORES; c++) {
+        const log_ring_t *r = &s_rings[c];
+        out->written += r->written;
+        out->dropped += r->dropped;
+        out->pending += (uint16_t)(r->head - r->tail);
+    }
+}
@@ -1,7 +1,10 @@
 #include "display_api.h"
 #include "display_ll.h"
-#include "display_font.h"
 #include "display_state.h"
+#include "display_anim.h"
+#include "display_overlay.h"
+#include "logging.h"
+#include "display_trace.h"
 
 #include "pico/stdlib.h"
 #include <stdbool.h>
@@ -17,12 +20,79 @@
  * - Состояние хранится в g_display.
  * - Используются безопасные методы LL (set_digit_raw).
  * - Логика snapshot/restore реализована через saved_buffer в g_display.
+ * - Анимации описаны данными (display_anim.h) и проигрываются одним плеером.
+ * - Реестр с приоритетами: вытеснение в стек и очередь ожидания (display_overlay.h).
  * 
  * 
  * 
  *  FIX #19: Корректное завершение FX перед запуском Overlay.
  */
 
+// ============================================================================
+//  Встроенные анимации (flash)
+// ============================================================================
+
+/* BOOT: проход цифр 0..9 на всех разрядах */
+static const uint8_t s_anim_boot_data[] = {
+    ANIM_FILL(0x7B), ANIM_SHOW_DEFAULT(), // 0
+    ANIM_FILL(0x03), ANIM_SHOW_DEFAULT(), // 1
+    ANIM_FILL(0x5E), ANIM_SHOW_DEFAULT(), // 2
+    ANIM_FILL(0x4F), ANIM_SHOW_DEFAULT(), // 3
+    ANIM_FILL(0x27), ANIM_SHOW_DEFAULT(), // 4
+    ANIM_FILL(0x6D), ANIM_SHOW_DEFAULT(), // 5
+    ANIM_FILL(0x7D), ANIM_SHOW_DEFAULT(), // 6
+    ANIM_FILL(0x43), ANIM_SHOW_DEFAULT(), // 7
+    ANIM_FILL(0x7F), ANIM_SHOW_DEFAULT(), // 8
+    ANIM_FILL(0x6F), ANIM_SHOW_DEFAULT(), // 9
+    ANIM_END()
+};
+
+/* WIFI: мигание "8888", 5 повторов */
+static const uint8_t s_anim_wifi_data[] = {
+    ANIM_FILL(0x7F), ANIM_SHOW_DEFAULT(),
+    ANIM_CLEAR(),    ANIM_SHOW_DEFAULT(),
+    ANIM_END()
+};
+
+/* NTP: бегущая восьмерка 0-1-2-3-2-1, 3 повтора. Кадры — дельты к предыдущему. */
+static const uint8_t s_anim_ntp_data[] = {
+    ANIM_CLEAR(), ANIM_SET(0, 0x7F),       ANIM_SHOW_DEFAULT(),
+    ANIM_SET(0, 0), ANIM_SET(1, 0x7F),     ANIM_SHOW_DEFAULT(),
+    ANIM_SET(1, 0), ANIM_SET(2, 0x7F),     ANIM_SHOW_DEFAULT(),
+    ANIM_SET(2, 0), ANIM_SET(3, 0x7F),     ANIM_SHOW_DEFAULT(),
+    ANIM_SET(3, 0), ANIM_SET(2, 0x7F),     ANIM_SHOW_DEFAULT(),
+    ANIM_SET(2, 0), ANIM_SET(1, 0x7F),     ANIM_SHOW_DEFAULT(),
+    ANIM_END()
+};
+
+static const display_anim_t s_anim_boot = { s_anim_boot_data, sizeof(s_anim_boot_data), 1 };
+static const display_anim_t s_anim_wifi = { s_anim_wifi_data, sizeof(s_anim_wifi_data), 5 };
+static const display_anim_t s_anim_ntp  = { s_anim_ntp_data,  sizeof(s_anim_ntp_data),  3 };
+
+// ============================================================================
+//  Реестр
+// ============================================================================
+
+static const display_overlay_def_t s_ov_builtin[OV_BUILTIN_COUNT] = {
+    [OV_BOOT] = { "boot", DISPLAY_OVERLAY_PRIO_BOOT,   &s_anim_boot, 150 },
+    [OV_WIFI] = { "wifi", DISPLAY_OVERLAY_PRIO_STATUS, &s_anim_wifi, 200 },
+    [OV_NTP]  = { "ntp",  DISPLAY_OVERLAY_PRIO_STATUS, &s_anim_ntp,  150 },
+};
+
+static const display_overlay_def_t *s_ov_user[DISPLAY_OVERLAY_MAX_USER];
+static uint8_t s_ov_user_count = 0;
+
+/* Описание оверлея по типу: O(1), NULL для OV_NONE/OV_ANIM и незарегистрированных. */
+static const display_overlay_def_t *ov_def(overlay_type_t type)
+{
+    if ((unsigned)type < OV_BUILTIN_COUNT) {
+        const display_overlay_def_t *def = &s_ov_builtin[type];
+        return def->anim ? def : NULL;
+    }
+    unsigned user = (unsigned)type - OV_USER_FIRST;
+    return (user < s_ov_user_count) ? s_ov_user[user] : NULL;
+}
+
 // ============================================================================
 //  Вспомогательные функции
 // ============================================================================
@@ -36,7 +106,7 @@ static void ov_save_snapshot(void)
     // чтобы не потерять исходный контент.
     if (g_display->saved_valid) return;
 
-    vfd_segment_map_t *ll_buf = display_ll_get_buffer(); // Только чтение
+    const vfd_segment_map_t *ll_buf = display_ll_get_buffer();
     uint8_t digits = g_display->digit_count;
 
     for (uint8_t i = 0; i < digits; i++) {
@@ -56,24 +126,163 @@ static void ov_restore_snapshot(void)
     for (uint8_t i = 0; i < digits; i++) {
         display_ll_set_digit_raw(i, g_display->saved_content_buffer[i]);
     }
+    DISPLAY_TRACE(DISPLAY_TRACE_RESTORE, &g_display->ll,
+                  display_trace_pack(g_display->saved_content_buffer, digits), 1);
     g_display->saved_valid = false;
 }
 
-/* Завершение работы оверлея */
+/* Анимация могла менять яркость: возвращаем уровень ядра */
+static void ov_restore_brightness(void)
+{
+    if (!g_display->ov_player.bright_set) return;
+    for (uint8_t i = 0; i < g_display->digit_count; i++) {
+        display_ll_set_brightness(i, g_display->final_brightness[i]);
+    }
+}
+
+/* Запуск оверлея из запроса (экран уже под оверлеем или только что сохранен). */
+static void ov_begin(const overlay_request_t *req)
+{
+    // FIX #19: Если активен эффект, корректно завершаем его.
+    // Это восстановит "чистый" контент в буфер дисплея и вызовет колбэки FX.
+    if (g_display->fx_active) {
+        DISPLAY_TRACE(DISPLAY_TRACE_FX_PREEMPT, &g_display->ll, g_display->fx_type, req->type);
+        display_fx_stop();
+    }
+
+    // Теперь, когда FX завершен, делаем снимок чистого экрана (один на всю цепочку оверлеев)
+    ov_save_snapshot();
+
+    g_display->ov_type      = req->type;
+    g_display->ov_priority  = req->priority;
+    g_display->ov_active    = true;
+    g_display->ov_step      = 0;
+    g_display->ov_loop      = 0;
+    g_display->ov_frame_ms  = req->frame_ms;
+    g_display->ov_start_time = get_absolute_time();
+    g_display->ov_next_us   = to_us_since_boot(g_display->ov_start_time); // Первый кадр — сразу
+    display_anim_begin(&g_display->ov_player, req->anim);
+
+    display_overlay_stats_t *st = &g_display->ov_stats;
+    st->type           = req->type;
+    st->requested_ms   = display_anim_duration_ms(req->anim, req->frame_ms);
+    st->actual_ms      = 0;
+    st->suspended_ms   = 0;
+    st->frames_shown   = 0;
+    st->frames_dropped = 0;
+    st->max_late_us    = 0;
+}
+
+/* Вытеснение активного оверлея в стек. */
+static bool ov_push_active(void)
+{
+    if (g_display->ov_stack_len >= DISPLAY_OVERLAY_STACK_DEPTH) return false;
+
+    overlay_suspended_t *s = &g_display->ov_stack[g_display->ov_stack_len++];
+    s->req.type     = g_display->ov_type;
+    s->req.priority = g_display->ov_priority;
+    s->req.anim     = g_display->ov_player.anim;
+    s->req.frame_ms = g_display->ov_frame_ms;
+    s->start_time   = g_display->ov_start_time;
+    s->suspended_at = get_absolute_time();
+    s->stats        = g_display->ov_stats;
+    s->player       = g_display->ov_player;
+
+    uint64_t now_us = to_us_since_boot(get_absolute_time());
+    s->until_next_us = (g_display->ov_next_us > now_us) ? (uint32_t)(g_display->ov_next_us - now_us) : 0;
+
+    ov_restore_brightness();
+    return true;
+}
+
+/* Продолжение вытесненного оверлея с того же кадра. */
+static void ov_resume_top(void)
+{
+    overlay_suspended_t *s = &g_display->ov_stack[--g_display->ov_stack_len];
+    DISPLAY_TRACE(DISPLAY_TRACE_OV_RESUME, &g_display->ll, s->req.type, s->req.priority);
+    ov_begin(&s->req);
+    absolute_time_t now = get_absolute_time();
+    uint64_t suspended_us = to_us_since_boot(now) - to_us_since_boot(s->suspended_at);
+
+    g_display->ov_player = s->player;
+    g_display->ov_stats = s->stats;
+    // Расписание и начало отсчета сдвигаются на время вытеснения: кадр дослуживает
+    // остаток, а actual_ms не включает время, пока оверлей не показывался
+    g_display->ov_start_time = from_us_since_boot(to_us_since_boot(s->start_time) + suspended_us);
+    g_display->ov_stats.suspended_ms += (uint32_t)(suspended_us / 1000u);
+    g_display->ov_next_us = to_us_since_boot(now) + s->until_next_us;
+
+    // Кадр, на котором оверлей был прерван, выводится сразу
+    display_ll_set_frame(g_display->ov_player.frame, g_display->digit_count);
+    if (g_display->ov_player.bright_set) {
+        display_ll_set_brightness_all(display_ll_apply_gamma(g_display->ov_player.brightness));
+    }
+}
+
+/* Индекс ожидающего запроса с наибольшим приоритетом (FIFO при равенстве), -1 если пусто. */
+static int ov_queue_best(void)
+{
+    int best = -1;
+    for (uint8_t i = 0; i < g_display->ov_queue_len; i++) {
+        if (best < 0 || g_display->ov_queue[i].priority > g_display->ov_queue[best].priority) best = i;
+    }
+    return best;
+}
+
+static overlay_request_t ov_queue_take(int idx)
+{
+    overlay_request_t req = g_display->ov_queue[idx];
+    for (uint8_t i = (uint8_t)idx; i + 1u < g_display->ov_queue_len; i++) {
+        g_display->ov_queue[i] = g_display->ov_queue[i + 1u];
+    }
+    g_display->ov_queue_len--;
+    return req;
+}
+
+/*
+ * Переход к следующему оверлею: вытесненный или ожидающий с большим приоритетом.
+ * Если ничего не осталось — восстановление экрана.
+ */
+static void ov_advance(void)
+{
+    int best = ov_queue_best();
+    bool has_stack = g_display->ov_stack_len > 0;
+
+    if (has_stack && (best < 0 ||
+        g_display->ov_stack[g_display->ov_stack_len - 1u].req.priority >= g_display->ov_queue[best].priority)) {
+        ov_resume_top();
+        return;
+    }
+    if (best >= 0) {
+        overlay_request_t req = ov_queue_take(best);
+        DISPLAY_TRACE(DISPLAY_TRACE_OV_START, &g_display->ll, req.type, req.priority);
+        ov_begin(&req);
+        return;
+    }
+    ov_restore_snapshot();
+}
+
 /* 
  * Завершение работы оверлея.
  * FIX #20: Сохраняем тип оверлея перед сбросом, чтобы передать его в колбэк.
  */
 static void ov_finish(void)
 {
-    ov_restore_snapshot();
+    ov_restore_brightness();
+
+    // Отчет: фактическая длительность против запрошенной
+    g_display->ov_stats.actual_ms =
+        (uint32_t)(absolute_time_diff_us(g_display->ov_start_time, get_absolute_time()) / 1000);
+    g_display->ov_last_stats = g_display->ov_stats;
 
     // 1. Сохраняем тип перед очисткой
     overlay_type_t finished_type = g_display->ov_type;
+    DISPLAY_TRACE(DISPLAY_TRACE_OV_FINISH, &g_display->ll, finished_type, g_display->ov_stats.actual_ms);
 
-    // 2. Сбрасываем состояние
+    // 2. Сбрасываем состояние и переходим к следующему (или к контенту)
     g_display->ov_active = false;
     g_display->ov_type   = OV_NONE;
+    ov_advance();
     
     // 3. Вызываем колбэк с реальным типом
     if (g_display->on_overlay_finished) {
@@ -81,42 +290,33 @@ static void ov_finish(void)
     }
 }
 
-// ============================================================================
-//  Публичный API
-// ============================================================================
-
-bool display_is_overlay_running(void)
-{
-    return g_display->ov_active;
-}
-
-void display_overlay_stop(void)
-{
-    if (!g_display->ov_active) return;
-    ov_finish();
-}
-
-static bool overlay_start_common(overlay_type_t type, uint32_t frame_ms)
+/*
+ * Прием запроса: запуск, вытеснение или очередь.
+ */
+static bool ov_request(const overlay_request_t *req)
 {
     if (!g_display->initialized) return false;
-    if (g_display->ov_active) return false;
 
-    // FIX #19: Если активен эффект, корректно завершаем его.
-    // Это восстановит "чистый" контент в буфер дисплея и вызовет колбэки FX.
-    if (g_display->fx_active) {
-        display_fx_stop();
+    if (!g_display->ov_active) {
+        DISPLAY_TRACE(DISPLAY_TRACE_OV_START, &g_display->ll, req->type, req->priority);
+        ov_begin(req);
+        return true;
     }
 
-    // Теперь, когда FX завершен, делаем снимок чистого экрана
-    ov_save_snapshot();
-
-    g_display->ov_type      = type;
-    g_display->ov_active    = true;
-    g_display->ov_step      = 0;
-    g_display->ov_loop      = 0;
-    g_display->ov_frame_ms  = frame_ms;
-    g_display->ov_start_time = get_absolute_time();
+    if (req->priority > g_display->ov_priority && ov_push_active()) {
+        DISPLAY_TRACE(DISPLAY_TRACE_OV_SUSPEND, &g_display->ll, g_display->ov_type, req->type);
+        DISPLAY_TRACE(DISPLAY_TRACE_OV_START, &g_display->ll, req->type, req->priority);
+        ov_begin(req);
+        return true;
+    }
 
+    if (g_display->ov_queue_len >= DISPLAY_OVERLAY_QUEUE_LEN) {
+        DISPLAY_TRACE(DISPLAY_TRACE_OV_DROPPED, &g_display->ll, req->type, req->priority);
+        LOG_WARN("overlay: queue full, request %d dropped", (int)req->type);
+        return false;
+    }
+    DISPLAY_TRACE(DISPLAY_TRACE_OV_QUEUED, &g_display->ll, req->type, req->priority);
+    g_display->ov_queue[g_display->ov_queue_len++] = *req;
     return true;
 }
 
@@ -133,125 +333,189 @@ static inline uint32_t calc_frame_ms(uint32_t duration, uint32_t steps, uint32_t
     return (frame < 20) ? 20 : frame; // Ограничение мин. скорости (20ms)
 }
 
+/* Период кадра по общей длительности: steps = кадров за проход * повторы. */
+static uint32_t overlay_anim_frame_ms(const display_anim_t *anim, uint32_t duration_ms, uint32_t def)
+{
+    uint32_t loops = anim->loops ? anim->loops : 1u;
+    uint32_t steps = (uint32_t)display_anim_frame_count(anim) * loops;
+    if (steps == 0) steps = 1;
+    return calc_frame_ms(duration_ms, steps, def);
+}
+
+// ============================================================================
+//  Публичный API
+// ============================================================================
 
-bool display_overlay_boot(uint32_t duration_ms)
+bool display_is_overlay_running_ex(const display_t *disp)
 {
-    // BOOT: проход цифр 0..9 (10 шагов)
-    uint32_t frame = calc_frame_ms(duration_ms, 10, 150);
-    return overlay_start_common(OV_BOOT, frame);
+    return disp && disp->ov_active;
 }
 
-bool display_overlay_wifi(uint32_t duration_ms)
+bool display_is_overlay_running(void)
 {
-    // WIFI: 5 миганий (ON/OFF), итого 10 шагов
-    uint32_t frame = calc_frame_ms(duration_ms, 10, 200);
-    return overlay_start_common(OV_WIFI, frame);
+    return display_is_overlay_running_ex(g_display);
 }
 
-bool display_overlay_ntp(uint32_t duration_ms)
+void display_overlay_stop_ex(display_t *disp)
 {
-    // NTP: Змейка длиной 6 кадров, 3 повтора = 18 шагов
-    uint32_t frame = calc_frame_ms(duration_ms, 18, 150);
-    return overlay_start_common(OV_NTP, frame);
+    if (!disp || !disp->ov_active) return;
+    display_t *prev = display_core_enter(disp);
+    // Остановка отменяет и вытесненные, и ожидающие оверлеи
+    g_display->ov_stack_len = 0;
+    g_display->ov_queue_len = 0;
+    ov_finish();
+    display_core_leave(prev);
 }
 
-// ============================================================================
-//  Логика обновления (Tick)
-// ============================================================================
+void display_overlay_stop(void)
+{
+    display_overlay_stop_ex(g_display);
+}
 
-void display_overlay_tick(void)
+bool display_overlay_register(const display_overlay_def_t *def, overlay_type_t *out_type)
 {
-    if (!g_display->ov_active) return;
+    if (!def || !def->anim || !def->anim->data) return false;
+    if (s_ov_user_count >= DISPLAY_OVERLAY_MAX_USER) return false;
 
-    absolute_time_t now = get_absolute_time();
-    uint32_t now_ms  = to_ms_since_boot(now);
-    uint32_t last_ms = to_ms_since_boot(g_display->ov_start_time); // Здесь храним last_tick
+    s_ov_user[s_ov_user_count] = def;
+    if (out_type) *out_type = (overlay_type_t)(OV_USER_FIRST + s_ov_user_count);
+    s_ov_user_count++;
+    return true;
+}
 
-    if (now_ms - last_ms < g_display->ov_frame_ms) return;
+/* Запрос на экземпляре disp (display_core_enter). */
+static bool ov_request_on(display_t *disp, const overlay_request_t *req)
+{
+    if (!disp) return false;
+    display_t *prev = display_core_enter(disp);
+    bool ok = ov_request(req);
+    display_core_leave(prev);
+    return ok;
+}
 
-    // Обновляем метку времени
-    g_display->ov_start_time = now; 
+bool display_overlay_start_ex(display_t *disp, overlay_type_t type, uint32_t duration_ms)
+{
+    const display_overlay_def_t *def = ov_def(type);
+    if (!def) return false;
+
+    overlay_request_t req = {
+        .type     = type,
+        .priority = def->priority,
+        .anim     = def->anim,
+        .frame_ms = overlay_anim_frame_ms(def->anim, duration_ms, def->frame_ms ? def->frame_ms : 100u),
+    };
+    return ov_request_on(disp, &req);
+}
 
-    uint8_t digits = g_display->digit_count;
+bool display_overlay_start(overlay_type_t type, uint32_t duration_ms)
+{
+    return display_overlay_start_ex(g_display, type, duration_ms);
+}
 
-    switch (g_display->ov_type) {
+// BOOT: проход цифр 0..9 (10 шагов)
+bool display_overlay_boot_ex(display_t *disp, uint32_t duration_ms) { return display_overlay_start_ex(disp, OV_BOOT, duration_ms); }
+bool display_overlay_boot(uint32_t duration_ms) { return display_overlay_boot_ex(g_display, duration_ms); }
 
-    /* BOOT: Перебор цифр 0..9 на всех разрядах */
-    case OV_BOOT:
-    {
-        if (g_display->ov_step >= 10) {
-            ov_finish();
-            return;
-        }
+// WIFI: 5 миганий (ON/OFF), итого 10 шагов
+bool display_overlay_wifi_ex(display_t *disp, uint32_t duration_ms) { return display_overlay_start_ex(disp, OV_WIFI, duration_ms); }
+bool display_overlay_wifi(uint32_t duration_ms) { return display_overlay_wifi_ex(g_display, duration_ms); }
 
-        uint8_t d = (uint8_t)(g_display->ov_step % 10);
-        vfd_segment_map_t code = display_font_digit(d); // Используем безопасный геттер
+// NTP: Змейка длиной 6 кадров, 3 повтора = 18 шагов
+bool display_overlay_ntp_ex(display_t *disp, uint32_t duration_ms) { return display_overlay_start_ex(disp, OV_NTP, duration_ms); }
+bool display_overlay_ntp(uint32_t duration_ms) { return display_overlay_ntp_ex(g_display, duration_ms); }
 
-        for (uint8_t i = 0; i < digits; i++) {
-            display_ll_set_digit_raw(i, code);
-        }
+bool display_overlay_play_prio_ex(display_t *disp, const display_anim_t *anim, uint32_t frame_ms, uint8_t priority)
+{
+    if (!anim || !anim->data || anim->len == 0) return false;
+    overlay_request_t req = {
+        .type     = OV_ANIM,
+        .priority = priority,
+        .anim     = anim,
+        .frame_ms = frame_ms ? frame_ms : 100u,
+    };
+    return ov_request_on(disp, &req);
+}
 
-        g_display->ov_step++;
-        break;
-    }
+bool display_overlay_play_prio(const display_anim_t *anim, uint32_t frame_ms, uint8_t priority)
+{
+    return display_overlay_play_prio_ex(g_display, anim, frame_ms, priority);
+}
 
-    /* WIFI: Мигание "8888" */
-    case OV_WIFI:
-    {
-        if (g_display->ov_step >= 10) { // 5 миганий
-            ov_finish();
-            return;
-        }
+bool display_overlay_play_ex(display_t *disp, const display_anim_t *anim, uint32_t frame_ms)
+{
+    return display_overlay_play_prio_ex(disp, anim, frame_ms, DISPLAY_OVERLAY_PRIO_DEFAULT);
+}
 
-        bool on = ((g_display->ov_step & 1u) == 0);
-        vfd_segment_map_t code = on ? display_font_digit(8) : 0;
+bool display_overlay_play(const display_anim_t *anim, uint32_t frame_ms)
+{
+    return display_overlay_play_ex(g_display, anim, frame_ms);
+}
 
-        for (uint8_t i = 0; i < digits; i++) {
-            display_ll_set_digit_raw(i, code);
-        }
+bool display_overlay_get_last_stats_ex(const display_t *disp, display_overlay_stats_t *stats)
+{
+    if (!disp || !stats) return false;
+    *stats = disp->ov_last_stats;
+    return true;
+}
 
-        g_display->ov_step++;
-        break;
-    }
+bool display_overlay_get_last_stats(display_overlay_stats_t *stats)
+{
+    return display_overlay_get_last_stats_ex(g_display, stats);
+}
 
-    /* NTP: Бегущая восьмерка (Snake) */
-    case OV_NTP:
-    {
-        // Паттерн движения
-        static const uint8_t pattern[] = {0, 1, 2, 3, 2, 1};
-        const uint8_t PATTERN_LEN = 6; 
-        const uint8_t LOOPS = 3;
+uint8_t display_overlay_pending_ex(const display_t *disp)
+{
+    if (!disp) return 0;
+    return (uint8_t)(disp->ov_stack_len + disp->ov_queue_len);
+}
 
-        if (g_display->ov_loop >= LOOPS) {
-            ov_finish();
-            return;
-        }
+uint8_t display_overlay_pending(void)
+{
+    return display_overlay_pending_ex(g_display);
+}
 
-        if (g_display->ov_step >= PATTERN_LEN) {
-            g_display->ov_step = 0;
-            g_display->ov_loop++;
-            if (g_display->ov_loop >= LOOPS) {
-                ov_finish();
-                return;
-            }
-        }
+// ============================================================================
+//  Логика обновления (Tick)
+// ============================================================================
+
+/*
+ * Кадры показываются по абсолютным срокам: start + сумма длительностей предыдущих кадров.
+ * Опоздание одного тика не сдвигает следующие кадры. Если главный цикл отстал
+ * больше чем на кадр, просроченные кадры декодируются (дельты должны примениться),
+ * но в LL уходит только последний, а остальные учитываются как пропущенные.
+ */
+void display_overlay_tick(void)
+{
+    if (!g_display->ov_active) return;
+
+    uint64_t now_us = to_us_since_boot(get_absolute_time());
+    if (now_us < g_display->ov_next_us) return;
 
-        // Очищаем экран
-        for (uint8_t i = 0; i < digits; i++) display_ll_set_digit_raw(i, 0);
+    display_anim_player_t *p = &g_display->ov_player;
+    display_overlay_stats_t *st = &g_display->ov_stats;
+    uint64_t due_us = 0;
+    bool have_frame = false;
 
-        // Рисуем бегущий сегмент
-        uint8_t pos = pattern[g_display->ov_step];
-        if (pos < digits) {
-            display_ll_set_digit_raw(pos, display_font_digit(8));
+    while (now_us >= g_display->ov_next_us) {
+        uint32_t frame_ms = 0;
+        if (!display_anim_next_frame(p, &frame_ms)) {
+            if (have_frame) st->frames_dropped++;
+            ov_finish();
+            return;
         }
+        if (have_frame) st->frames_dropped++;
+        have_frame = true;
 
-        g_display->ov_step++;
-        break;
+        if (frame_ms == 0) frame_ms = g_display->ov_frame_ms ? g_display->ov_frame_ms : 1u;
+        due_us = g_display->ov_next_us;
+        g_display->ov_next_us += (uint64_t)frame_ms * 1000u;
     }
 
-    case OV_NONE:
-    default:
-        ov_finish();
-        break;
-    }
-}
\ No newline at end of file
+    display_ll_set_frame(p->frame, g_display->digit_count);
+    if (p->bright_set) display_ll_set_brightness_all(display_ll_apply_gamma(p->brightness));
+
+    uint32_t late_us = (uint32_t)(now_us - due_us);
+    if (late_us > st->max_late_us) st->max_late_us = late_us;
+    st->frames_shown++;
+    g_display->ov_step++;
+}
@@ -1,5 +1,6 @@
 #include "display_rng.h"
 #include "hardware/adc.h"
+#include "hardware/structs/rosc.h"
 #include "pico/stdlib.h"
 
 /*
@@ -8,7 +9,38 @@
  * Используется для создания недетерминированного поведения в визуальных эффектах.
  */
 
-static uint32_t g_rng_state = 0x12345678;
+#define RNG_FALLBACK_SEED  0xA5A5A5A5u
+#define RNG_ROSC_BITS      64u
+
+static uint32_t g_rng_seed = 0x12345678;
+static display_rng_stream_t g_rng_default = { 0x12345678 };
+
+// ============================================================================
+//  ВНУТРЕННИЕ ФУНКЦИИ
+// ============================================================================
+
+/* Шаг XORSHIFT32. */
+static inline uint32_t rng_step(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= (x << 13);
+    x ^= (x >> 17);
+    x ^= (x << 5);
+    *state = x;
+    return x;
+}
+
+/* Перемешивание (финализатор splitmix32) для вывода состояний потоков. */
+static inline uint32_t rng_mix(uint32_t z)
+{
+    z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+    z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+    return z ^ (z >> 16);
+}
+
+// ============================================================================
+//  ОБЩИЙ ГЕНЕРАТОР
+// ============================================================================
 
 /*
  * Генерация следующего 32-битного псевдослучайного числа.
@@ -16,12 +48,7 @@ static uint32_t g_rng_state = 0x12345678;
  */
 uint32_t display_rng_next(void)
 {
-    uint32_t x = g_rng_state;
-    x ^= (x << 13);
-    x ^= (x >> 17);
-    x ^= (x << 5);
-    g_rng_state = x;
-    return x;
+    return rng_step(&g_rng_default.state);
 }
 
 /*
@@ -30,8 +57,28 @@ uint32_t display_rng_next(void)
  */
 void display_rng_seed(uint32_t seed)
 {
-    if (seed == 0) seed = 0xA5A5A5A5u;
-    g_rng_state = seed;
+    if (seed == 0) seed = RNG_FALLBACK_SEED;
+    g_rng_seed = seed;
+    g_rng_default.state = seed;
+}
+
+/*
+ * Инициализация генератора аппаратной энтропией.
+ * ROSC выдает случайный бит при каждом чтении RANDOMBIT; бит сдвигается
+ * в аккумулятор с поворотом. Ожиданий (sleep) нет: ~64 чтения регистра.
+ */
+void display_rng_seed_from_hw(void)
+{
+#ifdef DISPLAY_RNG_FIXED_SEED
+    display_rng_seed((uint32_t)(DISPLAY_RNG_FIXED_SEED));
+#else
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < RNG_ROSC_BITS; i++) {
+        acc = (acc << 1 | acc >> 31) ^ (rosc_hw->randombit & 1u);
+    }
+    acc ^= (uint32_t)to_us_since_boot(get_absolute_time());
+    display_rng_seed(rng_mix(acc));
+#endif
 }
 
 /*
@@ -68,7 +115,63 @@ void display_rng_seed_from_adc(uint16_t adc_pin)
  * Получение случайного числа в заданном диапазоне [0 .. limit-1].
  */
 uint32_t display_rng_range(uint32_t limit)
+{
+    return display_rng_stream_range(&g_rng_default, limit);
+}
+
+// ============================================================================
+//  ПОТОКИ
+// ============================================================================
+
+void display_rng_stream_init(display_rng_stream_t *s, uint32_t stream_id)
+{
+    if (!s) return;
+    uint32_t state = rng_mix(g_rng_seed + (stream_id + 1u) * 0x9E3779B9u);
+    s->state = state ? state : RNG_FALLBACK_SEED;
+}
+
+uint32_t display_rng_stream_next(display_rng_stream_t *s)
+{
+    return rng_step(&s->state);
+}
+
+/*
+ * Метод Лемира: старшие 32 бита произведения x * limit равномерно покрывают
+ * [0 .. limit-1]. Смещение устраняется отбраковкой малой доли значений,
+ * порог (2^32 mod limit) вычисляется только когда младшая часть < limit.
+ */
+uint32_t display_rng_stream_range(display_rng_stream_t *s, uint32_t limit)
 {
     if (limit == 0) return 0;
-    return display_rng_next() % limit;
-}
\ No newline at end of file
+
+    uint64_t m = (uint64_t)rng_step(&s->state) * limit;
+    uint32_t low = (uint32_t)m;
+    if (low < limit) {
+        uint32_t threshold = (0u - limit) % limit;
+        while (low < threshold) {
+            m = (uint64_t)rng_step(&s->state) * limit;
+            low = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
+
+void display_rng_stream_fill(display_rng_stream_t *s, uint32_t *out, size_t count)
+{
+    if (!s || !out) return;
+    // Локальная копия состояния: в цикле без обращений к памяти потока
+    uint32_t x = s->state;
+    for (size_t i = 0; i < count; i++) out[i] = rng_step(&x);
+    s->state = x;
+}
+
+void display_rng_stream_shuffle(display_rng_stream_t *s, uint8_t *items, size_t count)
+{
+    if (!s || !items || count < 2) return;
+    for (size_t i = count - 1; i > 0; i--) {
+        uint32_t j = display_rng_stream_range(s, (uint32_t)(i + 1));
+        uint8_t t = items[i];
+        items[i] = items[j];
+        items[j] = t;
+    }
+}
@@ -0,0 +1,208 @@
+#include "display_trace.h"
+
+#include "pico/stdlib.h"
+#include "pico/platform.h"
+#include "hardware/sync.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Кольца трассировки.
+ *
+ * Каждое ядро пишет в свое кольцо с запретом прерываний на время записи
+ * (вложенные ISR), межъядерных блокировок нет. При переполнении вытесняется
+ * самое старое событие: в кольце всегда последние VFD_TRACE_RING_LEN событий.
+ * Чтение объединяет кольца по времени.
+ *
+ * Писатель меняет только head (и seq на время записи), читатель — только tail
+ * и счетчики: вытеснение читатель определяет сам по head - tail.
+ */
+
+#if VFD_TRACE
+
+#define TRACE_CORES  2u
+
+#if (VFD_TRACE_RING_LEN & (VFD_TRACE_RING_LEN - 1u)) != 0
+#error "VFD_TRACE_RING_LEN must be a power of two"
+#endif
+
+typedef struct {
+    display_trace_event_t ev[VFD_TRACE_RING_LEN];
+    volatile uint32_t     head;          // Записано всего (писатель)
+    volatile uint32_t     seq;           // Нечетный — идет запись (писатель)
+    volatile uint32_t     tail;          // Первое непрочитанное (читатель)
+    uint32_t              base;          // head на момент очистки (читатель)
+    uint32_t              overwritten;   // Вытеснено до чтения (читатель)
+} trace_ring_t;
+
+static trace_ring_t  s_rings[TRACE_CORES];
+static volatile bool s_enabled = true;
+
+void __not_in_flash_func(display_trace_record)(uint8_t event, uint32_t id, uint32_t a, uint32_t b)
+{
+    if (!s_enabled) return;
+
+    uint32_t core = get_core_num() & (TRACE_CORES - 1u);
+    trace_ring_t *r = &s_rings[core];
+
+    uint32_t irq = save_and_disable_interrupts();
+    uint32_t head = r->head;
+    r->seq = r->seq + 1u;
+    __dmb();
+    display_trace_event_t *e = &r->ev[head & (VFD_TRACE_RING_LEN - 1u)];
+    e->t_us  = time_us_32();
+    e->id    = id;
+    e->a     = a;
+    e->b     = b;
+    e->event = event;
+    e->core  = (uint8_t)core;
+    __dmb();
+    r->head = head + 1u;
+    r->seq = r->seq + 1u;
+    restore_interrupts(irq);
+}
+
+/* Пропуск событий, которые писатель уже перезаписал (только читатель). */
+static void trace_skip_lost(trace_ring_t *r)
+{
+    uint32_t unread = r->head - r->tail;
+    if (unread > VFD_TRACE_RING_LEN) {
+        r->overwritten += unread - VFD_TRACE_RING_LEN;
+        r->tail = r->tail + (unread - VFD_TRACE_RING_LEN);
+    }
+}
+
+void display_trace_enable(bool enable) { s_enabled = enable; }
+
+void display_trace_clear(void)
+{
+    bool was = s_enabled;
+    s_enabled = false;
+    for (uint8_t c = 0; c < TRACE_CORES; c++) {
+        uint32_t head = s_rings[c].head;
+        s_rings[c].tail = head;
+        s_rings[c].base = head;
+        s_rings[c].overwritten = 0;
+    }
+    s_enabled = was;
+}
+
+void display_trace_mark(uint32_t a, uint32_t b)
+{
+    display_trace_record(DISPLAY_TRACE_MARK, 0, a, b);
+}
+
+uint32_t display_trace_read(display_trace_event_t *out, uint32_t max)
+{
+    if (!out) return 0;
+
+    bool was = s_enabled;
+    s_enabled = false;
+    __dmb();
+
+    uint32_t n = 0;
+    while (n < max) {
+        trace_ring_t *best = NULL;
+        for (uint8_t c = 0; c < TRACE_CORES; c++) {
+            trace_ring_t *r = &s_rings[c];
+            trace_skip_lost(r);
+            if (r->tail == r->head) continue;
+            if (!best || (int32_t)(r->ev[r->tail & (VFD_TRACE_RING_LEN - 1u)].t_us -
+                                   best->ev[best->tail & (VFD_TRACE_RING_LEN - 1u)].t_us) < 0) {
+                best = r;
+            }
+        }
+        if (!best) break;
+
+        // Запись, начатая на другом ядре до остановки, могла задеть копируемую ячейку
+        uint32_t seq = best->seq;
+        __dmb();
+        display_trace_event_t e = best->ev[best->tail & (VFD_TRACE_RING_LEN - 1u)];
+        __dmb();
+        uint32_t unread = best->head - best->tail;
+        bool busy = (seq & 1u) || best->seq != seq;
+        if (unread > VFD_TRACE_RING_LEN || (busy && unread >= VFD_TRACE_RING_LEN)) continue;
+
+        out[n++] = e;
+        best->tail = best->tail + 1u;
+    }
+
+    s_enabled = was;
+    return n;
+}
+
+void display_trace_dump(void)
+{
+    display_trace_stats_t st;
+    display_trace_get_stats(&st);
+
+    uint32_t pending = 0;
+    for (uint8_t c = 0; c < TRACE_CORES; c++) {
+        uint32_t unread = s_rings[c].head - s_rings[c].tail;
+        pending += unread < VFD_TRACE_RING_LEN ? unread : VFD_TRACE_RING_LEN;
+    }
+
+    printf("# vfd-trace v1\n");
+    // Только события, накопленные до начала дампа
+    display_trace_event_t chunk[8];
+    while (pending) {
+        uint32_t want = pending < 8u ? pending : 8u;
+        uint32_t got = display_trace_read(chunk, want);
+        if (got == 0) break;
+        for (uint32_t i = 0; i < got; i++) {
+            const display_trace_event_t *e = &chunk[i];
+            printf("T %lu %u %08lx %u %lu %lu\n",
+                   (unsigned long)e->t_us, (unsigned)e->core, (unsigned long)e->id,
+                   (unsigned)e->event, (unsigned long)e->a, (unsigned long)e->b);
+        }
+        pending -= got;
+    }
+    printf("# end recorded %lu overwritten %lu\n", (unsigned long)st.recorded, (unsigned long)st.overwritten);
+}
+
+void display_trace_get_stats(display_trace_stats_t *out)
+{
+    if (!out) return;
+    out->recorded = 0;
+    out->overwritten = 0;
+    for (uint8_t c = 0; c < TRACE_CORES; c++) {
+        const trace_ring_t *r = &s_rings[c];
+        uint32_t head   = r->head;
+        uint32_t unread = head - r->tail;
+        out->recorded    += head - r->base;
+        out->overwritten += r->overwritten;
+        if (unread > VFD_TRACE_RING_LEN) out->overwritten += unread - VFD_TRACE_RING_LEN;
+    }
+}
+
+#else // !VFD_TRACE
+
+void display_trace_record(uint8_t event, uint32_t id, uint32_t a, uint32_t b)
+{
+    (void)event; (void)id; (void)a; (void)b;
+}
+
+void display_trace_enable(bool enable) { (void)enable; }
+
+void display_trace_clear(void) {}
+
+void display_trace_mark(uint32_t a, uint32_t b) { (void)a; (void)b; }
+
+uint32_t display_trace_read(display_trace_event_t *out, uint32_t max)
+{
+    (void)out; (void)max;
+    return 0;
+}
+
+void display_trace_dump(void) {}
+
+void display_trace_get_stats(display_trace_stats_t *out)
+{
+    if (!out) return;
+    out->recorded = 0;
+    out->overwritten = 0;
+}
+
+#endif // VFD_TRACE
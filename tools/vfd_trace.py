@@ -0,0 +1,197 @@
+#!/usr/bin/env python3
+"""
+Перевод дампа трассировки (display_trace_dump()) в JSON Trace Event Format
+для chrome://tracing и https://ui.perfetto.dev.
+
+Вход — лог последовательного порта целиком: строки, не относящиеся к дампу,
+пропускаются. Формат дампа:
+
+    # vfd-trace v1
+    T <t_us> <core> <id hex> <event> <a> <b>
+    # end recorded <n> overwritten <n>
+
+Каждый дисплей (id — адрес его display_ll_t) — отдельный процесс на шкале,
+дорожки: Mode, FX, Overlay, Content, LL; яркость — счетчик.
+Задержка публикации кадра до вывода — отрезок "frame latency" на дорожке LL.
+
+    python3 tools/vfd_trace.py serial.log -o trace.json
+"""
+
+import argparse
+import json
+import re
+import sys
+
+# Коды событий (display_trace_event_id_t)
+FX_START, FX_FINISH, FX_PREEMPT = 1, 2, 3
+OV_START, OV_FINISH, OV_SUSPEND, OV_RESUME, OV_QUEUED, OV_DROPPED = 4, 5, 6, 7, 8, 9
+MODE, BRIGHTNESS, CONTENT, RESTORE, LL_FRAME, LL_VISIBLE, MARK = 10, 11, 12, 13, 14, 15, 16
+
+FX_NAMES = [
+    "none", "fade_in", "fade_out", "pulse", "wave", "matrix", "heartbeat",
+    "glitch", "morph", "dissolve", "assemble", "slot_machine", "decode", "pingpong",
+    "marquee", "slide_in",
+]
+OV_NAMES = ["none", "boot", "wifi", "ntp", "anim"]
+MODE_NAMES = ["content", "effect", "overlay"]
+
+# Строка события; перед ней допускается префикс терминала
+RECORD = re.compile(r"(?:^|\s)T (\d+) (\d+) ([0-9a-fA-F]+) (\d+) (\d+) (\d+)\s*$")
+
+TRACK_MODE, TRACK_FX, TRACK_OV, TRACK_CONTENT, TRACK_LL = 1, 2, 3, 4, 5
+TRACK_NAMES = {
+    TRACK_MODE: "Mode", TRACK_FX: "FX", TRACK_OV: "Overlay",
+    TRACK_CONTENT: "Content", TRACK_LL: "LL",
+}
+
+
+def fx_name(t):
+    return FX_NAMES[t] if t < len(FX_NAMES) else "user_fx_%d" % (t - len(FX_NAMES))
+
+
+def ov_name(t):
+    return OV_NAMES[t] if t < len(OV_NAMES) else "user_ov_%d" % (t - len(OV_NAMES))
+
+
+def mode_name(m):
+    return MODE_NAMES[m] if m < len(MODE_NAMES) else "mode_%d" % m
+
+
+def segs(word, count=4):
+    n = min(count, 4) if count else 4
+    return " ".join("%02x" % ((word >> (8 * i)) & 0xFF) for i in range(n))
+
+
+def parse(lines):
+    """События дампа: (t_us, core, id, event, a, b); время разворачивается через 2^32."""
+    events = []
+    last = None
+    offset = 0
+    for line in lines:
+        m = RECORD.search(line)
+        if not m:
+            continue
+        t, core, inst, ev, a, b = (int(m.group(1)), int(m.group(2)), int(m.group(3), 16),
+                                   int(m.group(4)), int(m.group(5)), int(m.group(6)))
+        if last is not None and t + offset < last - (1 << 31):
+            offset += 1 << 32
+        last = t + offset
+        events.append((t + offset, core, inst, ev, a, b))
+    return events
+
+
+def convert(events):
+    out = []
+    pids = {}
+    open_fx = {}      # pid -> fx_type
+    open_ov = {}      # pid -> стек типов (вытесненные + активный)
+    open_mode = {}    # pid -> режим
+    last_ts = 0
+
+    def pid_of(inst):
+        if inst not in pids:
+            pid = len(pids) + 1
+            pids[inst] = pid
+            label = "app" if inst == 0 else "display %08x" % inst
+            out.append({"ph": "M", "name": "process_name", "pid": pid, "args": {"name": label}})
+            for tid, name in TRACK_NAMES.items():
+                out.append({"ph": "M", "name": "thread_name", "pid": pid, "tid": tid,
+                            "args": {"name": name}})
+        return pids[inst]
+
+    def ev(ph, pid, tid, ts, name, **kw):
+        e = {"ph": ph, "pid": pid, "tid": tid, "ts": ts, "name": name}
+        e.update(kw)
+        out.append(e)
+
+    for t, core, inst, code, a, b in events:
+        pid = pid_of(inst)
+        last_ts = t
+        args = {"core": core}
+
+        if code == FX_START:
+            open_fx[pid] = a
+            ev("B", pid, TRACK_FX, t, fx_name(a), args=dict(args, duration_ms=b))
+        elif code == FX_FINISH:
+            if pid in open_fx:
+                ev("E", pid, TRACK_FX, t, fx_name(a), args=dict(args, actual_ms=b))
+                del open_fx[pid]
+        elif code == FX_PREEMPT:
+            ev("i", pid, TRACK_FX, t, "preempted by " + ov_name(b), s="t", args=args)
+        elif code == OV_START:
+            open_ov.setdefault(pid, []).append(a)
+            ev("B", pid, TRACK_OV, t, ov_name(a), args=dict(args, priority=b))
+        elif code == OV_SUSPEND:
+            ev("E", pid, TRACK_OV, t, ov_name(a), args=dict(args, suspended_by=ov_name(b)))
+        elif code == OV_RESUME:
+            stack = open_ov.get(pid, [])
+            if stack and stack[-1] == a:
+                ev("B", pid, TRACK_OV, t, ov_name(a) + " (resumed)", args=args)
+        elif code == OV_FINISH:
+            stack = open_ov.get(pid, [])
+            if stack:
+                stack.pop()
+                ev("E", pid, TRACK_OV, t, ov_name(a), args=dict(args, actual_ms=b))
+        elif code == OV_QUEUED:
+            ev("i", pid, TRACK_OV, t, "queued " + ov_name(a), s="t", args=dict(args, priority=b))
+        elif code == OV_DROPPED:
+            ev("i", pid, TRACK_OV, t, "dropped " + ov_name(a), s="t", args=dict(args, priority=b))
+        elif code == MODE:
+            if pid in open_mode:
+                ev("E", pid, TRACK_MODE, t, mode_name(open_mode[pid]))
+            open_mode[pid] = b
+            ev("B", pid, TRACK_MODE, t, mode_name(b), args=dict(args, previous=mode_name(a)))
+        elif code == BRIGHTNESS:
+            ev("C", pid, TRACK_CONTENT, t, "brightness", args={"level": a})
+        elif code == CONTENT:
+            ev("i", pid, TRACK_CONTENT, t, "content", s="t", args=dict(args, segs=segs(a, b), digits=b))
+        elif code == RESTORE:
+            src = "overlay" if b else "fx"
+            ev("i", pid, TRACK_CONTENT, t, "restore after " + src, s="t", args=dict(args, segs=segs(a)))
+        elif code == LL_FRAME:
+            ev("i", pid, TRACK_LL, t, "frame", s="t", args=dict(args, segs=segs(a, b), digits=b))
+        elif code == LL_VISIBLE:
+            # Отрезок от публикации кадра до первого слота с ним
+            ev("X", pid, TRACK_LL, t - a, "frame latency", dur=a, args=dict(args, latency_us=a, digit=b))
+        elif code == MARK:
+            ev("i", pid, TRACK_CONTENT, t, "mark", s="g", args=dict(args, a=a, b=b))
+        else:
+            ev("i", pid, TRACK_CONTENT, t, "event %d" % code, s="t", args=dict(args, a=a, b=b))
+
+    # Незавершенные отрезки закрываются концом дампа
+    for pid, fx in open_fx.items():
+        ev("E", pid, TRACK_FX, last_ts, fx_name(fx))
+    for pid, stack in open_ov.items():
+        for ov in reversed(stack):
+            ev("E", pid, TRACK_OV, last_ts, ov_name(ov))
+    for pid, mode in open_mode.items():
+        ev("E", pid, TRACK_MODE, last_ts, mode_name(mode))
+
+    return {"traceEvents": out, "displayTimeUnit": "ms"}
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Convert a VFD display trace dump to Chrome/Perfetto JSON")
+    ap.add_argument("input", nargs="?", help="serial log with display_trace_dump() output (default: stdin)")
+    ap.add_argument("-o", "--output", help="output JSON file (default: stdout)")
+    opts = ap.parse_args()
+
+    if opts.input:
+        with open(opts.input, encoding="utf-8", errors="replace") as f:
+            events = parse(f)
+    else:
+        events = parse(sys.stdin)
+
+    trace = convert(events)
+    if opts.output:
+        with open(opts.output, "w", encoding="utf-8") as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+        sys.stdout.write("\n")
+    print("%d events" % len(events), file=sys.stderr)
+    return 0 if events else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())